@@ -7,10 +7,17 @@
 #include <TaskScheduler.h>
 #include <EEPROM.h>
 #include <Adafruit_NeoPixel.h>
+#include <PixelRing.h>
+#include <RingAnimation.h>
 #include <SoftwareSerial.h>
+#include <RingUart.h>
+#include <EspLink.h>
+#include <FixedString.h>
+#include <LoopHistogram.h>
 #include <avr/pgmspace.h>
 #include <avr/wdt.h>
 
+// badges that always open the door, generated with tools/genBuiltinBadges.py
 #define ENABLE_BUILTIN_BADGES
 
 #ifdef ENABLE_BUILTIN_BADGES
@@ -34,6 +41,9 @@
 #define DOORBELL_ALARM_PIN  9
 #define BUILTIN_LED       13
 #define ESP_RESET_PIN     12
+// ESP link is on the hardware UART, D0 (RX) / D1 (TX)
+#define DEBUG_RX_PIN      10  // unused, debug is transmit only
+#define DEBUG_TX_PIN      11
 
 #define DEBUG_CAPSENSE
 
@@ -52,6 +62,7 @@
 #define RFID_CONNECTION_TASK_INTERVAL   10000 // milliseconds
 #define LOOKFORCARD_TASK_INTERVAL       100   // milliseconds
 #define SYNC_CACHE_TASK_INTERVAL        600000 // milliseconds
+#define TELEMETRY_TASK_INTERVAL         600000 // milliseconds
 #define MONITORDOORSENSOR_TASK_INTERVAL 500   // milliseconds
 #define MONITOROUTPUT_TASK_INTERVAL     500   // milliseconds
 #define CARD_DEBOUNCE_DELAY             2000  // milliseconds
@@ -60,8 +71,15 @@
 #define CACHE_SYNC        240   // resync cache after <value> x 10 minutes
 
 #define OUTPUT_ENABLE_DURATION          10000 // milliseconds
+#define SPINNER_REVOLUTION              1200  // milliseconds
 
-#define MAXINPUTCHARS   20   // size of ESP serial incoming buffer
+#define ESP_REPLY_TIMEOUT               4000  // milliseconds
+#define DUMP_CACHE_DELAY                10000 // milliseconds after boot
+//#define DUMP_CACHE_ON_BOOT    // print every cached token once the door is up
+#define WDT_NEAR_MISS                   4000  // milliseconds, half of WDTO_8S
+#define ESP_BAUD          115200
+#define DEBUG_BAUD        115200  // a software serial byte blocks interrupts for one bit time x 10,
+                                  // keep it no longer than one ESP byte
 
 
 /* ========================================================================== *
@@ -101,6 +119,49 @@ struct TOKEN_CACHE_ITEM {
 };
 // in memory = 12 bytes, EEPROM size = 9 bytes
 
+// cache item as stored in EEPROM, from address 2 after the magic and size
+struct TOKEN_EEPROM_ITEM {
+    TOKEN token;
+    uint8_t length;
+    uint8_t flags;
+};
+
+// boot phases, millis() at the end of each is printed once the first card read is done
+#define BOOT_PN532      0
+#define BOOT_CACHE      1
+#define BOOT_LEDS       2
+#define BOOT_READY      3
+#define BOOT_FIRST_READ 4
+#define BOOT_PHASES     5
+
+/*
+  * a verify sent to the ESP, waiting for its reply
+  * seq - of the request frame, 0 = nothing pending
+  * token, length - the token being verified
+  * sent - millis() when sent, for the timeout
+  */
+struct PENDING_VERIFY {
+    uint8_t seq;
+    TOKEN token;
+    uint8_t length;
+    unsigned long sent;
+};
+
+
+
+// loop phases, for ESPLINK_LOOP_RECORD longestPhase
+#define LOOP_PHASE_TASKS      0   // scheduler, other than the tasks below
+#define LOOP_PHASE_SYNC       1   // syncCache task
+#define LOOP_PHASE_RFID       2   // keepRFIDConnected task, PN532 status and reset
+#define LOOP_PHASE_CARD       3   // lookForCard, PN532 read
+#define LOOP_PHASE_ANIMATION  4   // animation and strip.loop, show() blocks ~720us
+#define LOOP_PHASE_IO         5   // door sensor, outputs, doorbell, exit button
+#define LOOP_PHASE_SERIAL     6   // handleSerial and pending verify timeouts
+
+#if ESPLINK_LOOP_BUCKETS != LOOP_HISTOGRAM_BUCKETS
+#error ESPLINK_LOOP_RECORD and LoopHistogram disagree on bucket count
+#endif
+
 
 /* ========================================================================== *
  *  Prototypes for task callbacks, etc
@@ -112,14 +173,21 @@ void keepRFIDConnected();
 void lookForCard();
 void displayUptime();
 void syncCache();
+void sendTelemetry();
+void dumpCache();
 void monitorDoorSensor();
 void monitorOutput();
 void monitorExitButton();
 void animation();
 
 // other prototypes
-uint8_t queryServer();
-uint8_t handleSerial();
+void sendVerify(PENDING_VERIFY &verify, const uint8_t *token, uint8_t length);
+void checkPendingVerifies();
+void cardDecision(uint8_t flags);
+void syncDecision(uint8_t flags);
+void grantOrDeny(TOKEN_CACHE_ITEM* item);
+uint8_t sendEspFrame(uint8_t type, const uint8_t *payload, uint8_t length);
+void handleSerial();
 boolean isDoorUnlocked();
 
 void syncEEPROM();
@@ -131,10 +199,22 @@ void syncEEPROM();
 PN532_I2C pn532i2c(Wire, I2C_DATA_PIN, I2C_CLOCK_PIN);  // data, clock
 PN532 nfc(pn532i2c);
 uint16_t PN532Resets = 0;  // reset counter
-
-// ESP serial
-SoftwareSerial ESPSerial(10, 11);
+uint16_t espResets = 0;
+
+// ESP serial, framed with EspLink. RingUart when built with RINGUART_USART0 (see README),
+// otherwise Serial so that the sketch still builds from the Arduino IDE
+#ifdef RINGUART_USART0
+  #define EspSerial Uart
+#else
+  #define EspSerial Serial
+#endif
+EspLinkDecoder espLink;
+uint8_t espSeq = 0;           // seq of the last frame sent
+PENDING_VERIFY cardVerify;    // card not in the cache, waiting to unlock or deny
+PENDING_VERIFY syncVerify;    // cache entry being resynced
 unsigned long lastHB;
+uint8_t hbSeq = 0;            // heartbeat waiting for its reply, 0 = none
+unsigned long hbSent;
 
 // the cache
 TOKEN_CACHE_ITEM cache[CACHE_SIZE];
@@ -142,18 +222,16 @@ TOKEN_CACHE_ITEM cache[CACHE_SIZE];
 // number of items in cache
 uint8_t cacheSize = 0;
 
-// Serial handling
-//char inputString[20] = "";         // a string to hold incoming data
-uint8_t inputChars = 0;
-String inputString;
-boolean stringComplete = false;  // whether the string is complete
-
 // tasks
 Task ESPConnectionTask(ESP_CONNECTION_TASK_INTERVAL, TASK_FOREVER, &keepESPConnected);
 Task RFIDConnectionTask(RFID_CONNECTION_TASK_INTERVAL, TASK_FOREVER, &keepRFIDConnected);
 //Task lookForCardTask(LOOKFORCARD_TASK_INTERVAL, TASK_FOREVER, &lookForCard);
 Task displayUptimeTask(60000, TASK_FOREVER, &displayUptime);
 Task syncCacheTask(SYNC_CACHE_TASK_INTERVAL, TASK_FOREVER, &syncCache);
+Task telemetryTask(TELEMETRY_TASK_INTERVAL, TASK_FOREVER, &sendTelemetry);
+#ifdef DUMP_CACHE_ON_BOOT
+Task dumpCacheTask(0, TASK_ONCE, &dumpCache);
+#endif
 //Task monitorDoorSensorTask(MONITORDOORSENSOR_TASK_INTERVAL, TASK_FOREVER, &monitorDoorSensor);
 
 // scheduler
@@ -167,42 +245,51 @@ unsigned long outputEnableTimer;
 unsigned long unlockCount = 0;
 boolean exitPressed = false;
 
-// neopixel
-Adafruit_NeoPixel strip = Adafruit_NeoPixel(24, NEOPIXEL_PIN, NEO_GRB + NEO_KHZ800);
+// debug output
+SoftwareSerial Debug(DEBUG_RX_PIN, DEBUG_TX_PIN);
+
+// neopixel, only sends frames that have changed
+PixelRing strip = PixelRing(24, NEOPIXEL_PIN, NEO_GRB + NEO_KHZ800);
+RingAnimation ring(strip);
 
 // doorbell
 unsigned long doorbellTimer = 0;
 boolean doorbellOn = false;
 
 // token as hex string
-char tokenStr[14];
+char tokenStr[TOKEN_STR_SIZE];
+
+// uptime
+uint16_t millisRollovers = 0;
+
+// boot timing, see BOOT_ phases
+uint16_t bootTimes[BOOT_PHASES];
+boolean booted = false;
+
+// telemetry, reset each interval
+uint16_t cacheHits = 0;
+uint16_t cacheMisses = 0;
+uint32_t loopTotal = 0;  // us
+LoopHistogram loopHist;  // loop periods, count and max
+
+// loop phase timing, the phase that took longest in the slowest loop
+uint8_t loopPhase = LOOP_PHASE_TASKS;
+unsigned long phaseStart = 0;     // us
+uint8_t slowPhase = LOOP_PHASE_TASKS;    // slowest phase so far this loop
+unsigned long slowPhaseTime = 0;  // us
+uint8_t longestPhase = LOOP_PHASE_TASKS; // slowest phase of the slowest loop this interval
+
+// watchdog margin, per interval
+unsigned long lastWdtReset = 0;
+uint16_t wdtGapMax = 0;           // ms
+uint16_t wdtNearMisses = 0;
 
 /* ========================================================================== *
  *  Utility Functions
  * ========================================================================== */
 
-void updateTokenStr(const uint8_t *data, const uint32_t numBytes) {
-  const char * hex = "0123456789abcdef";
-  uint8_t b = 0;
-  for (uint8_t i = 0; i < numBytes; i++) {
-        tokenStr[b] = hex[(data[i]>>4)&0xF];
-        b++;
-        tokenStr[b] = hex[(data[i])&0xF];
-        b++;
-  }
-
-  // null remaining bytes in string
-  for (uint8_t i=numBytes; i < 7; i++) {
-        tokenStr[b] = 0;
-        b++;
-        tokenStr[b] = 0;
-        b++;
-  }
-}
-
-void uptime(Stream& serial, boolean display = true)
+void uptime(Print& serial, boolean display = true)
 {
-  static uint16_t rollover = 0;  // to count timer rollovers
   static boolean highMillis = false;
   long days=0;
   long hours=0;
@@ -215,14 +302,14 @@ void uptime(Stream& serial, boolean display = true)
     highMillis = true;
   }
   if (ms < 100000 && highMillis) {
-    rollover++;
+    millisRollovers++;
     highMillis = false;
   }
 
   secs = millis()/1000;
   mins=secs/60;
   hours=mins/60;
-  days=(rollover * 50) + hours/24;
+  days=(millisRollovers * 50) + hours/24;
   secs=secs-(mins*60); //subtract the coverted seconds to minutes in order to display 59 secs max
   mins=mins-(hours*60); //subtract the coverted minutes to hours in order to display 59 minutes max
   hours=hours-(days*24); //subtract the coverted hours to days in order to display 23 hours max
@@ -249,7 +336,7 @@ void uptime(Stream& serial, boolean display = true)
 }
 
 void displayUptime() {
-  uptime(Serial, true);
+  uptime(Debug, true);
 }
 
 
@@ -257,6 +344,32 @@ inline int clamp(int v, int minV, int maxV) {
   return min(maxV, max(v, minV));
 }
 
+// close the current loop phase and start the next
+void enterPhase(uint8_t phase) {
+  unsigned long now = micros();
+  if (now - phaseStart > slowPhaseTime) {
+    slowPhaseTime = now - phaseStart;
+    slowPhase = loopPhase;
+  }
+  loopPhase = phase;
+  phaseStart = now;
+}
+
+// reset the watchdog, noting how close it came
+void feedWatchdog() {
+  unsigned long gap = millis() - lastWdtReset;
+  lastWdtReset += gap;
+  if (gap > wdtGapMax) wdtGapMax = gap;
+  if (gap > WDT_NEAR_MISS) {
+    wdtNearMisses++;
+    Debug.print(F("WDT near miss: "));
+    Debug.print(gap);
+    Debug.print(F("ms in phase "));
+    Debug.println(loopPhase);
+  }
+  wdt_reset();
+}
+
 /* ========================================================================== *
  *  NEOPIXEL
  * ========================================================================== */
@@ -265,7 +378,8 @@ void colorWipe(uint32_t c, uint8_t wait) {
   for(uint16_t i=0; i<strip.numPixels(); i++) {
     strip.setPixelColor(i, c);
     if (wait >0 ) {
-      strip.show();
+      // deliberate wipe, so show every step
+      strip.showNow();
       delay(wait);
     }
   }
@@ -274,84 +388,82 @@ void colorWipe(uint32_t c, uint8_t wait) {
   }
 }
 
-void segment(uint32_t c1, uint32_t c2, int start, int end) {
-  // turn all LEDs off (c2)
-  for(uint16_t i=0; i<strip.numPixels(); i++) {
-     strip.setPixelColor(i,c2);
-  }
-  
-  // turn on the segment (c1)
-  for(int i=start; i<end+1; i++) {
-    int pix = i;
-    if (i < 0) i+=strip.numPixels();
-    strip.setPixelColor(i % strip.numPixels(), c1);
-  }
-  strip.show();
-}
+// keyframes: start, length, head, tail
 
-void spinner(uint32_t c, uint8_t from, uint8_t reduce) {
-  // stating at LED from, fades from c to black, by reduce each LED
-  uint32_t c1 = c;
-  int r;
-  for (uint8_t i=0; i<strip.numPixels(); i++) {
-    r = (23 - i);
-    c1 = strip.Color(
-      clamp(((c >> 16) & 0xff) * r / 23, 0, 255),
-      clamp(((c >> 8) & 0xff) * r / 23, 0, 255),
-      clamp((c & 0xff) * r / 23, 0, 255)
-    );
-    int pix = from - i;
-    if (pix < 0) pix += 24;
-    strip.setPixelColor(pix % strip.numPixels(), c1);
-  }
-  strip.show();
-}
+// fading tail, one revolution
+const RING_KEYFRAME spinnerFrames[] PROGMEM = {
+  {0, 24, 255, 0}, {24, 24, 255, 0}
+};
+const RING_ANIMATION spinnerAnimation PROGMEM = {
+  spinnerFrames, 2, RING_LOOP | RING_INTERPOLATE, SPINNER_REVOLUTION
+};
 
-void animation() {
-   static int pos = 0;
+// shrinks back to the pixel 4 while the door is unlocked
+const RING_KEYFRAME countdownFrames[] PROGMEM = {
+  {27, 24, 255, 255}, {4, 1, 255, 255}
+};
+const RING_ANIMATION countdownAnimation PROGMEM = {
+  countdownFrames, 2, RING_INTERPOLATE, OUTPUT_ENABLE_DURATION
+};
+
+const RING_KEYFRAME doorbellFrames[] PROGMEM = {
+  {0, 24, 255, 255}
+};
+const RING_ANIMATION doorbellAnimation PROGMEM = {
+  doorbellFrames, 1, 0, 500
+};
 
-   // animation changes based on lock and doorbell states
+// while a card is checked with the server, static as frames are held until the reply
+const RING_KEYFRAME queryingFrames[] PROGMEM = {
+  {0, 24, 255, 255}
+};
+const RING_ANIMATION queryingAnimation PROGMEM = {
+  queryingFrames, 1, 0, 300
+};
 
-   if (isDoorUnlocked()) {
-      // countdown animation
+// two flashes
+const RING_KEYFRAME deniedFrames[] PROGMEM = {
+  {0, 24, 255, 255}, {0, 0, 0, 0}, {0, 24, 255, 255}, {0, 0, 0, 0}
+};
+const RING_ANIMATION deniedAnimation PROGMEM = {
+  deniedFrames, 4, 0, 250
+};
 
-      if (millis() < outputEnableTimer) {
-        pos =  23 * (outputEnableTimer - millis()) / OUTPUT_ENABLE_DURATION;
-      } else {
-        pos = 0;
-      }
+void animation() {
+   // animation changes based on lock and doorbell states,
+   // the countdown, doorbell and denied animations are started by the events
 
-      segment(strip.Color(0,255,0), 0, 4, pos + 4);
+   if (isDoorUnlocked()) {
+      if (ring.current() != &countdownAnimation) {
+        ring.play(&countdownAnimation, strip.Color(0,255,0));
+      }
 
-      //reset pos to top postion, so that spinner always resumes from right position
-      pos = 4;
-      
    } else if (doorbellOn) {
-    // doorbell on
+      // hold the doorbell animation
+
+   } else if (cardVerify.seq != 0) {
+      // waiting for the server
+      if (ring.current() != &queryingAnimation) {
+        ring.play(&queryingAnimation, strip.Color(255,128,0));
+      }
+
+   } else if (ring.current() == &deniedAnimation && ring.isPlaying()) {
+      // let denied finish
 
-    // do nothing, LEDs should already be blue as set by the doorbell task
-    
    } else {
-    
-     // normal spinner animation
-
-     // clockwise if ESP connected
-     if (true) {
-        pos++;
-        if (pos > 23) pos = 0;
-     } else {
-        // anti-clockwise if not
-        pos--;
-        if (pos < 0) pos = 23;
-     }
-  
-     uint32_t c = strip.Color(150,60,0);
-     if (doorOpen) {
-        c = strip.Color(150,0,0);  // red if doorOpen
-     }
-  
-     spinner(c, pos, 5);
+      // normal spinner animation, red if doorOpen
+      if (ring.current() != &spinnerAnimation) {
+        ring.play(&spinnerAnimation, 0);
+      }
+      ring.setColour(doorOpen ? strip.Color(150,0,0) : strip.Color(150,60,0));
    }
+
+   // only redraws on a frame boundary
+   ring.loop();
+
+   // hold frames while a reply is due or arriving, sending one blocks interrupts for ~720us,
+   // longer than the UART's 2 byte FIFO lasts at 115200
+   strip.setHold(cardVerify.seq != 0 || syncVerify.seq != 0 || hbSeq != 0 || EspSerial.available());
 }
 
 /* ========================================================================== *
@@ -363,15 +475,15 @@ void animation() {
 // duration in milliseconds
 void unlockDoor(unsigned long duration) {
   unlockCount++;
-  Serial.print(F("Door Unlocked, "));  Serial.println(unlockCount);
+  Debug.print(F("Door Unlocked, "));  Debug.println(unlockCount);
   digitalWrite(OUTPUT_PIN, LOW);
   outputEnableTimer = millis() + duration;
-  // green when unlocked
-  colorWipe(strip.Color(0, 255, 0), 1);
+  // green countdown, restarts if already unlocked
+  ring.play(&countdownAnimation, strip.Color(0, 255, 0));
 }
 
 void lockDoor() {
-  Serial.println(F("Door Locked"));
+  Debug.println(F("Door Locked"));
   digitalWrite(OUTPUT_PIN, HIGH);
   // return to orange
   //colorWipe(strip.Color(50, 25, 0), 50);
@@ -393,6 +505,31 @@ void monitorOutput() {
  *  Token Cache
  * ========================================================================== */
 
+#ifdef ENABLE_BUILTIN_BADGES
+// 32 bit FNV-1a, must match badge_hash() in tools/genBuiltinBadges.py
+uint32_t badgeHash(const uint8_t *token, uint8_t length, uint8_t seed) {
+  uint32_t h = 2166136261UL ^ seed;
+  for (uint8_t i=0; i<length; i++) {
+    h ^= token[i];
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+// flags for a builtin badge, 0 if token is not one
+// perfect hash, so a single PROGMEM compare and no RAM
+uint8_t getBuiltinBadgeFlags(const uint8_t *token, uint8_t length) {
+  uint8_t bucket = badgeHash(token, length, 0) % BUILTIN_BADGE_BUCKETS;
+  uint8_t seed = pgm_read_byte(&builtinBadgeSeeds[bucket]);
+  const uint8_t *badge = builtinBadges[badgeHash(token, length, seed) % BUILTIN_BADGE_COUNT];
+
+  if (pgm_read_byte(&badge[7]) != length || memcmp_P(token, badge, length) != 0) {
+    return 0;
+  }
+  return pgm_read_byte(&badge[8]);
+}
+#endif
+
 // Get cache item by token, returns null if not in cache
 TOKEN_CACHE_ITEM* getTokenFromCache(TOKEN* token, uint8_t length) {
   // search through items to find a match to token
@@ -452,10 +589,10 @@ TOKEN_CACHE_ITEM* addTokenToCache(TOKEN* token, uint8_t length, uint8_t flags) {
   syncEEPROM();
 
   // print number of cache slots used
-  Serial.print(F("Cache used: "));
-  Serial.print(cacheSize);
-  Serial.print('/');
-  Serial.println(CACHE_SIZE);
+  Debug.print(F("Cache used: "));
+  Debug.print(cacheSize);
+  Debug.print('/');
+  Debug.println(CACHE_SIZE);
 
   // return new item
   return &cache[pos];
@@ -470,13 +607,13 @@ void removeTokenFromCache(TOKEN_CACHE_ITEM* item) {
 }
 
 void initCache() {
-  Serial.println(F("Loading cache from EEPROM..."));
+  Debug.println(F("Loading cache from EEPROM..."));
 
   EEPROM.begin();
 
   // read magic
   if (EEPROM.read(0) != EEPROM_MAGIC) {
-    Serial.println(F("Magic changed, resetting cache"));
+    Debug.println(F("Magic changed, resetting cache"));
     // reset stored cache size
     EEPROM.write(0, EEPROM_MAGIC);
     EEPROM.write(1, 0);
@@ -484,88 +621,110 @@ void initCache() {
     cacheSize = 0;
   } else {
     cacheSize = EEPROM.read(1);
-    Serial.print(cacheSize);
-    Serial.println(F(" items"));
+    Debug.print(cacheSize);
+    Debug.println(F(" items"));
   }
 
-  // read token items from cache
-  uint8_t i = 0, j = 0;
+  // read token items from cache, a record at a time to keep the stack small
+  if (cacheSize > CACHE_SIZE) cacheSize = 0;
+  TOKEN_EEPROM_ITEM stored;
+  uint8_t i = 0;
   uint16_t addr = 2;
   for (i=0; i<cacheSize; i++) {
-    // token
-    for (j=0; j<7; j++) {
-      cache[i].token[j] = EEPROM.read(addr + j);
-    }
-
-    // length
-    cache[i].length = EEPROM.read(addr + 7);
-
-    // flags
-    cache[i].flags = EEPROM.read(addr + 8);
-
-    updateTokenStr(cache[i].token, cache[i].length);
-
-    Serial.print(' ');
-    Serial.print(tokenStr);
-    Serial.print(':');
-    Serial.println(cache[i].flags);
+    EEPROM.get(addr, stored);
+    memcpy(cache[i].token, stored.token, sizeof(TOKEN));
+    cache[i].length = stored.length;
+    cache[i].flags = stored.flags;
 
     cache[i].count = 0;
     cache[i].sync = 1 + i;  // resync everything soon-ish
 
-    addr += 9;
+    addr += sizeof(TOKEN_EEPROM_ITEM);
   }
+}
 
-#ifdef ENABLE_BUILTIN_BADGES
-  TOKEN *token;
-  for (i=0; i < BUILTIN_BADGE_COUNT; i++) {
-    token = (TOKEN*)&builtinBadges[i];
-    addTokenToCache(token, 4, 3);
+// print every cached token, slow so not done during boot
+void dumpCache() {
+  for (uint8_t i=0; i<cacheSize; i++) {
+    formatToken(tokenStr, cache[i].token, cache[i].length);
+
+    Debug.print(' ');
+    Debug.print(tokenStr);
+    Debug.print(':');
+    Debug.println(cache[i].flags);
   }
-#endif
+}
+
+// note the end of a boot phase
+void bootPhase(uint8_t phase) {
+  bootTimes[phase] = millis();
+}
+
+// boot phase timings, from power on (after the bootloader)
+void printBootTimes() {
+  Debug.print(F("Boot ms: pn532 "));
+  Debug.print(bootTimes[BOOT_PN532]);
+  Debug.print(F(", cache "));
+  Debug.print(bootTimes[BOOT_CACHE]);
+  Debug.print(F(", leds "));
+  Debug.print(bootTimes[BOOT_LEDS]);
+  Debug.print(F(", ready "));
+  Debug.print(bootTimes[BOOT_READY]);
+  Debug.print(F(", first read "));
+  Debug.println(bootTimes[BOOT_FIRST_READ]);
 }
 
 // task to update permission flags in cache, e.g. if someones access has changed
 // called every 10min ish
 void syncCache() {
+  enterPhase(LOOP_PHASE_SYNC);
+
   // for each item in cache
   uint8_t i;
   for (i=0; i<cacheSize; i++) {
-    // dec sync counter
-    cache[i].sync--;
+    // dec sync counter, items at zero are queried one at a time by checkPendingVerifies
+    if (cache[i].sync > 0) {
+      cache[i].sync--;
+    }
+  }
 
-    // if reached zero
-    if (cache[i].sync == 0 && cache[i].length > 0) {
-      Serial.print(F("Syncing cached flags for: "));
-      updateTokenStr(cache[i].token, cache[i].length);
-      Serial.println(tokenStr);
+}
 
-      // query permission flags from server
-      uint8_t flags = queryServer();
+// task to send the stats for the last interval to the server, via the ESP
+void sendTelemetry() {
+  ESPLINK_TELEMETRY_RECORD t;
+
+  t.uptime = millisRollovers * 4294967UL + millis() / 1000;
+  t.unlocks = unlockCount;
+  t.pn532Resets = PN532Resets;
+  t.espResets = espResets;
+  t.cacheHits = cacheHits;
+  t.cacheMisses = cacheMisses;
+  t.loops = loopHist.count;
+  t.loopAvg = loopHist.count > 0 ? loopTotal / loopHist.count : 0;
+  t.loopMax = loopHist.max;
+  t.linkErrors = espLink.crcErrors + espLink.framingErrors;
+#ifdef RINGUART_USART0
+  t.linkErrors += Uart.rxOverruns + Uart.rxErrors;
+#endif
 
-      if (flags != TOKEN_ERROR) {
-        if (flags > 0) {
-         // if successful, update flags and reset sync counter
-         cache[i].flags = flags;
-         cache[i].sync = CACHE_SYNC;
-        } else {
-          // else remove token
-          removeTokenFromCache(&cache[i]);
-        }
-      } else {
-        // else try again next cycle
-        cache[i].sync = 1;
-      }
+  sendEspFrame(ESPLINK_TELEMETRY, (uint8_t*)&t, sizeof(t));
 
-    }
-  }
+  ESPLINK_LOOP_RECORD l;
+  memcpy(l.hist, loopHist.buckets, sizeof(l.hist));
+  l.longest = loopHist.max;
+  l.longestPhase = longestPhase;
+  l.wdtGapMax = wdtGapMax;
+  l.wdtNearMisses = wdtNearMisses;
 
-  // sync changes to EEPROM
-  syncEEPROM();
+  sendEspFrame(ESPLINK_LOOPSTATS, (uint8_t*)&l, sizeof(l));
 
-  // send uptime log to server via ESP
-  ESPSerial.print('!');
-  uptime(ESPSerial, true);
+  cacheHits = 0;
+  cacheMisses = 0;
+  loopTotal = 0;
+  loopHist.clear();
+  wdtGapMax = 0;
+  wdtNearMisses = 0;
 }
 
 
@@ -604,7 +763,7 @@ void syncEEPROM() {
   }
 
   if (changed) {
-    Serial.println(F("Updating EEPROM"));
+    Debug.println(F("Updating EEPROM"));
   }
 }
 
@@ -613,32 +772,87 @@ void syncEEPROM() {
  *  ESP Interface
  * ========================================================================== */
 
-// query server for token, and return flags
-uint8_t queryServer() {
-   uint8_t flags = 0;
-
-   // send query to ESP
-   ESPSerial.print('?');
-   ESPSerial.print(tokenStr);
-   ESPSerial.print('\n');
-
-   // wait for reply, no more than 4 seconds
-   unsigned long giveUp = millis() + 4000;
- 
-   do {
-      flags = handleSerial();
-   } while (flags ==0 && millis() < giveUp);
-   
-   return flags;
+// send a frame to the ESP, returns its seq
+uint8_t sendEspFrame(uint8_t type, const uint8_t *payload, uint8_t length) {
+   espSeq = espSeq == 255 ? 1 : espSeq + 1;
+   if (type == ESPLINK_VERIFY || type == ESPLINK_HEARTBEAT) {
+      // the reply can start before animation() next sets the hold
+      strip.setHold(true);
+   }
+   espLinkSend(EspSerial, espSeq, type, payload, length);
+   return espSeq;
+}
+
+// ask the server for a token's flags, the reply is handled by handleSerial
+void sendVerify(PENDING_VERIFY &verify, const uint8_t *token, uint8_t length) {
+   memcpy(verify.token, token, length);
+   verify.length = length;
+   verify.sent = millis();
+   verify.seq = sendEspFrame(ESPLINK_VERIFY, token, length);
+}
+
+// time out verifies and heartbeats that got no reply, and start the next cache resync
+void checkPendingVerifies() {
+   if (hbSeq != 0 && millis() - hbSent > ESP_REPLY_TIMEOUT) {
+      hbSeq = 0;
+   }
+
+   if (cardVerify.seq != 0 && millis() - cardVerify.sent > ESP_REPLY_TIMEOUT) {
+      Debug.println(F("ESP timeout"));
+      cardVerify.seq = 0;
+      cardDecision(TOKEN_ERROR);
+   }
+
+   if (syncVerify.seq != 0 && millis() - syncVerify.sent > ESP_REPLY_TIMEOUT) {
+      syncVerify.seq = 0;
+      syncDecision(TOKEN_ERROR);
+   }
+
+   if (syncVerify.seq == 0) {
+      for (uint8_t i=0; i<cacheSize; i++) {
+         if (cache[i].sync == 0 && cache[i].length > 0) {
+            Debug.print(F("Syncing cached flags for: "));
+            formatToken(tokenStr, cache[i].token, cache[i].length);
+            Debug.println(tokenStr);
+
+            sendVerify(syncVerify, cache[i].token, cache[i].length);
+            break;
+         }
+      }
+   }
+}
+
+// server reply to a cache resync
+void syncDecision(uint8_t flags) {
+   // find the item again, the cache may have changed while waiting
+   TOKEN_CACHE_ITEM* item = getTokenFromCache(&syncVerify.token, syncVerify.length);
+   if (item == NULL) {
+      return;
+   }
+
+   if (flags != TOKEN_ERROR) {
+      if (flags > 0) {
+         // if successful, update flags and reset sync counter
+         item->flags = flags;
+         item->sync = CACHE_SYNC;
+      } else {
+         // else remove token
+         removeTokenFromCache(item);
+      }
+      // sync changes to EEPROM
+      syncEEPROM();
+   } else {
+      // else try again next cycle
+      item->sync = 1;
+   }
 }
 
 
 // send a log msg to the server, fire and forget
-void sendLogMsg(String msg1, String msg2) {
-   ESPSerial.print('!');
-   ESPSerial.print(msg1);
-   ESPSerial.print(msg2);
-   ESPSerial.print('\n');
+void sendLogMsg(const __FlashStringHelper *msg1, const char *msg2) {
+   FixedString<ESPLINK_MAX_PAYLOAD + 1> msg;
+   msg.append(msg1).append(msg2);
+   sendEspFrame(ESPLINK_LOG, (const uint8_t*)msg.c_str(), msg.length());
 }
 
 
@@ -656,7 +870,7 @@ void resetPN532() {
   // inc reset counter
   PN532Resets++;
 
-  Serial.print(F("PN532 reset: "));  Serial.println(PN532Resets);
+  Debug.print(F("PN532 reset: "));  Debug.println(PN532Resets);
 
   nfc.begin();
 
@@ -666,19 +880,20 @@ void resetPN532() {
   nfc.getGeneralStatus();
   nfc.getFirmwareVersion();
 
-  //Serial.println(nfc.getGeneralStatus());
-  //Serial.println(nfc.getFirmwareVersion());
+  //Debug.println(nfc.getGeneralStatus());
+  //Debug.println(nfc.getFirmwareVersion());
 
   nfc.SAMConfig();
 }
 
 // TODO: Get IRQ working to avoid polling for card?
 void cardAvailable() {
-  Serial.println("IRQ change");
+  Debug.println("IRQ change");
 }
 
 // Task to keep RFID connected - i.e. reset PN532 if goes weird
 void keepRFIDConnected() {
+   enterPhase(LOOP_PHASE_RFID);
 
    // seem to need to call this before a getFirmwareVersion to get reliable response!?!
    nfc.getGeneralStatus();
@@ -686,13 +901,13 @@ void keepRFIDConnected() {
    uint32_t versiondata = nfc.getFirmwareVersion();
 
    if (! versiondata) {
-      Serial.println(F("PN532 -> Error - Resetting"));
+      Debug.println(F("PN532 -> Error - Resetting"));
 
       // Reset the PN532 if it locks up
       resetPN532();
 
    } else {
-      //Serial.println("PN532 -> OK");
+      //Debug.println("PN532 -> OK");
 
       // configure board to read RFID tags - again and again
       nfc.SAMConfig();
@@ -712,11 +927,23 @@ void lookForCard() {
 
   TOKEN_CACHE_ITEM* item;
 
+  // still waiting on the server for the last card
+  if (cardVerify.seq != 0) {
+    return;
+  }
+
   // Wait for an ISO14443A type cards (Mifare, etc.).  When one is found
   // 'uid' will be populated with the UID, and uidLength will indicate
   // if the uid is 4 bytes (Mifare Classic) or 7 bytes (Mifare Ultralight)
   success = nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &uidLength, PN532_READ_TIMEOUT);
 
+  // the door can respond to cards from here
+  if (!booted) {
+    booted = true;
+    bootPhase(BOOT_FIRST_READ);
+    printBootTimes();
+  }
+
   if (success && (memcmp(luid, uid, uidLength)!=0 || (millis() > lastChecked + CARD_DEBOUNCE_DELAY))) {
 
     // store the uid to permit debounce
@@ -724,35 +951,61 @@ void lookForCard() {
 
     lastChecked = millis();
 
-    updateTokenStr(uid, uidLength);
+    formatToken(tokenStr, uid, uidLength);
     
-    Serial.print(F("Card found: "));  Serial.println(tokenStr);
-    Serial.println(uidLength);
+    Debug.print(F("Card found: "));  Debug.println(tokenStr);
+    Debug.println(uidLength);
+
+#ifdef ENABLE_BUILTIN_BADGES
+    // builtin badges are checked first, they never use the cache or the server
+    if (getBuiltinBadgeFlags(uid, uidLength) & TOKEN_ACCESS) {
+      Debug.println(F("Builtin badge"));
+      unlockDoor(OUTPUT_ENABLE_DURATION);
+      sendLogMsg(F("Permission granted to: "), tokenStr);
+      return;
+    }
+#endif
 
     // check cache
     item = getTokenFromCache(&uid, uidLength);
 
-    //if not found, then query server and add to cache if has permission
+    //if not found, then query server, the decision is made when the reply arrives
     if (item == NULL) {
-      Serial.println(F("Not in cache"));
+      Debug.println(F("Not in cache"));
+      cacheMisses++;
       
       // bright orange - found card, querying server
-      colorWipe(strip.Color(255, 128, 0), 0);
-    
-      uint8_t flags = queryServer();
-      Serial.println(flags);
-      if ((flags > 0) && (flags != TOKEN_ERROR)) {
-        item = addTokenToCache(&uid, uidLength, flags);
-      }
-    } else {
-      Serial.println(F("In cache"));
-      // double check it's a valid item
-      if (item->flags == 0) {
-        removeTokenFromCache(item);
-        item = NULL;
-      }
+      sendVerify(cardVerify, uid, uidLength);
+      return;
+    }
+
+    Debug.println(F("In cache"));
+    cacheHits++;
+    // double check it's a valid item
+    if (item->flags == 0) {
+      removeTokenFromCache(item);
+      item = NULL;
     }
 
+    grantOrDeny(item);
+  }
+}
+
+// server reply for a card that was not in the cache, add to cache if has permission
+void cardDecision(uint8_t flags) {
+  TOKEN_CACHE_ITEM* item = NULL;
+
+  Debug.println(flags);
+  if ((flags > 0) && (flags != TOKEN_ERROR)) {
+    item = addTokenToCache(&cardVerify.token, cardVerify.length, flags);
+  }
+
+  formatToken(tokenStr, cardVerify.token, cardVerify.length);
+  grantOrDeny(item);
+}
+
+// item is NULL for an unknown card
+void grantOrDeny(TOKEN_CACHE_ITEM* item) {
     // if got valid details and permission given, then open/power the thing, if not, don't
     if (item != NULL) {
 
@@ -761,37 +1014,31 @@ void lookForCard() {
         // permission given, so open/power the thing
         item->count++;
 
-        Serial.print(F("Permission granted: "));
-        Serial.println(item->count);
+        Debug.print(F("Permission granted: "));
+        Debug.println(item->count);
         unlockDoor(OUTPUT_ENABLE_DURATION);
 
-        sendLogMsg(F("Permission%20granted%20to:%20"), tokenStr);
+        sendLogMsg(F("Permission granted to: "), tokenStr);
         
         //sendTelegramMsg("Door opened");
 
       } else {
         // permission denied!
-        Serial.println(F("Permission denied"));
-        sendLogMsg(F("Permission%20denied%20to:%20"), tokenStr);
-
-        // red
-        colorWipe(strip.Color(255, 0, 0), 0);
+        Debug.println(F("Permission denied"));
+        sendLogMsg(F("Permission denied to: "), tokenStr);
 
-        delay(1000);
+        // flash red
+        ring.play(&deniedAnimation, strip.Color(255, 0, 0));
       }
 
     } else {
       // permission denied!
-        Serial.println(F("Permission denied"));
-        sendLogMsg(F("Permission%20denied%20to:%20"), tokenStr);
+        Debug.println(F("Permission denied"));
+        sendLogMsg(F("Permission denied to: "), tokenStr);
 
-        // red
-        colorWipe(strip.Color(255, 0, 0), 0);
-
-        delay(1000);
+        // flash red
+        ring.play(&deniedAnimation, strip.Color(255, 0, 0));
     }
-
-  }
 }
 
 
@@ -805,6 +1052,7 @@ void resetESP() {
   digitalWrite(ESP_RESET_PIN, LOW);
   delay(10);
   digitalWrite(ESP_RESET_PIN, HIGH);
+  espResets++;
   // reset the HB timer...  give the ESP a chance to reboot
   lastHB = millis();
 }
@@ -812,15 +1060,16 @@ void resetESP() {
 // Task to keep ESP connected
 void keepESPConnected() {
    // send HB
-   ESPSerial.print("~\n");
-   Serial.println("HB");
+   hbSeq = sendEspFrame(ESPLINK_HEARTBEAT, NULL, 0);
+   hbSent = millis();
+   Debug.println("HB");
 
    // NB: Heartbeats are received in the serial handling loop
 
    // check how long since last HB
    if (millis() > lastHB + 30000) {
       // been ages, so reset ESP
-      Serial.println(F("Resetting ESP..."));
+      Debug.println(F("Resetting ESP..."));
       resetESP();
    }
 }
@@ -841,16 +1090,16 @@ void monitorDoorSensor() {
     doorOpen = newDoorOpen;
 
     if (doorOpen) {
-      Serial.println(F("Door opened"));
+      Debug.println(F("Door opened"));
 
       // Compare to lock status...  scream if not expected to be opened!!
       if (!isDoorUnlocked() ) {
-        Serial.println(F("AAARRGH: Door opened unexpectedly!"));
+        Debug.println(F("AAARRGH: Door opened unexpectedly!"));
         //sendTelegramMsg("AARGH someone has forced the door open");
       }
 
     } else {
-      Serial.println(F("Door closed"));
+      Debug.println(F("Door closed"));
     }
   }
 }
@@ -874,7 +1123,7 @@ void exitButtonISR() {
 void monitorExitButton() {
     if (exitPressed) {
       exitPressed = false;
-      Serial.println("Exit button pressed");
+      Debug.println("Exit button pressed");
       unlockDoor(OUTPUT_ENABLE_DURATION);
     }
 }
@@ -889,9 +1138,11 @@ void monitorDoorbell() {
 
   // turn doorbell on?
   if (bellPressed) {
-    colorWipe(strip.Color(0, 0, 255), 0);
-    
-    Serial.println(F("Bing bong"));
+    if (!doorbellOn) {
+      ring.play(&doorbellAnimation, strip.Color(0, 0, 255));
+    }
+
+    Debug.println(F("Bing bong"));
 
     digitalWrite(DOORBELL_ALARM_PIN, LOW);
 
@@ -901,7 +1152,7 @@ void monitorDoorbell() {
 
   // turn doorbell off?
   if (doorbellOn && millis() > doorbellTimer) {
-    Serial.println("Doorbell off");
+    Debug.println("Doorbell off");
     doorbellOn = false;
 
     digitalWrite(DOORBELL_ALARM_PIN, HIGH);
@@ -913,47 +1164,35 @@ void monitorDoorbell() {
  *  Serial handling
  * ========================================================================== */
 
-// call to process serial, will return non-zero value if it gets a query reply
-uint8_t handleSerial() {
-  uint8_t flags = 0;
-  
-  while (ESPSerial.available()) {
-    char inChar = (char)ESPSerial.read();
-    if (inChar == '\n') {
-      stringComplete = true;
-    } else if (inChar != '\r') {
-      inputChars++;
-      if (inputChars < MAXINPUTCHARS) {
-        inputString += inChar;
-      }
-    }
-  
-    if (stringComplete) {
-      Serial.print("ESP:");
-      Serial.println(inputString);    
-  
-      // reply to query?
-      if (inputString[0] == '?') {
-        // look at second character to see if door should open!
-        flags = (uint8_t)inputString[1] - 48;  // convert from ascii representation
-      } else if (inputString[0] == '~') {
+// call to process frames from the ESP, verify replies are matched to the pending verifies by seq
+void handleSerial() {
+  while (EspSerial.available()) {
+    if (espLink.decode(EspSerial.read())) {
+      ESPLINK_FRAME &f = espLink.frame;
+
+      if (f.type == (ESPLINK_VERIFY | ESPLINK_REPLY) && f.length == 1) {
+        if (f.seq == cardVerify.seq) {
+          cardVerify.seq = 0;
+          cardDecision(f.payload[0]);
+        } else if (f.seq == syncVerify.seq) {
+          syncVerify.seq = 0;
+          syncDecision(f.payload[0]);
+        } else {
+          // late reply to a query that already timed out
+          Debug.print(F("ESP: stale reply "));
+          Debug.println(f.seq);
+        }
+      } else if (f.type == (ESPLINK_HEARTBEAT | ESPLINK_REPLY)) {
         // received reply to heartbeat
         lastHB = millis();
-      } else {
-        
+        if (f.seq == hbSeq) hbSeq = 0;
       }
-      
-      // clear the string:
-      inputChars = 0;
-      inputString = "";
-      stringComplete = false;
     }
 
     // reset watchdog
-    wdt_reset();
+    feedWatchdog();
 
   }
-  return flags;
 }
 
 
@@ -982,42 +1221,46 @@ void setup(void) {
 
   //attachInterrupt(digitalPinToInterrupt(PN532_IRQ_PIN), cardAvailable, CHANGE);
 
-  inputString.reserve(MAXINPUTCHARS);
-
   // make sure door is locked
   lockDoor();
 
   // start serial
-  Serial.begin(9600);
+  Debug.begin(DEBUG_BAUD);
+  Debug.stopListening();  // transmit only
 
-  Serial.println();
-  Serial.println(F("Door Controller"));
-  Serial.print("V:");  Serial.println(VERSION);
+  Debug.println();
+  Debug.println(F("Door Controller"));
+  Debug.print("V:");  Debug.println(VERSION);
 
-  Serial.println(F("Listening for exit button..."));
+  Debug.println(F("Listening for exit button..."));
   attachInterrupt(digitalPinToInterrupt(EXIT_BUTTON_PIN), exitButtonISR, FALLING);
 
   // Start PN532
-  Serial.println(F("Connecting to PN532..."));
+  Debug.println(F("Connecting to PN532..."));
   resetPN532();
+  bootPhase(BOOT_PN532);
 
   // init EEPROM and load cache
   initCache();
+  bootPhase(BOOT_CACHE);
 
-  Serial.println(F("Starting fancy LEDs..."));
+  // one show, a 50ms per pixel wipe here held up boot by 1.2s
+  Debug.println(F("Starting fancy LEDs..."));
   strip.begin();
-  colorWipe(strip.Color(80, 80, 80), 50);
+  colorWipe(strip.Color(80, 80, 80), 0);
+  bootPhase(BOOT_LEDS);
 
-  Serial.println(F("Connecting to ESP..."));
-  ESPSerial.begin(9600);
+  Debug.println(F("Connecting to ESP..."));
+  EspSerial.begin(ESP_BAUD);
 
   // Setup scheduler
-  Serial.println(F("Configuring tasks..."));
+  Debug.println(F("Configuring tasks..."));
   runner.init();
   runner.addTask(ESPConnectionTask);
   //runner.addTask(lookForCardTask);
   runner.addTask(displayUptimeTask);
   runner.addTask(syncCacheTask);
+  runner.addTask(telemetryTask);
   runner.addTask(RFIDConnectionTask);
   //runner.addTask(monitorDoorSensorTask);
 
@@ -1027,13 +1270,20 @@ void setup(void) {
   //lookForCardTask.enableDelayed(500);
   displayUptimeTask.enable();
   syncCacheTask.enable();
+  telemetryTask.enableDelayed(TELEMETRY_TASK_INTERVAL);
   //monitorDoorSensorTask.enable();
+#ifdef DUMP_CACHE_ON_BOOT
+  runner.addTask(dumpCacheTask);
+  dumpCacheTask.enableDelayed(DUMP_CACHE_DELAY);
+#endif
 
-  Serial.println(F("Ready"));
-  Serial.println();
+  Debug.println(F("Ready"));
+  Debug.println();
 
   // enable watchdog, 8 sec timeout
   wdt_enable(WDTO_8S);
+  lastWdtReset = millis();
+  bootPhase(BOOT_READY);
 }
 
 
@@ -1042,14 +1292,28 @@ void setup(void) {
  * ========================================================================== */
 
 void loop(void) {
+  // loop time, for telemetry
+  // the phase that took longest is kept with the slowest loop
+  enterPhase(LOOP_PHASE_TASKS);
+  static unsigned long lastLoop = micros();
+  unsigned long loopTime = micros() - lastLoop;
+  lastLoop += loopTime;
+  loopTotal += loopTime;
+  if (loopTime > loopHist.max) longestPhase = slowPhase;
+  loopHist.add(loopTime);
+  slowPhaseTime = 0;
+
   // execute tasks
   runner.execute();
 
+  enterPhase(LOOP_PHASE_CARD);
   lookForCard();
+
+  enterPhase(LOOP_PHASE_IO);
   monitorDoorSensor();
 
   // keep track of uptime
-  uptime(Serial, false);
+  uptime(Debug, false);
 
   // TODO: Apply fix for millis overflows around 49 days
 
@@ -1057,16 +1321,23 @@ void loop(void) {
   // I've rebooted log msg
   // send heartbeat to server - 10min?
 
+  enterPhase(LOOP_PHASE_ANIMATION);
   animation();
+  strip.loop();  // flush any rate limited frame
+
+  enterPhase(LOOP_PHASE_IO);
   monitorOutput();
   monitorDoorbell();
   monitorExitButton();
 
+  // replies from the ESP, unlocks as soon as a pending card is granted
+  enterPhase(LOOP_PHASE_SERIAL);
   handleSerial();
+  checkPendingVerifies();
   
   // visual comfort
   digitalWrite(BUILTIN_LED, !digitalRead(BUILTIN_LED));
 
   // reset watchdog
-  wdt_reset();
+  feedWatchdog();
 }
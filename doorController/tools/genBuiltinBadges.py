@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+Generates doorController/builtinBadges.h, a PROGMEM perfect hash table of
+badges that always open the door, even with no server and an empty cache.
+
+Input is one badge per line, token as hex and optional flags (default 3,
+TOKEN_ACCESS | TOKEN_TRAINER), # starts a comment:
+
+    04a10bff00807e
+    deadbeef 1
+
+Usage:
+    python3 tools/genBuiltinBadges.py builtinBadges.txt > builtinBadges.h
+
+Lookup on the door is two hashes and one PROGMEM compare:
+    bucket = hash(token, 0) % BUILTIN_BADGE_BUCKETS
+    slot = hash(token, builtinBadgeSeeds[bucket]) % BUILTIN_BADGE_COUNT
+hash is 32 bit FNV-1a with the seed xored into the offset basis, it must
+match badgeHash() in doorController.ino.
+"""
+
+import sys
+
+TOKEN_ACCESS = 0x01
+TOKEN_TRAINER = 0x02
+MAX_BADGES = 255    # slots are uint8_t
+BADGES_PER_BUCKET = 4
+
+
+def badge_hash(token, seed):
+    h = 2166136261 ^ seed
+    for b in token:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def read_badges(f):
+    badges = []
+    seen = set()
+    for n, line in enumerate(f, 1):
+        line = line.split('#', 1)[0].split()
+        if not line:
+            continue
+        try:
+            token = bytes.fromhex(line[0])
+            flags = int(line[1], 0) if len(line) > 1 else TOKEN_ACCESS | TOKEN_TRAINER
+        except ValueError:
+            sys.exit('line %d: expected "<hex token> [flags]"' % n)
+        if len(token) not in (4, 7):
+            sys.exit('line %d: token must be 4 or 7 bytes' % n)
+        if not 0 < flags < 256:
+            sys.exit('line %d: flags must be 1-255' % n)
+        if token in seen:
+            sys.exit('line %d: duplicate token %s' % (n, token.hex()))
+        seen.add(token)
+        badges.append((token, flags))
+
+    if not badges:
+        sys.exit('no badges, undefine ENABLE_BUILTIN_BADGES instead')
+    if len(badges) > MAX_BADGES:
+        sys.exit('at most %d builtin badges' % MAX_BADGES)
+    return badges
+
+
+# hash and displace: place the biggest buckets first, searching for a seed
+# that puts every token in the bucket into a free slot
+def build(badges, bucketCount):
+    n = len(badges)
+    buckets = [[] for _ in range(bucketCount)]
+    for badge in badges:
+        buckets[badge_hash(badge[0], 0) % bucketCount].append(badge)
+
+    seeds = [0] * bucketCount
+    slots = [None] * n
+    for b in sorted(range(bucketCount), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for seed in range(256):
+            wanted = [badge_hash(t, seed) % n for t, _ in buckets[b]]
+            if len(set(wanted)) == len(wanted) and all(slots[s] is None for s in wanted):
+                break
+        else:
+            return None
+        seeds[b] = seed
+        for s, badge in zip(wanted, buckets[b]):
+            slots[s] = badge
+    return seeds, slots
+
+
+def lookup(seeds, slots, token):
+    seed = seeds[badge_hash(token, 0) % len(seeds)]
+    badge = slots[badge_hash(token, seed) % len(slots)]
+    return badge[1] if badge[0] == token else 0
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    with open(sys.argv[1]) as f:
+        badges = read_badges(f)
+
+    bucketCount = (len(badges) + BADGES_PER_BUCKET - 1) // BADGES_PER_BUCKET
+    table = None
+    while table is None and bucketCount <= MAX_BADGES:
+        table = build(badges, bucketCount)
+        if table is None:
+            bucketCount += 1
+    if table is None:
+        sys.exit('could not build a perfect hash')
+    seeds, slots = table
+
+    for token, flags in badges:
+        assert lookup(seeds, slots, token) == flags
+
+    out = sys.stdout
+    out.write('// generated by tools/genBuiltinBadges.py from %s, do not edit\n' % sys.argv[1])
+    out.write('#ifndef BUILTIN_BADGES_H\n#define BUILTIN_BADGES_H\n\n')
+    out.write('#define BUILTIN_BADGE_COUNT    %d\n' % len(slots))
+    out.write('#define BUILTIN_BADGE_BUCKETS  %d\n\n' % len(seeds))
+    out.write('const uint8_t builtinBadgeSeeds[BUILTIN_BADGE_BUCKETS] PROGMEM = {\n')
+    out.write('  %s\n};\n\n' % ', '.join(str(s) for s in seeds))
+    out.write('// token (7 bytes, zero padded), length, flags\n')
+    out.write('const uint8_t builtinBadges[BUILTIN_BADGE_COUNT][9] PROGMEM = {\n')
+    for token, flags in slots:
+        row = list(token.ljust(7, b'\0')) + [len(token), flags]
+        out.write('  {%s},  // %s\n' % (', '.join('0x%02x' % b for b in row), token.hex()))
+    out.write('};\n\n#endif\n')
+
+
+if __name__ == '__main__':
+    main()
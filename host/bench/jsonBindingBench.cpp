@@ -0,0 +1,146 @@
+/*
+  * Decoding the controllers' messages into structs: JsonBinding against parseObject().
+  *
+  * For each document it reports the time per decode and the JsonBuffer bytes used by
+  *   parseObject - a copy of the body parsed in place, then operator[] for each field
+  *   binding - JsonBinding::parse() straight from the body, no JsonBuffer
+  * Documents: a verify reply, a verify reply with the members a server might add, and
+  * the HeapMonitor telemetry, whose loop histogram the struct doesn't keep.
+  */
+
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#define BENCH_REPEAT 200000
+
+struct VerifyReply {
+    int access;
+    int trainer;
+};
+
+struct Telemetry {
+    unsigned long freeHeap, minFreeHeap;
+    unsigned long maxFreeBlock, minMaxFreeBlock;
+    unsigned char fragmentation, maxFragmentation;
+    unsigned long stackFree, minStackFree;
+    unsigned long samples, loops, loopMaxUs;
+};
+
+static constexpr auto verifyBinding = jsonBinding(
+    jsonField("access", &VerifyReply::access),
+    jsonField("trainer", &VerifyReply::trainer));
+
+static constexpr auto telemetryBinding = jsonBinding(
+    jsonField("freeHeap", &Telemetry::freeHeap),
+    jsonField("minFreeHeap", &Telemetry::minFreeHeap),
+    jsonField("maxFreeBlock", &Telemetry::maxFreeBlock),
+    jsonField("minMaxFreeBlock", &Telemetry::minMaxFreeBlock),
+    jsonField("fragmentation", &Telemetry::fragmentation),
+    jsonField("maxFragmentation", &Telemetry::maxFragmentation),
+    jsonField("stackFree", &Telemetry::stackFree),
+    jsonField("minStackFree", &Telemetry::minStackFree),
+    jsonField("samples", &Telemetry::samples),
+    jsonField("loops", &Telemetry::loops),
+    jsonField("loopMaxUs", &Telemetry::loopMaxUs));
+
+static const char verifyJson[] = "{\"access\":1,\"trainer\":0}";
+
+static const char verifyExtraJson[] =
+    "{\"access\":1,\"trainer\":1,\"name\":\"Member 12\",\"expiry\":\"2017-12-31T23:59:59Z\","
+    "\"roles\":[\"member\",\"trainer\"]}";
+
+static const char telemetryJson[] =
+    "{\"freeHeap\":31240,\"minFreeHeap\":28712,\"maxFreeBlock\":30112,\"minMaxFreeBlock\":"
+    "26004,\"fragmentation\":4,\"maxFragmentation\":11,\"stackFree\":2960,\"minStackFree\":"
+    "2544,\"samples\":600,\"loops\":1184220,\"loopMaxUs\":48210,\"loopHist\":[0,812001,"
+    "361422,9710,1007,64,11,5]}";
+
+static size_t arenaBytes;
+
+static bool fromObject(char *json, VerifyReply &reply)
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &root = jsonBuffer.parseObject(json);
+    if (!root.success()) return false;
+    reply.access = root["access"];
+    reply.trainer = root["trainer"];
+    arenaBytes = jsonBuffer.size();
+    return true;
+}
+
+static bool fromObject(char *json, Telemetry &t)
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &root = jsonBuffer.parseObject(json);
+    if (!root.success()) return false;
+    t.freeHeap = root["freeHeap"];
+    t.minFreeHeap = root["minFreeHeap"];
+    t.maxFreeBlock = root["maxFreeBlock"];
+    t.minMaxFreeBlock = root["minMaxFreeBlock"];
+    t.fragmentation = root["fragmentation"];
+    t.maxFragmentation = root["maxFragmentation"];
+    t.stackFree = root["stackFree"];
+    t.minStackFree = root["minStackFree"];
+    t.samples = root["samples"];
+    t.loops = root["loops"];
+    t.loopMaxUs = root["loopMaxUs"];
+    arenaBytes = jsonBuffer.size();
+    return true;
+}
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+template <typename TStruct, typename TBinding>
+static bool bench(const char *name, const char *json, const TBinding &binding)
+{
+    std::vector<char> copy(strlen(json) + 1);
+    TStruct viaObject, viaBinding;
+    memset(&viaObject, 0, sizeof(viaObject));
+    memset(&viaBinding, 0, sizeof(viaBinding));
+
+    double start = nowUs();
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        memcpy(&copy[0], json, copy.size());
+        if (!fromObject(&copy[0], viaObject)) return false;
+    }
+    double objectNs = (nowUs() - start) * 1000 / BENCH_REPEAT;
+
+    start = nowUs();
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        if (!binding.parse(json, viaBinding)) return false;
+    }
+    double bindingNs = (nowUs() - start) * 1000 / BENCH_REPEAT;
+
+    // both must decode the same
+    if (memcmp(&viaObject, &viaBinding, sizeof(TStruct))) return false;
+
+    printf("%-14s %5u %15.0f %14.0f %8.2fx %12u %13u\n", name, (unsigned)strlen(json), objectNs,
+           bindingNs, objectNs / bindingNs, (unsigned)arenaBytes, 0u);
+    return true;
+}
+
+int main()
+{
+    printf("decode into a struct, ns per decode and JsonBuffer bytes (pointers %u bytes)\n",
+           (unsigned)sizeof(void *));
+    printf("%-14s %5s %15s %14s %9s %12s %13s\n", "document", "body", "parseObject ns",
+           "binding ns", "speedup", "parseObject B", "binding B");
+
+    if (!bench<VerifyReply>("verify", verifyJson, verifyBinding) ||
+        !bench<VerifyReply>("verify+extra", verifyExtraJson, verifyBinding) ||
+        !bench<Telemetry>("telemetry", telemetryJson, telemetryBinding)) {
+        fprintf(stderr, "decodes differ\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+  * Memory used parsing a verify response as the server adds members to it.
+  *
+  * AccessSystem only reads "access" and "trainer". For responses with 0 to 64 extra
+  * members it reports the bytes needed to parse:
+  *   in place - the body copied to a buffer plus the JsonBuffer, as getAccess() used to
+  *   stream - the JsonBuffer when parsing from the socket, every member kept
+  *   filtered - the same with JsonFilter keeping access and trainer only
+  * whether each fits the StaticJsonBuffer<200> getAccess() uses, and the time per parse.
+  * Sizes are for this host's pointers, an ESP8266 needs about half for the nodes.
+  */
+
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define BENCH_STATIC_SIZE 200
+#define BENCH_REPEAT 2000
+
+static const char *accessKeys[] = {"access", "trainer", NULL};
+
+// {"access":1,"trainer":0,...} with extra members of the kinds a server might add
+static std::string verifyResponse(int extra)
+{
+    static const char *kinds[] = {
+        "\"name\":\"Member %d\"",
+        "\"expiry\":\"2017-12-31T23:59:%02dZ\"",
+        "\"roles\":[\"member\",\"trainer\",\"role%d\"]",
+        "\"induction\":{\"by\":\"Member %d\",\"on\":\"2016-05-01\"}"
+    };
+    std::string body = "{\"access\":1,\"trainer\":0";
+    for (int i = 0; i < extra; i++) {
+        char member[128];
+        int n = snprintf(member, sizeof(member), kinds[i % 4], i);
+        // rename repeats so each is a new member
+        std::string text(member, n);
+        if (i >= 4) text.insert(text.find('"', 1), std::to_string(i / 4));
+        body += "," + text;
+    }
+    return body + "}";
+}
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static size_t parseInPlace(const std::string &body)
+{
+    std::vector<char> json(body.begin(), body.end());
+    json.push_back(0);
+    DynamicJsonBuffer jsonBuffer;
+    if (!jsonBuffer.parseObject(&json[0]).success()) return 0;
+    return json.size() + jsonBuffer.size();
+}
+
+static size_t parseStream(const std::string &body, bool filtered)
+{
+    std::istringstream stream(body);
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &root = filtered ? jsonBuffer.parseObject(stream, JsonFilter(accessKeys))
+                                : jsonBuffer.parseObject(stream);
+    if (!root.success() || root["access"] != 1) return 0;
+    return jsonBuffer.size();
+}
+
+static bool fitsStatic(const std::string &body, bool filtered)
+{
+    std::istringstream stream(body);
+    StaticJsonBuffer<BENCH_STATIC_SIZE> jsonBuffer;
+    JsonObject &root = filtered ? jsonBuffer.parseObject(stream, JsonFilter(accessKeys))
+                                : jsonBuffer.parseObject(stream);
+    return root.success();
+}
+
+static double usPerParse(const std::string &body, bool filtered)
+{
+    double start = nowUs();
+    for (int i = 0; i < BENCH_REPEAT; i++) parseStream(body, filtered);
+    return (nowUs() - start) / BENCH_REPEAT;
+}
+
+int main()
+{
+    static const int extras[] = {0, 1, 2, 4, 8, 16, 32, 64};
+
+    printf("verify response with extra members, bytes to parse (pointers %u bytes), "
+           "fits StaticJsonBuffer<%d>, time per parse\n", (unsigned)sizeof(void *),
+           BENCH_STATIC_SIZE);
+    printf("%5s %5s %8s %6s %8s %13s %15s %9s %11s\n", "extra", "body", "in-place", "stream",
+           "filtered", "stream fits", "filtered fits", "stream us", "filtered us");
+
+    for (size_t i = 0; i < sizeof(extras) / sizeof(extras[0]); i++) {
+        std::string body = verifyResponse(extras[i]);
+        size_t inPlace = parseInPlace(body);
+        size_t stream = parseStream(body, false);
+        size_t filtered = parseStream(body, true);
+        if (!inPlace || !stream || !filtered) {
+            fprintf(stderr, "failed to parse %s\n", body.c_str());
+            return 1;
+        }
+        printf("%5d %5u %8u %6u %8u %13s %15s %9.2f %11.2f\n", extras[i],
+               (unsigned)body.size(), (unsigned)inPlace, (unsigned)stream, (unsigned)filtered,
+               fitsStatic(body, false) ? "yes" : "no", fitsStatic(body, true) ? "yes" : "no",
+               usPerParse(body, false), usPerParse(body, true));
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+  * Token lists as JSON and as MessagePack: the same JsonObject both ways.
+  *
+  * For snapshot replies of 10 to 1000 tokens, {"version":<n>,"tokens":{"<hex>":<flags>,...}},
+  * it reports
+  *   the body size of each encoding
+  *   the time to parse it, JSON from a copy parsed in place, MessagePack from the bytes
+  *   the JsonBuffer bytes each parse uses, JSON also needs its copy of the body, the json B
+  *   column, where MessagePack copies the strings into the JsonBuffer
+  *   the time to print the tree in each encoding
+  * Both parses must print the same JSON.
+  */
+
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#define BENCH_WORK 400000   // tokens parsed per measurement, whatever the list size
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// the snapshot the access server sends, with made up tokens as loadGen's
+static void snapshot(int tokens, std::string &json, std::string &msgPack)
+{
+    DynamicJsonBuffer jsonBuffer;
+    std::vector<std::string> keys(tokens);
+    JsonObject &root = jsonBuffer.createObject();
+    root["version"] = 42;
+    JsonObject &list = root.createNestedObject("tokens");
+    for (int i = 0; i < tokens; i++) {
+        char token[16];
+        snprintf(token, sizeof(token), "04f1ee70%06x", i);
+        keys[i] = token;
+        list[keys[i].c_str()] = i % 7 == 0 ? 3 : 1;
+    }
+
+    json.resize(root.measureLength() + 1);
+    root.printTo(&json[0], json.size());
+    json.resize(json.size() - 1);
+
+    msgPack.resize(root.measureMsgPackLength() + 1);
+    root.printMsgPackTo(&msgPack[0], msgPack.size());
+    msgPack.resize(msgPack.size() - 1);
+}
+
+static std::string printed(const JsonObject &root)
+{
+    std::string out(root.measureLength() + 1, '\0');
+    root.printTo(&out[0], out.size());
+    out.resize(out.size() - 1);
+    return out;
+}
+
+static bool bench(int tokens)
+{
+    std::string json, msgPack;
+    snapshot(tokens, json, msgPack);
+    int repeat = BENCH_WORK / tokens;
+    std::vector<char> copy(json.length() + 1);
+    std::vector<char> out(json.length() + 1);
+    size_t jsonArena = 0, msgPackArena = 0;
+    std::string fromJson, fromMsgPack;
+
+    double start = nowUs();
+    for (int i = 0; i < repeat; i++) {
+        memcpy(&copy[0], json.c_str(), copy.size());
+        DynamicJsonBuffer jsonBuffer;
+        JsonObject &root = jsonBuffer.parseObject(&copy[0]);
+        if (!root.success()) return false;
+        jsonArena = jsonBuffer.size();
+        if (i == 0) fromJson = printed(root);
+    }
+    double jsonParseUs = (nowUs() - start) / repeat;
+
+    start = nowUs();
+    for (int i = 0; i < repeat; i++) {
+        DynamicJsonBuffer jsonBuffer;
+        JsonObject &root = jsonBuffer.parseMsgPackObject(
+            reinterpret_cast<const uint8_t *>(msgPack.data()), msgPack.size());
+        if (!root.success()) return false;
+        msgPackArena = jsonBuffer.size();
+        if (i == 0) fromMsgPack = printed(root);
+    }
+    double msgPackParseUs = (nowUs() - start) / repeat;
+
+    if (fromJson != json || fromMsgPack != json) return false;
+
+    // printing, from the same tree
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &root = jsonBuffer.parseMsgPackObject(
+        reinterpret_cast<const uint8_t *>(msgPack.data()), msgPack.size());
+
+    start = nowUs();
+    for (int i = 0; i < repeat; i++) root.printTo(&out[0], out.size());
+    double jsonPrintUs = (nowUs() - start) / repeat;
+
+    start = nowUs();
+    for (int i = 0; i < repeat; i++) root.printMsgPackTo(&out[0], out.size());
+    double msgPackPrintUs = (nowUs() - start) / repeat;
+
+    printf("%6d %8u %8u %5.0f%% %10.1f %10.1f %8u %8u %10.1f %10.1f\n", tokens,
+           (unsigned)json.length(), (unsigned)msgPack.length(), 100.0 * msgPack.length() / json.length(),
+           jsonParseUs, msgPackParseUs, (unsigned)jsonArena, (unsigned)msgPackArena,
+           jsonPrintUs, msgPackPrintUs);
+    return true;
+}
+
+int main()
+{
+    printf("snapshot token lists, JSON against MessagePack, us per parse or print and JsonBuffer bytes\n");
+    printf("%6s %8s %8s %6s %10s %10s %8s %8s %10s %10s\n", "tokens", "json B", "mpack B", "size",
+           "json us", "mpack us", "json JB", "mpack JB", "print us", "mprint us");
+
+    const int sizes[] = {10, 100, 300, 1000};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (!bench(sizes[i])) {
+            fprintf(stderr, "the two encodings parse differently\n");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "FleetServer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+FleetServer::FleetServer(uint32_t serviceUs, uint8_t workers) :
+    requests(0),
+    late(0),
+    serviceUs(serviceUs),
+    listenFd(-1),
+    workerFreeUs(workers > 0 ? workers : 1, 0)
+{ }
+
+uint16_t FleetServer::begin()
+{
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t length = sizeof(addr);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, SOMAXCONN) < 0 ||
+        getsockname(listenFd, (struct sockaddr *)&addr, &length) < 0) {
+        fprintf(stderr, "fleet: can't listen: %s\n", strerror(errno));
+        exit(1);
+    }
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+    return ntohs(addr.sin_port);
+}
+
+void FleetServer::poll(uint64_t nowUs)
+{
+    int fd;
+    while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        Connection c = { fd, std::string() };
+        connections.push_back(c);
+    }
+
+    // a request is complete at the end of its headers, the clients never send a body we need
+    for (size_t i = 0; i < connections.size(); i++) {
+        Connection &c = connections[i];
+        char buffer[512];
+        ssize_t n;
+        while ((n = read(c.fd, buffer, sizeof(buffer))) > 0) c.request.append(buffer, n);
+
+        if (c.request.find("\r\n\r\n") != std::string::npos) {
+            queue(c.fd, c.request, nowUs);
+        } else if (n == 0) {
+            close(c.fd);
+        } else {
+            continue;
+        }
+        connections.erase(connections.begin() + i);
+        i--;
+    }
+
+    for (size_t i = 0; i < answers.size(); i++) {
+        if (answers[i].dueUs <= nowUs) {
+            answer(answers[i], nowUs);
+            answers.erase(answers.begin() + i);
+            i--;
+        }
+    }
+}
+
+uint64_t FleetServer::nextDue() const
+{
+    uint64_t next = UINT64_MAX;
+    for (size_t i = 0; i < answers.size(); i++) {
+        if (answers[i].dueUs < next) next = answers[i].dueUs;
+    }
+    return next;
+}
+
+void FleetServer::queue(int fd, const std::string &request, uint64_t nowUs)
+{
+    requests++;
+
+    // first free worker takes it
+    size_t worker = 0;
+    for (size_t i = 1; i < workerFreeUs.size(); i++) {
+        if (workerFreeUs[i] < workerFreeUs[worker]) worker = i;
+    }
+    uint64_t startUs = workerFreeUs[worker] > nowUs ? workerFreeUs[worker] : nowUs;
+    workerFreeUs[worker] = startUs + serviceUs;
+
+    std::string line = request.substr(0, request.find("\r\n"));
+    Answer a;
+    a.fd = fd;
+    a.verify = line.find("/verify?") != std::string::npos;
+    a.hasToken = line.find("token=") != std::string::npos;
+    a.arrivalUs = nowUs;
+    a.dueUs = workerFreeUs[worker];
+    answers.push_back(a);
+
+    if (a.verify) verifyArrivalUs.push_back(nowUs);
+}
+
+void FleetServer::answer(const Answer &a, uint64_t nowUs)
+{
+    uint32_t latencyUs = (uint32_t)(nowUs - a.arrivalUs);
+    if (a.verify) verifyLatencyUs.push_back(latencyUs);
+    if (latencyUs > FLEET_SERVER_CLIENT_TIMEOUT_MS * 1000UL) late++;
+
+    const char *body = a.hasToken ? "{\"access\":1, \"error\":\"blah\"}"
+                                  : "{\"access\":0, \"error\":\"missing token\"}";
+    char response[256];
+    int n = snprintf(response, sizeof(response),
+                     "HTTP/1.1 200 OK\r\nDate: Thu, 01 Jan 1970 00:00:00 GMT\r\nConnection: close\r\n\r\n%s", body);
+    // the client may have given up and gone, that's counted above
+    ssize_t written = send(a.fd, response, n, MSG_NOSIGNAL);
+    (void)written;
+    close(a.fd);
+}
@@ -0,0 +1,55 @@
+#ifndef FLEET_SERVER_H
+#define FLEET_SERVER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// AccessSystem::getAccess gives up after 3000 polls of 10 ms
+#define FLEET_SERVER_CLIENT_TIMEOUT_MS 30000
+
+/*
+  * in-process stand-in for stub.js, answering in virtual time
+  * every request takes serviceUs of one of the workers, requests queue for a free worker
+  * in arrival order, the answer is the same bytes stub.js sends
+  */
+class FleetServer
+{
+public:
+    FleetServer(uint32_t serviceUs, uint8_t workers);
+
+    uint16_t begin();                // listen on 127.0.0.1, returns the port
+    void poll(uint64_t nowUs);       // accept, read requests, answer those due by nowUs
+    uint64_t nextDue() const;        // time of the next answer, UINT64_MAX if none
+
+    // verify requests, in arrival order
+    std::vector<uint64_t> verifyArrivalUs;
+    std::vector<uint32_t> verifyLatencyUs;
+    uint32_t requests;               // all requests, including log messages
+    uint32_t late;                   // answered after the client had given up
+
+private:
+    struct Connection {
+        int fd;
+        std::string request;
+    };
+
+    struct Answer {
+        int fd;
+        bool verify;
+        bool hasToken;
+        uint64_t arrivalUs;
+        uint64_t dueUs;
+    };
+
+    uint32_t serviceUs;
+    int listenFd;
+    std::vector<uint64_t> workerFreeUs;
+    std::vector<Connection> connections;
+    std::vector<Answer> answers;
+
+    void queue(int fd, const std::string &request, uint64_t nowUs);
+    void answer(const Answer &a, uint64_t nowUs);
+};
+
+#endif
@@ -0,0 +1,345 @@
+/*
+  * Fleet simulator: many machineController token caches against one access server.
+  *
+  * Each device is a TokenCache and AccessSystem running as a coroutine on the HAL's
+  * virtual clock, so they wait on the server concurrently as real devices would. The
+  * server is FleetServer, a stand-in for stub.js with a fixed service time per request.
+  *
+  * Environment, on top of the HAL's (see Hal.h):
+  *   FLEET_DEVICES - number of devices, default 100
+  *   FLEET_RUN_MS - virtual time to simulate, default 7200000, two hours
+  *   FLEET_SERVICE_MS - server time per request, default 20
+  *   FLEET_WORKERS - requests the server handles at once, default 1, as node does
+  *   FLEET_TOKENS - members in the space, default 300
+  *   FLEET_PRELOAD - tokens each device has cached at boot, default 16
+  *   FLEET_SWIPES_PER_HOUR - random swipes per device, default 4
+  *   FLEET_BOOT_SPREAD_MS - devices boot at random times in this window, default 0, a power cut
+  *   FLEET_TRACE - file of "<ms> <device> <hex token>" swipes, replaces the random ones
+  *
+  * Device output is discarded unless HAL_SERIAL_OUT is set. At the end it reports the
+  * verify request rate and herd spikes seen by the server, server latency for every
+  * verify, and swipe latency for the swipes that had to ask the server.
+  */
+
+#include <Arduino.h>
+#include <Hal.h>
+#include <ESP8266WiFi.h>
+#include <EEPROM.h>
+#include <AccessSystem.h>
+#include <TokenCache.h>
+#include <FixedString.h>
+
+#include "FleetServer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+#include <algorithm>
+#include <vector>
+
+#define FLEET_STACK_SIZE 65536
+#define FLEET_DEVICE_TICK_MS 1000   // devices call TokenCache::loop() this often
+#define FLEET_SPIKE_FACTOR 10       // a second with this many times the mean verify rate is a spike
+#define FLEET_SPIKE_MIN 5           // and at least this many requests
+#define FLEET_MAX_BURSTS 10         // spikes listed in the report
+
+struct Swipe {
+    uint64_t atUs;
+    TOKEN token;
+    uint8_t length;
+};
+
+struct Device {
+    char thingId[16];
+    uint32_t chipId;
+    TokenCache *cache;
+    ucontext_t context;
+    std::vector<uint8_t> stack;
+    uint64_t bootUs;
+    uint64_t wakeUs;
+    std::vector<Swipe> trace;   // sorted, from FLEET_TRACE
+    size_t nextTrace;
+    uint64_t nextRandomUs;      // next random swipe, UINT64_MAX with a trace
+};
+
+static uint32_t devices, tokens, preload;
+static uint64_t runUs;
+static double swipeIntervalUs;
+static bool useTrace = false;
+
+static FleetServer *server;
+static std::vector<Device *> fleet;
+static Device *current = NULL;
+static ucontext_t schedulerContext;
+
+static std::vector<uint32_t> swipeLatencyUs;
+static uint32_t swipes = 0;
+
+static uint32_t envNumber(const char *name, uint32_t defaultValue)
+{
+    const char *v = getenv(name);
+    return v != NULL && *v != 0 ? strtoul(v, NULL, 10) : defaultValue;
+}
+
+// member n's token, 7 bytes as most of the space's cards are
+static void memberToken(uint32_t n, TOKEN token)
+{
+    token[0] = 0x04;
+    token[1] = 0xF1;
+    token[2] = 0xEE;
+    token[3] = 0x70;
+    token[4] = n >> 16;
+    token[5] = n >> 8;
+    token[6] = n;
+}
+
+static uint64_t randomInterval()
+{
+    // exponential, for swipes arriving independently
+    double u = (random(1, 1000001)) / 1000000.0;
+    return (uint64_t)(-log(u) * swipeIntervalUs);
+}
+
+static uint64_t nextSwipeUs(const Device &d)
+{
+    if (useTrace) return d.nextTrace < d.trace.size() ? d.trace[d.nextTrace].atUs : UINT64_MAX;
+    return d.nextRandomUs;
+}
+
+static void swipe(Device &d)
+{
+    Swipe s;
+    if (useTrace) {
+        s = d.trace[d.nextTrace++];
+    } else {
+        memberToken(random(tokens), s.token);
+        s.length = 7;
+        d.nextRandomUs += randomInterval();
+    }
+
+    swipes++;
+    bool cached = d.cache->get(&s.token, s.length) != NULL;
+    uint64_t startUs = halNow();
+    d.cache->fetch(&s.token, s.length);
+    if (!cached) swipeLatencyUs.push_back((uint32_t)(halNow() - startUs));
+}
+
+// delay() inside a device hands back to the scheduler until the device's wake time
+static bool deviceDelay(uint64_t us)
+{
+    if (current == NULL) return false;
+    current->wakeUs = halNow() + (us > 0 ? us : 1);
+    swapcontext(&current->context, &schedulerContext);
+    return true;
+}
+
+static void deviceMain()
+{
+    Device &d = *current;
+    d.cache->init();
+
+    for (;;) {
+        while (nextSwipeUs(d) <= halNow()) swipe(d);
+        d.cache->loop();
+
+        uint64_t nowUs = halNow();
+        uint64_t next = std::min(nextSwipeUs(d), nowUs + (uint64_t)FLEET_DEVICE_TICK_MS * 1000);
+        delay((next - nowUs + 999) / 1000);
+    }
+}
+
+static void resume(Device &d)
+{
+    current = &d;
+    halSetBootTime(d.bootUs);
+    halSetChipId(d.chipId);
+    swapcontext(&schedulerContext, &d.context);
+    halSetBootTime(0);
+    current = NULL;
+}
+
+static void readTrace(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "fleet: can't open trace %s\n", path);
+        exit(1);
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        unsigned long ms, device;
+        char hex[32];
+        if (line[0] == '#' || sscanf(line, "%lu %lu %31s", &ms, &device, hex) != 3) continue;
+        if (device >= devices) continue;
+
+        Swipe s;
+        s.atUs = (uint64_t)ms * 1000;
+        memset(s.token, 0, sizeof(TOKEN));
+        s.length = 0;
+        for (size_t i = 0; hex[i] && hex[i + 1] && s.length < sizeof(TOKEN); i += 2) {
+            char byte[3] = { hex[i], hex[i + 1], 0 };
+            s.token[s.length++] = (uint8_t)strtoul(byte, NULL, 16);
+        }
+        fleet[device]->trace.push_back(s);
+    }
+    fclose(f);
+
+    for (size_t i = 0; i < fleet.size(); i++) {
+        std::stable_sort(fleet[i]->trace.begin(), fleet[i]->trace.end(),
+                         [](const Swipe &a, const Swipe &b) { return a.atUs < b.atUs; });
+    }
+}
+
+// every device boots with the same cache, as after a power cut
+static void preloadEEPROM()
+{
+    EEPROM.begin(4096);
+    EEPROM.write(0, EEPROM_MAGIC);
+    EEPROM.write(1, preload);
+    for (uint32_t i = 0; i < preload; i++) {
+        TOKEN_EEPROM_ITEM item;
+        memberToken(i * tokens / preload, item.token);
+        item.length = 7;
+        item.flags = TOKEN_ACCESS;
+        EEPROM.put(2 + i * sizeof(TOKEN_EEPROM_ITEM), item);
+    }
+}
+
+static uint32_t percentile(std::vector<uint32_t> v, uint8_t p)
+{
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, v.size() * p / 100)];
+}
+
+static void printLatency(const char *name, const std::vector<uint32_t> &us)
+{
+    printf("%s: n %u, p50 %u ms, p99 %u ms, max %u ms\n", name, (unsigned)us.size(),
+           percentile(us, 50) / 1000, percentile(us, 99) / 1000, percentile(us, 100) / 1000);
+}
+
+static void report()
+{
+    uint32_t seconds = (uint32_t)(runUs / 1000000);
+    std::vector<uint32_t> perSecond(seconds + 1, 0);
+    for (size_t i = 0; i < server->verifyArrivalUs.size(); i++) {
+        perSecond[server->verifyArrivalUs[i] / 1000000]++;
+    }
+
+    uint32_t verifies = server->verifyArrivalUs.size();
+    double mean = seconds > 0 ? (double)verifies / seconds : 0;
+    uint32_t peakSecond = 0, peakMinute = 0, peakMinuteAt = 0;
+    for (uint32_t s = 0; s < seconds; s++) {
+        if (perSecond[s] > perSecond[peakSecond]) peakSecond = s;
+        uint32_t minute = 0;
+        for (uint32_t j = s; j < s + 60 && j < seconds; j++) minute += perSecond[j];
+        if (minute > peakMinute) {
+            peakMinute = minute;
+            peakMinuteAt = s;
+        }
+    }
+
+    printf("fleet: %u devices, %u s, server %u ms per request, %u worker(s)\n", devices, seconds,
+           envNumber("FLEET_SERVICE_MS", 20), envNumber("FLEET_WORKERS", 1));
+    printf("swipes: %u, asked the server: %u\n", swipes, (unsigned)swipeLatencyUs.size());
+    printf("verify requests: %u, %.1f/min, peak %u in a second at %u s, peak %u in a minute from %u s\n",
+           verifies, mean * 60, perSecond[peakSecond], peakSecond, peakMinute, peakMinuteAt);
+    printLatency("server verify latency", server->verifyLatencyUs);
+    printLatency("swipe latency, cache misses", swipeLatencyUs);
+    printf("answered after the client gave up: %u of %u requests\n", server->late, server->requests);
+
+    // herd spikes, runs of seconds well above the mean rate
+    uint32_t threshold = std::max((uint32_t)FLEET_SPIKE_MIN, (uint32_t)ceil(mean * FLEET_SPIKE_FACTOR));
+    uint32_t bursts = 0;
+    for (uint32_t s = 0; s < seconds; s++) {
+        if (perSecond[s] < threshold) continue;
+        uint32_t start = s, total = 0;
+        while (s < seconds && perSecond[s] >= threshold) total += perSecond[s++];
+        if (++bursts <= FLEET_MAX_BURSTS)
+            printf("herd spike at %u s: %u requests over %u s\n", start, total, s - start);
+    }
+    printf("herd spikes (>= %u verifies/s): %u\n", threshold, bursts);
+    fflush(stdout);
+}
+
+void setup()
+{
+    devices = envNumber("FLEET_DEVICES", 100);
+    runUs = (uint64_t)envNumber("FLEET_RUN_MS", 7200000) * 1000;
+    tokens = std::max(envNumber("FLEET_TOKENS", 300), 1U);
+    preload = std::min(std::min(envNumber("FLEET_PRELOAD", 16), (uint32_t)TOKEN_CACHE_SIZE), tokens);
+    uint32_t swipesPerHour = envNumber("FLEET_SWIPES_PER_HOUR", 4);
+    swipeIntervalUs = swipesPerHour > 0 ? 3600e6 / swipesPerHour : 1e18;
+    uint32_t bootSpreadMs = envNumber("FLEET_BOOT_SPREAD_MS", 0);
+
+    // device chatter is noise here, and the EEPROM is scratch
+    setenv("HAL_SERIAL_OUT", "/dev/null", 0);
+    setenv("HAL_EEPROM", "/dev/null", 0);
+
+    server = new FleetServer(envNumber("FLEET_SERVICE_MS", 20) * 1000, envNumber("FLEET_WORKERS", 1));
+    char port[8];
+    snprintf(port, sizeof(port), "%u", server->begin());
+    setenv("HAL_CONNECT_HOST", "127.0.0.1", 1);
+    setenv("HAL_CONNECT_PORT", port, 1);
+    halSetNetWait(0);
+    halSetDelayHook(deviceDelay);
+
+    WiFi.mode(WIFI_STA);
+    WiFi.begin();
+    preloadEEPROM();
+
+    for (uint32_t i = 0; i < devices; i++) {
+        Device *d = new Device();
+        snprintf(d->thingId, sizeof(d->thingId), "%u", i);
+        d->chipId = 0xA40000 + i;   // one batch of modules
+        d->cache = new TokenCache(AccessSystem(d->thingId));
+        d->stack.resize(FLEET_STACK_SIZE);
+        getcontext(&d->context);
+        d->context.uc_stack.ss_sp = d->stack.data();
+        d->context.uc_stack.ss_size = d->stack.size();
+        d->context.uc_link = NULL;
+        makecontext(&d->context, deviceMain, 0);
+        d->bootUs = bootSpreadMs > 0 ? (uint64_t)random(bootSpreadMs) * 1000 : 0;
+        d->wakeUs = d->bootUs;
+        d->nextTrace = 0;
+        fleet.push_back(d);
+    }
+
+    const char *trace = getenv("FLEET_TRACE");
+    useTrace = trace != NULL && *trace != 0;
+    if (useTrace) {
+        readTrace(trace);
+    }
+    for (size_t i = 0; i < fleet.size(); i++) {
+        // trace times are from the device's boot, like millis()
+        for (size_t j = 0; j < fleet[i]->trace.size(); j++) fleet[i]->trace[j].atUs += fleet[i]->bootUs;
+        fleet[i]->nextRandomUs = useTrace ? UINT64_MAX : fleet[i]->bootUs + randomInterval();
+    }
+}
+
+// runs every device that is due, then skips time to the next thing that happens
+void loop()
+{
+    uint64_t nowUs = halNow();
+    if (nowUs >= runUs) {
+        report();
+        exit(0);
+    }
+
+    // answers due now go out before the devices waiting on them run
+    server->poll(nowUs);
+    uint64_t next = runUs;
+    for (size_t i = 0; i < fleet.size(); i++) {
+        if (fleet[i]->wakeUs <= nowUs) resume(*fleet[i]);
+        next = std::min(next, fleet[i]->wakeUs);
+    }
+    // requests made just now arrive now
+    server->poll(nowUs);
+    next = std::min(next, server->nextDue());
+
+    // the HAL adds a millisecond after loop()
+    if (next > nowUs + 1000) halAdvance(next - nowUs - 1000);
+}
@@ -0,0 +1,44 @@
+#ifndef HAL_ADAFRUIT_NEOPIXEL_H
+#define HAL_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+typedef uint16_t neoPixelType;
+
+#define NEO_RGB     0x06
+#define NEO_GRB     0x52
+#define NEO_KHZ800  0x0000
+#define NEO_KHZ400  0x0100
+
+// pixel buffer only, show() counts frames, HAL_PIXEL_TRACE=1 prints them to stderr
+class Adafruit_NeoPixel
+{
+public:
+    Adafruit_NeoPixel(uint16_t n, uint8_t p = 6, neoPixelType t = NEO_GRB + NEO_KHZ800);
+    ~Adafruit_NeoPixel();
+
+    void begin() { }
+    void show();
+    void setPin(uint8_t p) { pin = p; }
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+    void setPixelColor(uint16_t n, uint32_t c);
+    void setBrightness(uint8_t b) { brightness = b; }
+    void clear();
+    uint32_t getPixelColor(uint16_t n) const { return n < numLEDs ? pixels[n] : 0; }
+    uint8_t getBrightness() const { return brightness; }
+    uint16_t numPixels() const { return numLEDs; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+
+    uint32_t halFrames;
+
+private:
+    uint16_t numLEDs;
+    uint8_t pin;
+    uint8_t brightness;
+    uint32_t *pixels;
+
+    Adafruit_NeoPixel(const Adafruit_NeoPixel &);
+    Adafruit_NeoPixel &operator=(const Adafruit_NeoPixel &);
+};
+
+#endif
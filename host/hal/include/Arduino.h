@@ -0,0 +1,107 @@
+#ifndef HAL_ARDUINO_H
+#define HAL_ARDUINO_H
+
+// Arduino core for the host build, enough for the controller sketches.
+// Time is virtual, see Hal.h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <avr/pgmspace.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PI 3.1415926535897932384626433832795
+
+#ifdef ESP8266
+// NodeMCU pin names, as used by machineController
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define A0 17
+#else
+// ATmega328 analog pins, as used by doorController
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+#endif
+
+#define HAL_PINS 32
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// templates rather than the usual macros, so a sketch can still declare its own min/max
+template <typename T, typename U> inline T min(T a, U b) { return a < (T)b ? a : (T)b; }
+template <typename T, typename U> inline T max(T a, U b) { return a > (T)b ? a : (T)b; }
+
+typedef void (*voidFuncPtr)(void);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t interrupt, voidFuncPtr isr, int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+#include <WString.h>
+#include <Print.h>
+#include <Stream.h>
+#include <HardwareSerial.h>
+
+#ifdef ESP8266
+#include <Esp.h>
+#endif
+
+// the sketch
+void setup();
+void loop();
+
+#endif
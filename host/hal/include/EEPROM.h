@@ -0,0 +1,50 @@
+#ifndef HAL_EEPROM_H
+#define HAL_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HAL_EEPROM_SIZE 4096
+
+/*
+  * EEPROM backed by a file, HAL_EEPROM or <sketch>.eeprom, written through on every change
+  * erased bytes read as 0xFF, as on the chips
+  */
+class EEPROMClass
+{
+public:
+    EEPROMClass();
+
+    void begin(size_t size = 1024);
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value) { write(address, value); }
+    bool commit();
+    void end() { commit(); }
+    uint16_t length() { return (uint16_t)size; }
+
+    template <typename T> T &get(int address, T &t) {
+        load();
+        if (address >= 0 && address + sizeof(T) <= HAL_EEPROM_SIZE) memcpy(&t, data + address, sizeof(T));
+        return t;
+    }
+
+    template <typename T> const T &put(int address, const T &t) {
+        const uint8_t *p = (const uint8_t *)&t;
+        for (size_t i = 0; i < sizeof(T); i++) write(address + (int)i, p[i]);
+        return t;
+    }
+
+private:
+    uint8_t data[HAL_EEPROM_SIZE];
+    size_t size;
+    int fd;
+    bool loaded;
+
+    void load();
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef HAL_ESP8266WIFI_H
+#define HAL_ESP8266WIFI_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <WiFiClient.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+// the host is always on the network unless HAL_WIFI=0, connecting takes no time
+class ESP8266WiFiClass
+{
+public:
+    ESP8266WiFiClass() : wifiMode(WIFI_OFF), started(false) { }
+
+    bool mode(WiFiMode_t m);
+    int begin(const char *ssid, const char *password = NULL);
+    int begin();
+    bool config(IPAddress ip, IPAddress gateway, IPAddress subnet) { (void)ip; (void)gateway; (void)subnet; return true; }
+    bool disconnect(bool wifiOff = false);
+    bool softAPdisconnect(bool wifiOff = false) { (void)wifiOff; return true; }
+    bool setAutoReconnect(bool autoReconnect) { (void)autoReconnect; return true; }
+    wl_status_t status();
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    IPAddress gatewayIP() { return IPAddress(127, 0, 0, 1); }
+    int32_t RSSI() { return -50; }
+
+private:
+    WiFiMode_t wifiMode;
+    bool started;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
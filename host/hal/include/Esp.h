@@ -0,0 +1,21 @@
+#ifndef HAL_ESP_H
+#define HAL_ESP_H
+
+#include <stdint.h>
+
+// heap figures are made up from the process's malloc use against an ESP8266 sized heap
+class EspClass
+{
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxFreeBlockSize();
+    uint8_t getHeapFragmentation();
+    uint32_t getFreeContStack() { return 3000; }
+    uint32_t getChipId();
+    void restart();
+    void reset() { restart(); }
+};
+
+extern EspClass ESP;
+
+#endif
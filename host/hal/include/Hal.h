@@ -0,0 +1,73 @@
+#ifndef HAL_H
+#define HAL_H
+
+/*
+  * Host emulation layer for running the controller sketches on Linux.
+  *
+  * Time is virtual: millis() and micros() only move when the sketch calls delay(),
+  * when a Stream read waits, and by HAL_LOOP_US after every loop(). Set HAL_REALTIME=1
+  * to also sleep, so the sketch runs at wall clock speed against real peripherals.
+  *
+  * Environment:
+  *   HAL_RUN_MS - exit with status 0 after this much virtual time
+  *   HAL_LOOP_US - virtual time taken by each loop(), default 1000
+  *   HAL_REALTIME - 1 to keep virtual time in step with the wall clock
+  *   HAL_EEPROM - file backing EEPROM, default <sketch>.eeprom
+  *   HAL_CONNECT_HOST, HAL_CONNECT_PORT - redirect every WiFiClient connection, e.g. to 127.0.0.1
+  *   HAL_WIFI - 0 to keep WiFi.status() disconnected
+  *   HAL_CHIP_ID - ESP.getChipId(), default 0xC0FFEE
+  *   HAL_CARD_IN - path of lines of hex tokens, each is presented once to the card reader
+  *   HAL_GPIO_IN - path of "<pin> <value>" lines, applied to input pins as they arrive
+  *   HAL_GPIO_TRACE - 1 to print output pin changes to stderr
+  *   HAL_<NAME>_IN, HAL_<NAME>_OUT - serial ports, see HardwareSerial.h
+  *
+  * By default the ESP link goes to stdout and debug output to stderr, on both sides, so
+  * doorController and thingWifi can be joined with a pair of fifos:
+  *   mkfifo door2wifi wifi2door
+  *   HAL_UART_OUT=door2wifi HAL_UART_IN=wifi2door ./doorController &
+  *   HAL_SERIAL_IN=door2wifi HAL_SERIAL_OUT=wifi2door ./thingWifi
+  */
+
+#include <stdint.h>
+
+// advance virtual time, running any tickers that fall due
+void halAdvance(uint64_t us);
+
+// virtual time since the start, whatever the boot time
+uint64_t halNow();
+
+// millis() and micros() count from this virtual time, for a simulated device that booted late
+void halSetBootTime(uint64_t us);
+
+// lets a simulation run several devices on one clock: while set, delay() calls the hook, which
+// returns true if it has waited, or false to advance time as usual
+typedef bool (*halDelayHook)(uint64_t us);
+void halSetDelayHook(halDelayHook hook);
+
+// ESP.getChipId() from now on, for a simulated device
+void halSetChipId(uint32_t id);
+
+// real time WiFiClient::available() waits for a server to answer, default 1 ms, 0 for a
+// server that runs in the same process
+void halSetNetWait(int ms);
+
+// drive an input pin, as if from outside, runs an attached interrupt on a matching edge
+void halSetPin(uint8_t pin, uint8_t value);
+uint8_t halGetPin(uint8_t pin);
+
+// next token from HAL_CARD_IN, false if none waiting
+bool halReadCard(uint8_t *uid, uint8_t *length);
+
+// open a path from the environment for reading or writing, -1 if unset
+int halOpenIn(const char *env);
+int halOpenOut(const char *env, int defaultFd);
+
+// name of the running sketch, from argv[0]
+const char *halSketchName();
+
+// called by Ticker
+typedef void (*halTickerCallback)(void *arg);
+void halAddTicker(void *owner, uint32_t periodUs, bool repeat, halTickerCallback callback, void *arg);
+void halRemoveTicker(void *owner);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef HAL_HARDWARE_SERIAL_H
+#define HAL_HARDWARE_SERIAL_H
+
+#include <Stream.h>
+
+#define SERIAL_8N1 0x06
+#define SERIAL_6N1 0x02
+#define SERIAL_FULL    0
+#define SERIAL_TX_ONLY 2
+
+/*
+  * a serial port on the host, backed by files or pipes named in the environment
+  *   HAL_<NAME>_IN - path read from, e.g. a fifo from another sketch, unset for no input
+  *   HAL_<NAME>_OUT - path written to, "-" for stdout, unset for the default
+  * NAME is SERIAL, SERIAL1, UART (doorController's RingUart) or SOFTSERIAL
+  */
+class HardwareSerial : public Stream
+{
+public:
+    HardwareSerial(const char *name, int defaultOut);
+
+    void begin(unsigned long baud);
+    void begin(unsigned long baud, int config, int mode = SERIAL_FULL);
+    void end() { }
+    void setDebugOutput(bool enable) { (void)enable; }
+
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+    void flush() { }
+
+    operator bool() const { return true; }
+
+private:
+    const char *name;
+    int inFd;
+    int outFd;
+    int peeked;
+    bool opened;
+
+    void open();
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef HAL_IPADDRESS_H
+#define HAL_IPADDRESS_H
+
+#include <Printable.h>
+#include <stdint.h>
+
+class IPAddress : public Printable
+{
+public:
+    IPAddress() { bytes[0] = bytes[1] = bytes[2] = bytes[3] = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { bytes[0] = a; bytes[1] = b; bytes[2] = c; bytes[3] = d; }
+
+    uint8_t operator[](int i) const { return bytes[i]; }
+    uint8_t &operator[](int i) { return bytes[i]; }
+    size_t printTo(Print &p) const;
+
+private:
+    uint8_t bytes[4];
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef HAL_PN532_H
+#define HAL_PN532_H
+
+#include <Arduino.h>
+#include <PN532_I2C.h>
+
+#define PN532_MIFARE_ISO14443A 0x00
+
+// a PN532 that reads the tokens from HAL_CARD_IN
+class PN532
+{
+public:
+    PN532(PN532_I2C &interface) { (void)interface; }
+
+    void begin() { }
+    bool SAMConfig() { return true; }
+    uint32_t getFirmwareVersion() { return 0x32010607; }
+    uint16_t getGeneralStatus() { return 0; }
+    bool setPassiveActivationRetries(uint8_t maxRetries) { (void)maxRetries; return true; }
+    bool readPassiveTargetID(uint8_t cardbaudrate, uint8_t *uid, uint8_t *uidLength, uint16_t timeout = 1000);
+};
+
+#endif
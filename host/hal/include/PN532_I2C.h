@@ -0,0 +1,12 @@
+#ifndef HAL_PN532_I2C_H
+#define HAL_PN532_I2C_H
+
+#include <Wire.h>
+
+class PN532_I2C
+{
+public:
+    PN532_I2C(TwoWire &wire, uint8_t sdaPin, uint8_t clkPin) { (void)wire; (void)sdaPin; (void)clkPin; }
+};
+
+#endif
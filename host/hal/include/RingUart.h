@@ -0,0 +1,18 @@
+#ifndef HAL_RING_UART_H
+#define HAL_RING_UART_H
+
+#include <Arduino.h>
+
+// doorController's ESP link, a HardwareSerial named UART
+class RingUart : public HardwareSerial
+{
+public:
+    RingUart() : HardwareSerial("UART", 1), rxOverruns(0), rxErrors(0) { }
+
+    uint16_t rxOverruns;
+    uint16_t rxErrors;
+};
+
+extern RingUart Uart;
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef HAL_SPI_H
+#define HAL_SPI_H
+
+#include <Arduino.h>
+
+// nothing on the bus, the MFRC522 is emulated above it
+class SPIClass
+{
+public:
+    void begin() { }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef HAL_SOFTWARESERIAL_H
+#define HAL_SOFTWARESERIAL_H
+
+#include <Arduino.h>
+
+// a HardwareSerial named SOFTSERIAL, stderr by default
+class SoftwareSerial : public HardwareSerial
+{
+public:
+    SoftwareSerial(uint8_t rx, uint8_t tx, bool inverse = false);
+
+    bool listen() { return true; }
+    bool stopListening() { return true; }
+    bool isListening() { return false; }
+};
+
+#endif
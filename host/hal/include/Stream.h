@@ -0,0 +1,33 @@
+#ifndef HAL_STREAM_H
+#define HAL_STREAM_H
+
+#include <Print.h>
+
+class Stream : public Print
+{
+public:
+    Stream() : timeout(1000) { }
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long ms) { timeout = ms; }
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length);
+    size_t readBytesUntil(char terminator, uint8_t *buffer, size_t length) { return readBytesUntil(terminator, (char *)buffer, length); }
+    String readString();
+    String readStringUntil(char terminator);
+    bool find(const char *target);
+    long parseInt();
+
+protected:
+    unsigned long timeout;
+
+    // waits in virtual time for a byte, -1 on timeout
+    int timedRead();
+    int timedPeek();
+};
+
+#endif
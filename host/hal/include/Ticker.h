@@ -0,0 +1,23 @@
+#ifndef HAL_TICKER_H
+#define HAL_TICKER_H
+
+#include <Hal.h>
+
+// ESP8266 Ticker, callbacks run from virtual time, between the sketch's own code
+class Ticker
+{
+public:
+    typedef void (*callback_t)(void);
+
+    ~Ticker() { detach(); }
+
+    void attach(float seconds, callback_t callback) { attach_ms((uint32_t)(seconds * 1000), callback); }
+    void attach_ms(uint32_t ms, callback_t callback) { halAddTicker(this, ms * 1000, true, run, (void *)callback); }
+    void once_ms(uint32_t ms, callback_t callback) { halAddTicker(this, ms * 1000, false, run, (void *)callback); }
+    void detach() { halRemoveTicker(this); }
+
+private:
+    static void run(void *arg) { ((callback_t)arg)(); }
+};
+
+#endif
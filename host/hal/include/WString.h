@@ -0,0 +1,81 @@
+#ifndef HAL_WSTRING_H
+#define HAL_WSTRING_H
+
+#include <stddef.h>
+#include <string>
+
+class __FlashStringHelper;
+
+// Arduino String over std::string
+class String
+{
+public:
+    String(const char *str = "");
+    String(const String &str);
+    String(const __FlashStringHelper *str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(double value, unsigned char decimals = 2);
+
+    String &operator=(const String &rhs);
+    String &operator=(const char *rhs);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return (unsigned int)s.length(); }
+    const char *c_str() const { return s.c_str(); }
+
+    bool concat(const String &str);
+    bool concat(const char *str);
+    bool concat(char c);
+    bool concat(unsigned char value);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(double value);
+
+    template <typename T> String &operator+=(const T &rhs) { concat(rhs); return *this; }
+
+    bool operator==(const String &rhs) const { return s == rhs.s; }
+    bool operator==(const char *rhs) const { return s == rhs; }
+    bool operator!=(const String &rhs) const { return s != rhs.s; }
+    bool operator!=(const char *rhs) const { return s != rhs; }
+    bool operator<(const String &rhs) const { return s < rhs.s; }
+    bool equals(const String &rhs) const { return s == rhs.s; }
+
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index);
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    bool startsWith(const String &prefix) const;
+    bool endsWith(const String &suffix) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    long toInt() const;
+    double toFloat() const;
+
+private:
+    std::string s;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+String operator+(const String &lhs, int rhs);
+String operator+(const String &lhs, unsigned int rhs);
+String operator+(const String &lhs, long rhs);
+String operator+(const String &lhs, unsigned long rhs);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef HAL_WIFICLIENT_H
+#define HAL_WIFICLIENT_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+/*
+  * TCP client over a POSIX socket, connects are blocking like the ESP8266's
+  * HAL_CONNECT_HOST and HAL_CONNECT_PORT override the address, so a sketch built
+  * for the space's server can talk to a local stand-in
+  */
+class WiFiClient : public Stream
+{
+public:
+    WiFiClient();
+    ~WiFiClient();
+
+    int connect(const char *host, uint16_t port);
+    int connect(IPAddress ip, uint16_t port);
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+    int available();
+    int read();
+    int read(uint8_t *buffer, size_t size);
+    int peek();
+    void flush() { }
+    void stop();
+    uint8_t connected();
+    operator bool() { return connected(); }
+
+private:
+    int fd;
+    bool closed;    // peer closed, anything left is still in the socket buffer
+
+    // not copyable, the socket belongs to one client
+    WiFiClient(const WiFiClient &);
+    WiFiClient &operator=(const WiFiClient &);
+};
+
+#endif
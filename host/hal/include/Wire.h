@@ -0,0 +1,16 @@
+#ifndef HAL_WIRE_H
+#define HAL_WIRE_H
+
+#include <Arduino.h>
+
+// nothing on the bus, the PN532 is emulated above it
+class TwoWire
+{
+public:
+    void begin() { }
+    void begin(int sda, int scl) { (void)sda; (void)scl; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1 @@
+#include <avr/pgmspace.h>
@@ -0,0 +1,72 @@
+#include <Arduino.h>
+#include <Hal.h>
+#include <PN532.h>
+#include <MFRC522.h>
+#include <Adafruit_NeoPixel.h>
+#include <Wire.h>
+#include <SPI.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+TwoWire Wire;
+SPIClass SPI;
+
+bool PN532::readPassiveTargetID(uint8_t cardbaudrate, uint8_t *uid, uint8_t *uidLength, uint16_t timeout)
+{
+    (void)cardbaudrate;
+    (void)timeout;
+    return halReadCard(uid, uidLength);
+}
+
+bool MFRC522::PICC_IsNewCardPresent()
+{
+    uid.size = 0;
+    return halReadCard(uid.uidByte, &uid.size);
+}
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, uint8_t p, neoPixelType t) :
+    halFrames(0),
+    numLEDs(n),
+    pin(p),
+    brightness(0),
+    pixels(new uint32_t[n]())
+{
+    (void)t;
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel()
+{
+    delete[] pixels;
+}
+
+void Adafruit_NeoPixel::show()
+{
+    halFrames++;
+
+    static int trace = -1;
+    if (trace < 0) {
+        const char *env = getenv("HAL_PIXEL_TRACE");
+        trace = env != NULL && strcmp(env, "1") == 0;
+    }
+    if (!trace) return;
+
+    fprintf(stderr, "%lu pixels", millis());
+    for (uint16_t i = 0; i < numLEDs; i++) fprintf(stderr, " %06x", pixels[i]);
+    fprintf(stderr, "\n");
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+{
+    setPixelColor(n, Color(r, g, b));
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c)
+{
+    if (n < numLEDs) pixels[n] = c;
+}
+
+void Adafruit_NeoPixel::clear()
+{
+    for (uint16_t i = 0; i < numLEDs; i++) pixels[i] = 0;
+}
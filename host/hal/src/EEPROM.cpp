@@ -0,0 +1,66 @@
+#include <EEPROM.h>
+#include <Hal.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass() :
+    size(HAL_EEPROM_SIZE),
+    fd(-1),
+    loaded(false)
+{ }
+
+void EEPROMClass::load()
+{
+    if (loaded) return;
+    loaded = true;
+    memset(data, 0xFF, sizeof(data));
+
+    char path[256];
+    const char *env = getenv("HAL_EEPROM");
+    if (env != NULL && *env != 0)
+        snprintf(path, sizeof(path), "%s", env);
+    else
+        snprintf(path, sizeof(path), "%s.eeprom", halSketchName());
+
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "hal: can't open EEPROM file %s: %s\n", path, strerror(errno));
+        return;
+    }
+    ssize_t n = pread(fd, data, sizeof(data), 0);
+    (void)n;
+}
+
+void EEPROMClass::begin(size_t size)
+{
+    load();
+    this->size = size < HAL_EEPROM_SIZE ? size : HAL_EEPROM_SIZE;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+    load();
+    if (address < 0 || address >= HAL_EEPROM_SIZE) return 0xFF;
+    return data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    load();
+    if (address < 0 || address >= HAL_EEPROM_SIZE) return;
+    if (data[address] == value) return;
+    data[address] = value;
+    if (fd >= 0 && pwrite(fd, &value, 1, address) != 1)
+        fprintf(stderr, "hal: EEPROM write failed: %s\n", strerror(errno));
+}
+
+bool EEPROMClass::commit()
+{
+    return true;
+}
@@ -0,0 +1,377 @@
+// virtual time, GPIO, watchdog, tickers and main() for the host build
+
+#include <Arduino.h>
+#include <Hal.h>
+#include <avr/wdt.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+static uint64_t nowUs = 0;
+static uint64_t bootUs = 0;     // millis() and micros() count from here
+static halDelayHook delayHook = NULL;
+static uint64_t runUs = 0;      // 0 runs forever
+static uint64_t loopUs = 1000;
+static bool realtime = false;
+static uint64_t wallStartUs = 0;
+static const char *sketchName = "sketch";
+
+static uint8_t pinModes[HAL_PINS];
+static uint8_t pinValues[HAL_PINS];
+static bool gpioTrace = false;
+
+struct Interrupt {
+    voidFuncPtr isr;
+    int mode;
+};
+static Interrupt interrupts_[HAL_PINS];
+static bool interruptsEnabled = true;
+
+static uint64_t wdtTimeoutUs = 0;   // 0 when disabled
+static uint64_t wdtLastResetUs = 0;
+
+struct HalTicker {
+    void *owner;
+    uint64_t periodUs;
+    uint64_t dueUs;
+    bool repeat;
+    halTickerCallback callback;
+    void *arg;
+};
+static std::vector<HalTicker> tickers;
+static bool inTicker = false;
+
+static int gpioInFd = -1;
+static int cardInFd = -1;
+
+static uint64_t wallClockUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t envNumber(const char *name, uint64_t defaultValue)
+{
+    const char *v = getenv(name);
+    return v != NULL && *v != 0 ? strtoull(v, NULL, 10) : defaultValue;
+}
+
+int halOpenIn(const char *env)
+{
+    const char *path = getenv(env);
+    if (path == NULL || *path == 0) return -1;
+    if (strcmp(path, "-") == 0) {
+        fcntl(0, F_SETFL, fcntl(0, F_GETFL) | O_NONBLOCK);
+        return 0;
+    }
+    // read-write so opening a fifo doesn't wait for a writer, or see EOF when one leaves
+    int fd = open(path, O_RDWR | O_NONBLOCK);
+    if (fd < 0) fd = open(path, O_RDONLY | O_NONBLOCK);
+    if (fd < 0) {
+        fprintf(stderr, "hal: can't open %s=%s: %s\n", env, path, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+int halOpenOut(const char *env, int defaultFd)
+{
+    const char *path = getenv(env);
+    if (path == NULL || *path == 0) return defaultFd;
+    if (strcmp(path, "-") == 0) return 1;
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "hal: can't open %s=%s: %s\n", env, path, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+const char *halSketchName()
+{
+    return sketchName;
+}
+
+// a line from a non-blocking fd, false if no complete line is waiting
+static bool readLine(int fd, char *line, size_t size)
+{
+    static char buffers[2][256];
+    static size_t lengths[2];
+    int slot = fd == gpioInFd ? 0 : 1;
+    char *buffer = buffers[slot];
+    size_t &length = lengths[slot];
+
+    for (;;) {
+        char *end = (char *)memchr(buffer, '\n', length);
+        if (end != NULL) {
+            size_t n = end - buffer;
+            if (n >= size) n = size - 1;
+            memcpy(line, buffer, n);
+            line[n] = 0;
+            length -= end + 1 - buffer;
+            memmove(buffer, end + 1, length);
+            return true;
+        }
+        if (length == sizeof(buffers[0])) length = 0;   // overlong line, drop it
+        ssize_t r = ::read(fd, buffer + length, sizeof(buffers[0]) - length);
+        if (r <= 0) return false;
+        length += r;
+    }
+}
+
+static void pollInputs()
+{
+    char line[64];
+    while (gpioInFd >= 0 && readLine(gpioInFd, line, sizeof(line))) {
+        unsigned pin, value;
+        if (sscanf(line, "%u %u", &pin, &value) == 2 && pin < HAL_PINS) {
+            halSetPin(pin, value ? HIGH : LOW);
+        }
+    }
+}
+
+bool halReadCard(uint8_t *uid, uint8_t *length)
+{
+    char line[64];
+    if (cardInFd < 0 || !readLine(cardInFd, line, sizeof(line))) return false;
+
+    uint8_t n = 0;
+    for (char *p = line; p[0] != 0 && p[1] != 0 && n < 7; p += 2) {
+        unsigned b;
+        if (sscanf(p, "%2x", &b) != 1) break;
+        uid[n++] = b;
+    }
+    *length = n;
+    return n == 4 || n == 7;
+}
+
+void halAdvance(uint64_t us)
+{
+    nowUs += us;
+
+    if (realtime) {
+        uint64_t wall = wallClockUs() - wallStartUs;
+        if (nowUs > wall) usleep(nowUs - wall);
+    }
+
+    if (wdtTimeoutUs != 0 && nowUs - wdtLastResetUs > wdtTimeoutUs) {
+        fprintf(stderr, "hal: watchdog reset at %llums, %llums since the last wdt_reset()\n",
+                (unsigned long long)(nowUs / 1000), (unsigned long long)((nowUs - wdtLastResetUs) / 1000));
+        exit(2);
+    }
+
+    // also from inside delay(), so a sketch stuck in setup() still stops
+    if (runUs != 0 && nowUs >= runUs) {
+        fflush(stdout);
+        exit(0);
+    }
+
+    // tickers run from here, as the ESP8266 runs them between the sketch's code
+    if (!inTicker) {
+        inTicker = true;
+        for (size_t i = 0; i < tickers.size(); i++) {
+            if (nowUs >= tickers[i].dueUs) {
+                HalTicker t = tickers[i];
+                if (t.repeat) {
+                    tickers[i].dueUs += t.periodUs;
+                    if (tickers[i].dueUs <= nowUs) tickers[i].dueUs = nowUs + t.periodUs;
+                } else {
+                    tickers.erase(tickers.begin() + i);
+                    i--;
+                }
+                t.callback(t.arg);
+            }
+        }
+        inTicker = false;
+    }
+}
+
+void halAddTicker(void *owner, uint32_t periodUs, bool repeat, halTickerCallback callback, void *arg)
+{
+    halRemoveTicker(owner);
+    HalTicker t = { owner, periodUs, nowUs + periodUs, repeat, callback, arg };
+    tickers.push_back(t);
+}
+
+void halRemoveTicker(void *owner)
+{
+    for (size_t i = 0; i < tickers.size(); i++) {
+        if (tickers[i].owner == owner) {
+            tickers.erase(tickers.begin() + i);
+            return;
+        }
+    }
+}
+
+uint64_t halNow()
+{
+    return nowUs;
+}
+
+void halSetBootTime(uint64_t us)
+{
+    bootUs = us;
+}
+
+void halSetDelayHook(halDelayHook hook)
+{
+    delayHook = hook;
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(uint32_t)((nowUs - bootUs) / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)(uint32_t)(nowUs - bootUs);
+}
+
+void delay(unsigned long ms)
+{
+    if (delayHook != NULL && delayHook((uint64_t)ms * 1000)) return;
+    halAdvance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    if (delayHook != NULL && delayHook(us)) return;
+    halAdvance(us);
+}
+
+void yield()
+{
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= HAL_PINS) return;
+    pinModes[pin] = mode;
+    if (mode == INPUT_PULLUP) pinValues[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= HAL_PINS) return;
+    value = value ? HIGH : LOW;
+    if (gpioTrace && pinModes[pin] == OUTPUT && pinValues[pin] != value) {
+        fprintf(stderr, "hal: %lums pin %u = %u\n", millis(), pin, value);
+    }
+    pinValues[pin] = value;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < HAL_PINS ? pinValues[pin] : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+    return pin < HAL_PINS && pinValues[pin] ? 1023 : 0;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    digitalWrite(pin, value > 127);
+}
+
+void halSetPin(uint8_t pin, uint8_t value)
+{
+    if (pin >= HAL_PINS) return;
+    uint8_t old = pinValues[pin];
+    pinValues[pin] = value;
+
+    Interrupt &i = interrupts_[pin];
+    if (i.isr != NULL && interruptsEnabled && old != value &&
+        (i.mode == CHANGE || (i.mode == RISING && value) || (i.mode == FALLING && !value))) {
+        i.isr();
+    }
+}
+
+uint8_t halGetPin(uint8_t pin)
+{
+    return pin < HAL_PINS ? pinValues[pin] : LOW;
+}
+
+void attachInterrupt(uint8_t interrupt, voidFuncPtr isr, int mode)
+{
+    if (interrupt >= HAL_PINS) return;
+    interrupts_[interrupt].isr = isr;
+    interrupts_[interrupt].mode = mode;
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+    if (interrupt < HAL_PINS) interrupts_[interrupt].isr = NULL;
+}
+
+void noInterrupts()
+{
+    interruptsEnabled = false;
+}
+
+void interrupts()
+{
+    interruptsEnabled = true;
+}
+
+long random(long max)
+{
+    return max > 0 ? ::random() % max : 0;
+}
+
+long random(long min, long max)
+{
+    return max > min ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed)
+{
+    srandom(seed);
+}
+
+void wdt_enable(unsigned char timeout)
+{
+    static const uint16_t timeoutMs[] = { 15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000 };
+    wdtTimeoutUs = (uint64_t)timeoutMs[timeout < 10 ? timeout : 9] * 1000;
+    wdtLastResetUs = nowUs;
+}
+
+void wdt_disable()
+{
+    wdtTimeoutUs = 0;
+}
+
+void wdt_reset()
+{
+    wdtLastResetUs = nowUs;
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    const char *slash = strrchr(argv[0], '/');
+    sketchName = slash != NULL ? slash + 1 : argv[0];
+
+    runUs = envNumber("HAL_RUN_MS", 0) * 1000;
+    loopUs = envNumber("HAL_LOOP_US", 1000);
+    realtime = envNumber("HAL_REALTIME", 0) != 0;
+    gpioTrace = envNumber("HAL_GPIO_TRACE", 0) != 0;
+    gpioInFd = halOpenIn("HAL_GPIO_IN");
+    cardInFd = halOpenIn("HAL_CARD_IN");
+    wallStartUs = wallClockUs();
+    srandom(1);
+
+    setup();
+    for (;;) {
+        loop();
+        pollInputs();
+        halAdvance(loopUs);
+    }
+}
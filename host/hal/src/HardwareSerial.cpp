@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include <Hal.h>
+#include <SoftwareSerial.h>
+#include <RingUart.h>
+
+#include <unistd.h>
+
+HardwareSerial Serial("SERIAL", 1);
+HardwareSerial Serial1("SERIAL1", 2);
+
+HardwareSerial::HardwareSerial(const char *name, int defaultOut) :
+    name(name),
+    inFd(-1),
+    outFd(defaultOut),
+    peeked(-1),
+    opened(false)
+{ }
+
+void HardwareSerial::open()
+{
+    if (opened) return;
+    opened = true;
+
+    char env[32];
+    snprintf(env, sizeof(env), "HAL_%s_IN", name);
+    inFd = halOpenIn(env);
+    snprintf(env, sizeof(env), "HAL_%s_OUT", name);
+    outFd = halOpenOut(env, outFd);
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    (void)baud;
+    open();
+}
+
+void HardwareSerial::begin(unsigned long baud, int config, int mode)
+{
+    (void)config;
+    (void)mode;
+    begin(baud);
+}
+
+int HardwareSerial::available()
+{
+    if (peek() < 0) return 0;
+    return 1;
+}
+
+int HardwareSerial::read()
+{
+    int c = peek();
+    peeked = -1;
+    return c;
+}
+
+int HardwareSerial::peek()
+{
+    open();
+    if (peeked < 0 && inFd >= 0) {
+        uint8_t c;
+        if (::read(inFd, &c, 1) == 1) peeked = c;
+    }
+    return peeked;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    open();
+    if (outFd < 0) return size;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::write(outFd, buffer + done, size - done);
+        if (n <= 0) break;
+        done += n;
+    }
+    return size;
+}
+
+SoftwareSerial::SoftwareSerial(uint8_t rx, uint8_t tx, bool inverse) :
+    HardwareSerial("SOFTSERIAL", 2)
+{
+    (void)rx;
+    (void)tx;
+    (void)inverse;
+}
+
+RingUart Uart;
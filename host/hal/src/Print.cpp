@@ -0,0 +1,168 @@
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#include <stdarg.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) { return write(reinterpret_cast<const char *>(str)); }
+size_t Print::print(const String &str) { return write(str.c_str()); }
+size_t Print::print(const char *str) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) { return print((unsigned long)value, base); }
+size_t Print::print(int value, int base) { return print((long)value, base); }
+size_t Print::print(unsigned int value, int base) { return print((unsigned long)value, base); }
+size_t Print::print(unsigned long value, int base) { return printNumber(value, base); }
+size_t Print::print(unsigned long long value, int base) { return printNumber(value, base); }
+size_t Print::print(long value, int base) { return print((long long)value, base); }
+
+size_t Print::print(long long value, int base)
+{
+    if (base == 0) return write((uint8_t)value);
+    if (base == 10 && value < 0) {
+        size_t n = write('-');
+        return n + printNumber(-(unsigned long long)value, 10);
+    }
+    return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return write(buffer);
+}
+
+size_t Print::print(const Printable &p)
+{
+    return p.printTo(*this);
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+int Print::printf(const char *format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    write(buffer);
+    return n;
+}
+
+size_t Print::printNumber(unsigned long long value, int base)
+{
+    return write(String((unsigned long)value, (unsigned char)base).c_str());
+}
+
+int Stream::timedRead()
+{
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        delay(1);
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+int Stream::timedPeek()
+{
+    unsigned long start = millis();
+    do {
+        int c = peek();
+        if (c >= 0) return c;
+        delay(1);
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t n = 0;
+    while (n < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        buffer[n++] = (char)c;
+    }
+    return n;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+    size_t n = 0;
+    while (n < length) {
+        int c = timedRead();
+        if (c < 0 || c == terminator) break;
+        buffer[n++] = (char)c;
+    }
+    return n;
+}
+
+String Stream::readString()
+{
+    String s;
+    int c;
+    while ((c = timedRead()) >= 0) s += (char)c;
+    return s;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String s;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) s += (char)c;
+    return s;
+}
+
+bool Stream::find(const char *target)
+{
+    size_t matched = 0, length = strlen(target);
+    if (length == 0) return true;
+    int c;
+    while ((c = timedRead()) >= 0) {
+        if (c == target[matched]) {
+            if (++matched == length) return true;
+        } else {
+            matched = c == target[0] ? 1 : 0;
+        }
+    }
+    return false;
+}
+
+long Stream::parseInt()
+{
+    int c;
+    while ((c = timedPeek()) >= 0 && c != '-' && (c < '0' || c > '9')) read();
+
+    bool negative = false;
+    long value = 0;
+    if (c == '-') {
+        negative = true;
+        read();
+    }
+    while ((c = timedPeek()) >= '0' && c <= '9') {
+        value = value * 10 + c - '0';
+        read();
+    }
+    return negative ? -value : value;
+}
+
+size_t IPAddress::printTo(Print &p) const
+{
+    size_t n = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i > 0) n += p.print('.');
+        n += p.print(bytes[i], DEC);
+    }
+    return n;
+}
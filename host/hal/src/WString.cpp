@@ -0,0 +1,159 @@
+#include <Arduino.h>
+
+#include <ctype.h>
+
+static std::string number(unsigned long long value, unsigned char base, bool negative)
+{
+    if (base < 2 || base > 36) base = 10;
+    char buffer[72];
+    char *p = buffer + sizeof(buffer) - 1;
+    *p = 0;
+    do {
+        unsigned digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value);
+    if (negative) *--p = '-';
+    return p;
+}
+
+static std::string signedNumber(long long value, unsigned char base)
+{
+    // only base 10 is signed, as on Arduino
+    if (base == 10 && value < 0) return number(-(unsigned long long)value, base, true);
+    return number((unsigned long)value, base, false);
+}
+
+String::String(const char *str) : s(str != NULL ? str : "") { }
+String::String(const String &str) : s(str.s) { }
+String::String(const __FlashStringHelper *str) : s(reinterpret_cast<const char *>(str)) { }
+String::String(char c) : s(1, c) { }
+String::String(unsigned char value, unsigned char base) : s(number(value, base, false)) { }
+String::String(int value, unsigned char base) : s(signedNumber(value, base)) { }
+String::String(unsigned int value, unsigned char base) : s(number(value, base, false)) { }
+String::String(long value, unsigned char base) : s(signedNumber(value, base)) { }
+String::String(unsigned long value, unsigned char base) : s(number(value, base, false)) { }
+
+String::String(double value, unsigned char decimals)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    s = buffer;
+}
+
+String &String::operator=(const String &rhs) { s = rhs.s; return *this; }
+String &String::operator=(const char *rhs) { s = rhs != NULL ? rhs : ""; return *this; }
+
+bool String::reserve(unsigned int size) { s.reserve(size); return true; }
+
+bool String::concat(const String &str) { s += str.s; return true; }
+bool String::concat(const char *str) { if (str != NULL) s += str; return true; }
+bool String::concat(char c) { s += c; return true; }
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+char String::charAt(unsigned int index) const
+{
+    return index < s.length() ? s[index] : 0;
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if (index >= s.length()) {
+        dummy = 0;
+        return dummy;
+    }
+    return s[index];
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t i = s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::indexOf(const String &str, unsigned int from) const
+{
+    size_t i = s.find(str.s, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::lastIndexOf(char c) const
+{
+    size_t i = s.rfind(c);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+bool String::startsWith(const String &prefix) const
+{
+    return s.compare(0, prefix.s.length(), prefix.s) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return s.length() >= suffix.s.length() &&
+           s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+}
+
+String String::substring(unsigned int from) const
+{
+    return substring(from, length());
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to) { unsigned int t = from; from = to; to = t; }
+    if (from >= s.length()) return String();
+    if (to > s.length()) to = length();
+    return String(s.substr(from, to - from).c_str());
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if (find.s.empty()) return;
+    size_t i = 0;
+    while ((i = s.find(find.s, i)) != std::string::npos) {
+        s.replace(i, find.s.length(), replace.s);
+        i += replace.s.length();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < s.length()) s.erase(index, count);
+}
+
+void String::toLowerCase()
+{
+    for (size_t i = 0; i < s.length(); i++) s[i] = tolower((unsigned char)s[i]);
+}
+
+void String::toUpperCase()
+{
+    for (size_t i = 0; i < s.length(); i++) s[i] = toupper((unsigned char)s[i]);
+}
+
+void String::trim()
+{
+    size_t start = 0, end = s.length();
+    while (start < end && isspace((unsigned char)s[start])) start++;
+    while (end > start && isspace((unsigned char)s[end - 1])) end--;
+    s = s.substr(start, end - start);
+}
+
+long String::toInt() const { return atol(s.c_str()); }
+double String::toFloat() const { return atof(s.c_str()); }
+
+String operator+(const String &lhs, const String &rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String &lhs, const char *rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const char *lhs, const String &rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String &lhs, char rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String &lhs, int rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String &lhs, unsigned int rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String &lhs, long rhs) { String r(lhs); r.concat(rhs); return r; }
+String operator+(const String &lhs, unsigned long rhs) { String r(lhs); r.concat(rhs); return r; }
@@ -0,0 +1,245 @@
+#include <ESP8266WiFi.h>
+#include <ESP8266Ping.h>
+#include <Esp.h>
+#include <Hal.h>
+
+#include <errno.h>
+#include <malloc.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// an ESP8266 sketch starts with about this much heap
+#define HAL_HEAP_SIZE 40000
+
+static int netWaitMs = 1;
+static uint32_t chipId = 0;     // 0 until set or read from HAL_CHIP_ID
+
+ESP8266WiFiClass WiFi;
+PingClass Ping;
+EspClass ESP;
+
+void halSetNetWait(int ms)
+{
+    netWaitMs = ms;
+}
+
+static bool wifiEnabled()
+{
+    const char *env = getenv("HAL_WIFI");
+    return env == NULL || strcmp(env, "0") != 0;
+}
+
+bool ESP8266WiFiClass::mode(WiFiMode_t m)
+{
+    wifiMode = m;
+    return true;
+}
+
+int ESP8266WiFiClass::begin(const char *ssid, const char *password)
+{
+    (void)ssid;
+    (void)password;
+    started = true;
+    return status();
+}
+
+int ESP8266WiFiClass::begin()
+{
+    started = true;
+    return status();
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff)
+{
+    if (wifiOff) wifiMode = WIFI_OFF;
+    started = false;
+    return true;
+}
+
+wl_status_t ESP8266WiFiClass::status()
+{
+    if (!started || wifiMode == WIFI_OFF || !wifiEnabled()) return WL_DISCONNECTED;
+    return WL_CONNECTED;
+}
+
+WiFiClient::WiFiClient() :
+    fd(-1),
+    closed(false)
+{ }
+
+WiFiClient::~WiFiClient()
+{
+    stop();
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    stop();
+    if (WiFi.status() != WL_CONNECTED) return 0;
+
+    const char *overrideHost = getenv("HAL_CONNECT_HOST");
+    const char *overridePort = getenv("HAL_CONNECT_PORT");
+    if (overrideHost != NULL && *overrideHost != 0) host = overrideHost;
+    if (overridePort != NULL && *overridePort != 0) port = (uint16_t)atoi(overridePort);
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, service, &hints, &result) != 0) return 0;
+
+    for (struct addrinfo *ai = result; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    if (fd < 0) return 0;
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    closed = false;
+    return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+    char host[16];
+    snprintf(host, sizeof(host), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return connect(host, port);
+}
+
+size_t WiFiClient::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    if (fd < 0) return 0;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = send(fd, buffer + done, size - done, MSG_NOSIGNAL);
+        if (n <= 0) {
+            closed = true;
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+int WiFiClient::available()
+{
+    if (fd < 0) return 0;
+
+    // the server is real even when time isn't, give it a moment to answer
+    struct pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, netWaitMs) <= 0) return 0;
+
+    int n = 0;
+    uint8_t c;
+    ssize_t r = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (r == 0) {
+        closed = true;
+        return 0;
+    }
+    if (r < 0) return 0;
+    if (ioctl(fd, FIONREAD, &n) < 0 || n < 1) n = 1;
+    return n;
+}
+
+int WiFiClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+    if (available() <= 0) return -1;
+    ssize_t n = recv(fd, buffer, size, MSG_DONTWAIT);
+    if (n == 0) closed = true;
+    return n > 0 ? (int)n : -1;
+}
+
+int WiFiClient::peek()
+{
+    if (available() <= 0) return -1;
+    uint8_t c;
+    return recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 1 ? c : -1;
+}
+
+void WiFiClient::stop()
+{
+    if (fd >= 0) close(fd);
+    fd = -1;
+    closed = false;
+}
+
+uint8_t WiFiClient::connected()
+{
+    if (fd < 0) return 0;
+    if (!closed) available();
+    // still connected while there is data left to read, as on the ESP8266
+    if (closed) {
+        int n = 0;
+        return ioctl(fd, FIONREAD, &n) == 0 && n > 0;
+    }
+    return 1;
+}
+
+static uint32_t heapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return (uint32_t)info.uordblks;
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    uint32_t used = heapInUse() % HAL_HEAP_SIZE;
+    return HAL_HEAP_SIZE - used;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize()
+{
+    return getFreeHeap() - getFreeHeap() / 16;
+}
+
+uint8_t EspClass::getHeapFragmentation()
+{
+    uint32_t free = getFreeHeap();
+    return (uint8_t)(100 - (uint64_t)getMaxFreeBlockSize() * 100 / free);
+}
+
+void halSetChipId(uint32_t id)
+{
+    chipId = id;
+}
+
+uint32_t EspClass::getChipId()
+{
+    if (chipId == 0) {
+        const char *env = getenv("HAL_CHIP_ID");
+        chipId = env != NULL && *env != 0 ? strtoul(env, NULL, 0) : 0x00C0FFEE;
+    }
+    return chipId;
+}
+
+void EspClass::restart()
+{
+    fprintf(stderr, "hal: restart requested\n");
+    fflush(stdout);
+    exit(3);
+}
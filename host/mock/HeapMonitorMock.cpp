@@ -0,0 +1,9 @@
+// host stand-in for the ESP8266 heap calls
+#include "HeapMonitorMock.h"
+
+HEAP_SAMPLE mockHeapSample = {40000, 30000, 10, 3000};
+
+void readHeapSample(HEAP_SAMPLE &sample)
+{
+    sample = mockHeapSample;
+}
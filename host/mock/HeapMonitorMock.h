@@ -0,0 +1,9 @@
+#ifndef HEAP_MONITOR_MOCK_H
+#define HEAP_MONITOR_MOCK_H
+
+#include <HeapMonitor.h>
+
+// returned by readHeapSample() on the host build, set it before HeapMonitor::sample()
+extern HEAP_SAMPLE mockHeapSample;
+
+#endif
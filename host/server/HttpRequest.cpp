@@ -0,0 +1,110 @@
+#include "HttpRequest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string urlDecode(const std::string &s)
+{
+    std::string out;
+    out.reserve(s.length());
+    for (size_t i = 0; i < s.length(); i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < s.length() && hexValue(s[i + 1]) >= 0 && hexValue(s[i + 2]) >= 0) {
+            out += (char)(hexValue(s[i + 1]) * 16 + hexValue(s[i + 2]));
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+std::string HttpRequest::param(const char *name) const
+{
+    size_t nameLength = strlen(name);
+    size_t start = 0;
+    while (start <= query.length()) {
+        size_t end = query.find('&', start);
+        if (end == std::string::npos) end = query.length();
+        if (end - start > nameLength && query.compare(start, nameLength, name) == 0 && query[start + nameLength] == '=')
+            return urlDecode(query.substr(start + nameLength + 1, end - start - nameLength - 1));
+        start = end + 1;
+    }
+    return std::string();
+}
+
+// header value if line is "<name>: value", NULL otherwise
+static const char *headerValue(const char *line, const char *end, const char *name)
+{
+    size_t nameLength = strlen(name);
+    if ((size_t)(end - line) <= nameLength || strncasecmp(line, name, nameLength) != 0 || line[nameLength] != ':')
+        return NULL;
+    const char *value = line + nameLength + 1;
+    while (value < end && *value == ' ') value++;
+    return value;
+}
+
+int parseHttpRequest(const char *data, size_t length, HttpRequest &request)
+{
+    const char *headersEnd = NULL;
+    for (size_t i = 3; i < length && i < HTTP_MAX_REQUEST; i++) {
+        if (data[i] == '\n' && data[i - 1] == '\r' && data[i - 2] == '\n' && data[i - 3] == '\r') {
+            headersEnd = data + i + 1;
+            break;
+        }
+    }
+    if (headersEnd == NULL) return length >= HTTP_MAX_REQUEST ? -1 : 0;
+
+    // request line, "GET /verify?token=... HTTP/1.1"
+    const char *lineEnd = (const char *)memchr(data, '\r', headersEnd - data);
+    const char *space1 = (const char *)memchr(data, ' ', lineEnd - data);
+    if (space1 == NULL) return -1;
+    const char *space2 = (const char *)memchr(space1 + 1, ' ', lineEnd - space1 - 1);
+    if (space2 == NULL || space2[1] != 'H') return -1;
+
+    request.method.assign(data, space1 - data);
+    const char *target = space1 + 1;
+    const char *question = (const char *)memchr(target, '?', space2 - target);
+    if (question != NULL) {
+        request.path.assign(target, question - target);
+        request.query.assign(question + 1, space2 - question - 1);
+    } else {
+        request.path.assign(target, space2 - target);
+        request.query.clear();
+    }
+    bool http10 = lineEnd - space2 - 1 == 8 && memcmp(space2 + 1, "HTTP/1.0", 8) == 0;
+    request.keepAlive = !http10;
+    request.msgPack = false;
+
+    size_t contentLength = 0;
+    for (const char *line = lineEnd + 2; line < headersEnd - 2; ) {
+        const char *end = (const char *)memchr(line, '\r', headersEnd - line);
+        const char *value;
+        if ((value = headerValue(line, end, "Content-Length")) != NULL) {
+            contentLength = strtoul(value, NULL, 10);
+        } else if ((value = headerValue(line, end, "Connection")) != NULL) {
+            if (strncasecmp(value, "close", 5) == 0) request.keepAlive = false;
+            if (strncasecmp(value, "keep-alive", 10) == 0) request.keepAlive = true;
+        } else if ((value = headerValue(line, end, "Accept")) != NULL) {
+            request.msgPack = std::string(value, end).find("application/msgpack") != std::string::npos;
+        }
+        line = end + 2;
+    }
+
+    size_t headersLength = headersEnd - data;
+    if (headersLength + contentLength > HTTP_MAX_REQUEST) return -1;
+    if (length < headersLength + contentLength) return 0;
+
+    request.body.assign(headersEnd, contentLength);
+    return (int)(headersLength + contentLength);
+}
@@ -0,0 +1,35 @@
+#ifndef HTTP_REQUEST_H
+#define HTTP_REQUEST_H
+
+#include <stddef.h>
+#include <string>
+
+// largest request accepted, headers and body, the controllers' are under 1k
+#define HTTP_MAX_REQUEST 16384
+
+/*
+  * an HTTP/1.1 request, enough of one for the controllers and the load generator
+  */
+struct HttpRequest {
+    std::string method;
+    std::string path;       // without the query
+    std::string query;      // after the '?', still encoded
+    std::string body;
+    bool keepAlive;         // HTTP/1.1 unless "Connection: close", HTTP/1.0 only with keep-alive
+    bool msgPack;           // "Accept" lists application/msgpack
+
+    // a query parameter, url decoded, empty if missing
+    std::string param(const char *name) const;
+};
+
+/*
+  * parse one request from the front of data
+  * returns the bytes it used, 0 if the request isn't all there yet, -1 if it is malformed
+  * or larger than HTTP_MAX_REQUEST
+  */
+int parseHttpRequest(const char *data, size_t length, HttpRequest &request);
+
+// decode %xx and '+'
+std::string urlDecode(const std::string &s);
+
+#endif
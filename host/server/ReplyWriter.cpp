@@ -0,0 +1,105 @@
+#include "ReplyWriter.h"
+
+#include <stdio.h>
+
+void ReplyWriter::beginMap(size_t size)
+{
+    if (msgPack) {
+        writeSize(0x80, 0xde, size);
+    } else {
+        out += '{';
+        first.push_back(true);
+    }
+}
+
+void ReplyWriter::endMap()
+{
+    if (msgPack) return;
+    out += '}';
+    first.pop_back();
+}
+
+void ReplyWriter::key(const std::string &k)
+{
+    if (msgPack) {
+        writeString(k);
+        return;
+    }
+    if (!first.back()) out += ',';
+    first.back() = false;
+    writeString(k);
+    out += ':';
+}
+
+void ReplyWriter::value(uint64_t v)
+{
+    if (!msgPack) {
+        char digits[24];
+        snprintf(digits, sizeof(digits), "%llu", (unsigned long long)v);
+        out += digits;
+    } else if (v <= 0x7f) {
+        out += (char)v;
+    } else if (v <= 0xff) {
+        out += '\xcc';
+        writeBigEndian(v, 1);
+    } else if (v <= 0xffff) {
+        out += '\xcd';
+        writeBigEndian(v, 2);
+    } else if (v <= 0xffffffff) {
+        out += '\xce';
+        writeBigEndian(v, 4);
+    } else {
+        out += '\xcf';
+        writeBigEndian(v, 8);
+    }
+}
+
+void ReplyWriter::value(const std::string &s)
+{
+    writeString(s);
+}
+
+// tokens and thing names never need escaping, but quotes and backslashes get it anyway
+void ReplyWriter::writeString(const std::string &s)
+{
+    if (msgPack) {
+        if (s.length() < 32) {
+            out += (char)(0xa0 | s.length());
+        } else if (s.length() <= 0xff) {
+            out += '\xd9';
+            writeBigEndian(s.length(), 1);
+        } else if (s.length() <= 0xffff) {
+            out += '\xda';
+            writeBigEndian(s.length(), 2);
+        } else {
+            out += '\xdb';
+            writeBigEndian(s.length(), 4);
+        }
+        out += s;
+        return;
+    }
+    out += '"';
+    for (size_t i = 0; i < s.length(); i++) {
+        if (s[i] == '"' || s[i] == '\\') out += '\\';
+        out += s[i];
+    }
+    out += '"';
+}
+
+void ReplyWriter::writeSize(uint8_t fixed, uint8_t marker16, size_t size)
+{
+    if (size < 16) {
+        out += (char)(fixed | size);
+    } else if (size <= 0xffff) {
+        out += (char)marker16;
+        writeBigEndian(size, 2);
+    } else {
+        out += (char)(marker16 + 1);
+        writeBigEndian(size, 4);
+    }
+}
+
+void ReplyWriter::writeBigEndian(uint64_t v, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--) out += (char)(v >> (8 * i));
+}
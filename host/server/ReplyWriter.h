@@ -0,0 +1,41 @@
+#ifndef REPLY_WRITER_H
+#define REPLY_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+  * builds a reply body as JSON, or as MessagePack for a controller that sends
+  * "Accept: application/msgpack"
+  *
+  * MessagePack maps announce their size, so beginMap() takes it for both; each key is
+  * followed by exactly one value or nested map
+  */
+class ReplyWriter
+{
+public:
+    explicit ReplyWriter(bool msgPack) : msgPack(msgPack) { }
+
+    void beginMap(size_t size);
+    void endMap();
+    void key(const std::string &k);
+    void value(uint64_t v);
+    void value(const std::string &s);
+
+    // JSON ends in a newline, for controllers that read lines
+    std::string body() const { return msgPack ? out : out + "\n"; }
+    const char *contentType() const { return msgPack ? "application/msgpack" : "application/json"; }
+
+private:
+    void writeString(const std::string &s);
+    void writeSize(uint8_t fixed, uint8_t marker16, size_t size);
+    void writeBigEndian(uint64_t v, int bytes);
+
+    bool msgPack;
+    std::string out;
+    std::vector<bool> first;    // per open JSON map, no comma before the next key
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "TokenTable.h"
+
+#include <ctype.h>
+#include <fstream>
+#include <sstream>
+
+static bool isHexToken(const std::string &s)
+{
+    if (s.empty() || s.length() > 14 || s.length() % 2 != 0) return false;
+    for (size_t i = 0; i < s.length(); i++) {
+        if (!isxdigit((unsigned char)s[i])) return false;
+    }
+    return true;
+}
+
+bool TokenTable::load(std::istream &in, std::string &error)
+{
+    std::unordered_map<std::string, std::vector<Permission> > loaded;
+    std::string line;
+    int number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream fields(line);
+        std::string token, thing;
+        unsigned flags;
+        if (!(fields >> token)) continue;
+        if (!(fields >> thing >> flags) || !isHexToken(token) || flags > 0xFF) {
+            std::ostringstream message;
+            message << "line " << number << ": expected <token hex> <thing> <flags>";
+            error = message.str();
+            return false;
+        }
+
+        for (size_t i = 0; i < token.length(); i++) token[i] = tolower((unsigned char)token[i]);
+        Permission p = { thing, (uint8_t)flags };
+        loaded[token].push_back(p);
+    }
+
+    tokens.swap(loaded);
+    version_++;
+    return true;
+}
+
+bool TokenTable::load(const char *path, std::string &error)
+{
+    std::ifstream in(path);
+    if (!in) {
+        error = std::string("can't open ") + path;
+        return false;
+    }
+    return load(in, error);
+}
+
+uint8_t TokenTable::flags(const std::string &token, const std::string &thing) const
+{
+    std::unordered_map<std::string, std::vector<Permission> >::const_iterator it = tokens.find(token);
+    if (it == tokens.end()) return 0;
+
+    uint8_t any = 0;
+    for (size_t i = 0; i < it->second.size(); i++) {
+        const Permission &p = it->second[i];
+        if (p.thing == thing) return p.flags;
+        if (p.thing == "*") any = p.flags;
+    }
+    return any;
+}
+
+void TokenTable::snapshot(const std::string &thing, std::string &json) const
+{
+    std::vector<std::pair<std::string, uint8_t> > entries;
+    snapshot(thing, entries);
+
+    json = "{";
+    char entry[32];
+    for (size_t i = 0; i < entries.size(); i++) {
+        snprintf(entry, sizeof(entry), "%s\"%s\":%u", i > 0 ? "," : "", entries[i].first.c_str(), entries[i].second);
+        json += entry;
+    }
+    json += "}";
+}
+
+void TokenTable::snapshot(const std::string &thing, std::vector<std::pair<std::string, uint8_t> > &entries) const
+{
+    entries.clear();
+    for (std::unordered_map<std::string, std::vector<Permission> >::const_iterator it = tokens.begin();
+         it != tokens.end(); ++it) {
+        uint8_t f = flags(it->first, thing);
+        if (f != 0) entries.push_back(std::make_pair(it->first, f));
+    }
+}
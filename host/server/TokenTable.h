@@ -0,0 +1,51 @@
+#ifndef TOKEN_TABLE_H
+#define TOKEN_TABLE_H
+
+#include <stdint.h>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// flags, as the controllers cache them
+#define TOKEN_ACCESS    0x01
+#define TOKEN_TRAINER   0x02
+
+/*
+  * the access server's tokens and permissions, loaded from lines of
+  *   <token hex> <thing> <flags>
+  * where thing "*" applies to every thing without a line of its own, # starts a comment
+  */
+class TokenTable
+{
+public:
+    TokenTable() : version_(0) { }
+
+    // replaces the contents, error says which line is bad on failure
+    bool load(std::istream &in, std::string &error);
+    bool load(const char *path, std::string &error);
+
+    // flags for token on thing, 0 if it has no access
+    uint8_t flags(const std::string &token, const std::string &thing) const;
+
+    // {"<token>":<flags>,...} of every token with access to thing
+    void snapshot(const std::string &thing, std::string &json) const;
+    // the same as pairs, for replies in other encodings
+    void snapshot(const std::string &thing, std::vector<std::pair<std::string, uint8_t> > &entries) const;
+
+    size_t size() const { return tokens.size(); }
+    uint32_t version() const { return version_; }
+    void setVersion(uint32_t v) { version_ = v; }
+
+private:
+    struct Permission {
+        std::string thing;
+        uint8_t flags;
+    };
+
+    std::unordered_map<std::string, std::vector<Permission> > tokens;
+    uint32_t version_;
+};
+
+#endif
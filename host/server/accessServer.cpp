@@ -0,0 +1,389 @@
+/*
+  * Reference access server for development and load testing, in place of stub.js.
+  *
+  * One epoll loop per worker thread, each with its own SO_REUSEPORT listener, HTTP/1.1
+  * with keep-alive and pipelining, answers from an in-memory TokenTable.
+  *
+  *   accessServer [-p port] [-t tokens.txt] [-w workers] [-q]
+  *
+  *   -p  port, default 9000 as stub.js
+  *   -t  token file, see TokenTable.h, without one every token has access, as stub.js
+  *   -w  worker threads, default 1
+  *   -q  don't print log messages
+  *
+  * Endpoints, thing is the controller's THING_ID:
+  *   GET /verify?token=<hex>&thing=<id>        {"access":1,"trainer":0}
+  *   GET /msglog?thing=<id>&msg=<text>         printed, {}
+  *   GET /batch?thing=<id>&tokens=<hex>,<hex>  {"<hex>":<flags>,...}, up to BATCH_MAX_TOKENS
+  *   GET /snapshot?thing=<id>[&since=<ver>]    {"version":<ver>,"tokens":{"<hex>":<flags>,...}},
+  *                                             304 if the table is still at version since
+  *   GET /stats                                request counters
+  *   POST /<anything>?thing=<id>               accepted and counted, for usage, heap, telemetry
+  *
+  * A request with "Accept: application/msgpack" gets the same replies as MessagePack instead.
+  * Every JSON body ends in a newline, so a controller reading lines doesn't wait out its timeout
+  * for the last one. SIGHUP reloads the token file, SIGINT or SIGTERM print the counters and exit.
+  */
+
+#include "HttpRequest.h"
+#include "ReplyWriter.h"
+#include "TokenTable.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define BATCH_MAX_TOKENS 32     // TOKEN_CACHE_SIZE, a whole cache in one request
+#define EPOLL_EVENTS 256
+
+enum Counter {
+    COUNT_VERIFY,
+    COUNT_MSGLOG,
+    COUNT_BATCH,
+    COUNT_SNAPSHOT,
+    COUNT_POST,
+    COUNT_OTHER,
+    COUNT_CONNECTIONS,
+    COUNT_BAD,
+    COUNTERS
+};
+
+static const char *counterNames[COUNTERS] = {
+    "verify", "msglog", "batch", "snapshot", "post", "other", "connections", "bad"
+};
+
+static std::atomic<uint64_t> counters[COUNTERS];
+static std::shared_ptr<const TokenTable> table;
+static const char *tokenFile = NULL;
+static bool quiet = false;
+
+struct Connection {
+    int fd;
+    std::string in;
+    std::string out;
+    bool closing;       // close once out is sent
+};
+
+static std::shared_ptr<const TokenTable> currentTable()
+{
+    return std::atomic_load(&table);
+}
+
+static std::string lowerCase(std::string s)
+{
+    for (size_t i = 0; i < s.length(); i++) s[i] = tolower((unsigned char)s[i]);
+    return s;
+}
+
+// flags for a token, every token has access without a token file
+static uint8_t tokenFlags(const TokenTable &t, const std::string &token, const std::string &thing)
+{
+    if (tokenFile == NULL) return TOKEN_ACCESS;
+    return t.flags(lowerCase(token), thing);
+}
+
+static void respond(Connection &c, int status, const std::string &body, bool keepAlive,
+                    const char *contentType = "application/json")
+{
+    const char *reason = status == 200 ? "OK" : status == 304 ? "Not Modified" :
+                         status == 404 ? "Not Found" : "Bad Request";
+    char headers[192];
+    snprintf(headers, sizeof(headers),
+             "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: %s\r\n\r\n",
+             status, reason, contentType, (unsigned)body.length(), keepAlive ? "keep-alive" : "close");
+    c.out += headers;
+    c.out += body;
+    if (!keepAlive) c.closing = true;
+}
+
+static void respond(Connection &c, int status, const ReplyWriter &reply, bool keepAlive)
+{
+    respond(c, status, reply.body(), keepAlive, reply.contentType());
+}
+
+static void handle(Connection &c, const HttpRequest &r)
+{
+    std::shared_ptr<const TokenTable> t = currentTable();
+    std::string thing = r.param("thing");
+    ReplyWriter reply(r.msgPack);
+
+    if (r.method == "POST") {
+        counters[COUNT_POST]++;
+        reply.beginMap(0);
+        reply.endMap();
+        respond(c, 200, reply, r.keepAlive);
+
+    } else if (r.path == "/verify") {
+        counters[COUNT_VERIFY]++;
+        std::string token = r.param("token");
+        if (token.empty()) {
+            reply.beginMap(2);
+            reply.key("access");
+            reply.value(0);
+            reply.key("error");
+            reply.value("missing token");
+            reply.endMap();
+            respond(c, 200, reply, r.keepAlive);
+            return;
+        }
+        uint8_t flags = tokenFlags(*t, token, thing);
+        reply.beginMap(2);
+        reply.key("access");
+        reply.value(flags & TOKEN_ACCESS ? 1 : 0);
+        reply.key("trainer");
+        reply.value(flags & TOKEN_TRAINER ? 1 : 0);
+        reply.endMap();
+        respond(c, 200, reply, r.keepAlive);
+
+    } else if (r.path == "/msglog") {
+        counters[COUNT_MSGLOG]++;
+        if (!quiet) printf("%s: %s\n", thing.c_str(), r.param("msg").c_str());
+        reply.beginMap(0);
+        reply.endMap();
+        respond(c, 200, reply, r.keepAlive);
+
+    } else if (r.path == "/batch") {
+        counters[COUNT_BATCH]++;
+        std::string tokens = r.param("tokens");
+        std::vector<std::string> batch;
+        size_t start = 0;
+        while (start < tokens.length() && batch.size() < BATCH_MAX_TOKENS) {
+            size_t end = tokens.find(',', start);
+            if (end == std::string::npos) end = tokens.length();
+            batch.push_back(lowerCase(tokens.substr(start, end - start)));
+            start = end + 1;
+        }
+        reply.beginMap(batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            reply.key(batch[i]);
+            reply.value(tokenFlags(*t, batch[i], thing));
+        }
+        reply.endMap();
+        respond(c, 200, reply, r.keepAlive);
+
+    } else if (r.path == "/snapshot") {
+        counters[COUNT_SNAPSHOT]++;
+        std::string since = r.param("since");
+        if (!since.empty() && strtoul(since.c_str(), NULL, 10) == t->version()) {
+            respond(c, 304, "", r.keepAlive, reply.contentType());
+            return;
+        }
+        std::vector<std::pair<std::string, uint8_t> > entries;
+        t->snapshot(thing, entries);
+        reply.beginMap(2);
+        reply.key("version");
+        reply.value(t->version());
+        reply.key("tokens");
+        reply.beginMap(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            reply.key(entries[i].first);
+            reply.value(entries[i].second);
+        }
+        reply.endMap();
+        reply.endMap();
+        respond(c, 200, reply, r.keepAlive);
+
+    } else if (r.path == "/stats") {
+        counters[COUNT_OTHER]++;
+        reply.beginMap(COUNTERS);
+        for (int i = 0; i < COUNTERS; i++) {
+            reply.key(counterNames[i]);
+            reply.value(counters[i].load());
+        }
+        reply.endMap();
+        respond(c, 200, reply, r.keepAlive);
+
+    } else {
+        counters[COUNT_OTHER]++;
+        reply.beginMap(1);
+        reply.key("error");
+        reply.value("not found");
+        reply.endMap();
+        respond(c, 404, reply, false);
+    }
+}
+
+static int listenOn(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        fprintf(stderr, "accessServer: can't listen on %u: %s\n", port, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+// sends what it can of c.out, false once the connection is finished with
+static bool flush(Connection &c)
+{
+    while (!c.out.empty()) {
+        ssize_t n = send(c.fd, c.out.data(), c.out.length(), MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c.out.erase(0, n);
+    }
+    return !c.closing;
+}
+
+static void closeConnection(int epollFd, Connection *c)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    delete c;
+}
+
+static void worker(uint16_t port)
+{
+    int listenFd = listenOn(port);
+    int epollFd = epoll_create1(0);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;    // NULL is the listener
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+    struct epoll_event events[EPOLL_EVENTS];
+    for (;;) {
+        int n = epoll_wait(epollFd, events, EPOLL_EVENTS, -1);
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == NULL) {
+                int fd;
+                while ((fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+                    int one = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    Connection *c = new Connection();
+                    c->fd = fd;
+                    c->closing = false;
+                    ev.events = EPOLLIN;
+                    ev.data.ptr = c;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+                    counters[COUNT_CONNECTIONS]++;
+                }
+                continue;
+            }
+
+            Connection *c = (Connection *)events[i].data.ptr;
+            bool open = true;
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                char buffer[4096];
+                ssize_t r;
+                while ((r = recv(c->fd, buffer, sizeof(buffer), 0)) > 0) c->in.append(buffer, r);
+                if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) open = false;
+
+                // every complete request, pipelined ones too
+                size_t used = 0;
+                while (!c->closing) {
+                    HttpRequest request;
+                    int length = parseHttpRequest(c->in.data() + used, c->in.length() - used, request);
+                    if (length == 0) break;
+                    if (length < 0) {
+                        counters[COUNT_BAD]++;
+                        respond(*c, 400, "{\"error\":\"bad request\"}\n", false);
+                        break;
+                    }
+                    used += length;
+                    handle(*c, request);
+                }
+                c->in.erase(0, used);
+            }
+
+            // a peer that has gone gets one try at what it asked for
+            if (!flush(*c) || !open) {
+                closeConnection(epollFd, c);
+                continue;
+            }
+            ev.events = c->out.empty() ? EPOLLIN : EPOLLIN | EPOLLOUT;
+            ev.data.ptr = c;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+        }
+    }
+}
+
+static bool loadTable()
+{
+    std::shared_ptr<TokenTable> t(new TokenTable());
+    std::shared_ptr<const TokenTable> old = currentTable();
+    if (old) t->setVersion(old->version());
+
+    std::string error;
+    if (tokenFile != NULL && !t->load(tokenFile, error)) {
+        fprintf(stderr, "accessServer: %s: %s\n", tokenFile, error.c_str());
+        return false;
+    }
+    if (tokenFile == NULL) t->setVersion(1);
+    std::atomic_store(&table, std::shared_ptr<const TokenTable>(t));
+    fprintf(stderr, "accessServer: %u tokens, version %u\n", (unsigned)t->size(), t->version());
+    return true;
+}
+
+static void printCounters()
+{
+    for (int i = 0; i < COUNTERS; i++) {
+        fprintf(stderr, "%s%s %llu", i > 0 ? ", " : "", counterNames[i], (unsigned long long)counters[i].load());
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port = 9000;
+    int workers = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:t:w:q")) != -1) {
+        switch (opt) {
+            case 'p': port = (uint16_t)atoi(optarg); break;
+            case 't': tokenFile = optarg; break;
+            case 'w': workers = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+            case 'q': quiet = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-p port] [-t tokens.txt] [-w workers] [-q]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (!loadTable()) return 1;
+
+    // signals are taken here, not by the workers
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    for (int i = 0; i < workers; i++) std::thread(worker, port).detach();
+    fprintf(stderr, "accessServer: listening on %u, %d worker(s)\n", port, workers);
+
+    for (;;) {
+        int sig;
+        sigwait(&signals, &sig);
+        if (sig == SIGHUP) {
+            loadTable();
+        } else {
+            printCounters();
+            return 0;
+        }
+    }
+}
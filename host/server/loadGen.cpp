@@ -0,0 +1,311 @@
+/*
+  * Load generator for accessServer, or anything else that speaks the controllers' API.
+  *
+  * Each connection plays a controller that sends its next request as soon as the last one
+  * is answered, so the result is the most the server can sustain at that concurrency.
+  * Requests are made the way AccessSystem makes them, a new connection each time with
+  * "Connection: close", unless -k keeps connections alive.
+  *
+  *   loadGen [-h host] [-p port] [-c connections] [-d seconds] [-k] [-m] [-e endpoint] [-t tokens.txt] [-r rate]
+  *
+  *   -h, -p  server, default 127.0.0.1:9000
+  *   -c  concurrent connections, default 50
+  *   -d  seconds to run, default 10
+  *   -k  keep connections alive
+  *   -m  ask for MessagePack replies, "Accept: application/msgpack"
+  *   -e  verify, msglog, batch, snapshot or post, default verify
+  *   -t  token file as accessServer's, the tokens to ask about, default made up ones
+  *   -r  requests per minute each controller makes, to size the fleet from the rate, default 1
+  */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BATCH_TOKENS 32
+
+struct Client {
+    int fd;
+    int controller;
+    std::string out;
+    size_t sent;
+    std::string in;
+    uint64_t startUs;
+};
+
+static struct sockaddr_storage server;
+static socklen_t serverLength;
+static std::string host = "127.0.0.1";
+static std::string endpoint = "verify";
+static bool keepAlive = false;
+static bool msgPack = false;
+static std::vector<std::string> tokens;
+
+static int epollFd;
+static std::vector<uint32_t> latencyUs;
+static uint64_t errors = 0;
+static uint64_t nextRequest = 0;
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static std::string request(int controller)
+{
+    std::ostringstream r;
+    const std::string &token = tokens[nextRequest++ % tokens.size()];
+
+    if (endpoint == "post") {
+        const char *json = "{\"freeHeap\":31000,\"maxFreeBlock\":28000,\"fragmentation\":9}";
+        r << "POST /heap?thing=" << controller << " HTTP/1.1\r\nHost: " << host
+          << "\r\nContent-Type: application/json\r\nContent-Length: " << strlen(json);
+        r << (keepAlive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n") << json;
+        return r.str();
+    }
+
+    if (endpoint == "msglog") {
+        r << "GET /msglog?thing=" << controller << "&msg=Permission+granted+to:+" << token;
+    } else if (endpoint == "batch") {
+        r << "GET /batch?thing=" << controller << "&tokens=";
+        for (int i = 0; i < BATCH_TOKENS; i++) r << (i > 0 ? "," : "") << tokens[(nextRequest + i) % tokens.size()];
+    } else if (endpoint == "snapshot") {
+        r << "GET /snapshot?thing=" << controller;
+    } else {
+        r << "GET /verify?token=" << token << "&thing=" << controller;
+    }
+    r << " HTTP/1.1\r\nHost: " << host << (msgPack ? "\r\nAccept: application/msgpack" : "")
+      << (keepAlive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    return r.str();
+}
+
+static bool connectClient(Client &c)
+{
+    c.fd = socket(server.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(c.fd, (struct sockaddr *)&server, serverLength) < 0 && errno != EINPROGRESS) {
+        close(c.fd);
+        c.fd = -1;
+        return false;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.ptr = &c;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, c.fd, &ev);
+    return true;
+}
+
+static void closeClient(Client &c)
+{
+    if (c.fd < 0) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, NULL);
+    close(c.fd);
+    c.fd = -1;
+}
+
+static void start(Client &c)
+{
+    c.out = request(c.controller);
+    c.sent = 0;
+    c.in.clear();
+    c.startUs = nowUs();
+
+    if (c.fd < 0 && !connectClient(c)) {
+        errors++;
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.ptr = &c;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+// 1 when the response in c.in is complete and good, -1 if bad, 0 if more is to come
+static int responseComplete(const Client &c, bool closed)
+{
+    size_t headersEnd = c.in.find("\r\n\r\n");
+    if (headersEnd == std::string::npos) return closed ? -1 : 0;
+
+    int status = atoi(c.in.c_str() + 9);
+    bool ok = status == 200 || status == 304;
+    const char *length = strcasestr(c.in.c_str(), "\r\nContent-Length:");
+    if (length != NULL && length < c.in.c_str() + headersEnd) {
+        size_t bodyLength = strtoul(length + 17, NULL, 10);
+        if (c.in.length() >= headersEnd + 4 + bodyLength) return ok ? 1 : -1;
+        return closed ? -1 : 0;
+    }
+    // no length, the body runs to the close, as stub.js sends it
+    if (!closed) return 0;
+    return ok ? 1 : -1;
+}
+
+static void finish(Client &c, int result, bool running)
+{
+    if (result > 0) {
+        latencyUs.push_back((uint32_t)(nowUs() - c.startUs));
+    } else {
+        errors++;
+    }
+    if (!keepAlive || result < 0) closeClient(c);
+    if (running) start(c);
+}
+
+static bool resolve(const char *port)
+{
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port, &hints, &result) != 0) return false;
+    memcpy(&server, result->ai_addr, result->ai_addrlen);
+    serverLength = result->ai_addrlen;
+    freeaddrinfo(result);
+    return true;
+}
+
+static void loadTokens(const char *path)
+{
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string token;
+        if (fields >> token && token[0] != '#') tokens.push_back(token);
+    }
+}
+
+static uint32_t percentile(const std::vector<uint32_t> &sorted, int p)
+{
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
+}
+
+int main(int argc, char **argv)
+{
+    const char *port = "9000";
+    int connections = 50;
+    int seconds = 10;
+    double perControllerPerMinute = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:c:d:kme:t:r:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = optarg; break;
+            case 'c': connections = std::max(atoi(optarg), 1); break;
+            case 'd': seconds = std::max(atoi(optarg), 1); break;
+            case 'k': keepAlive = true; break;
+            case 'm': msgPack = true; break;
+            case 'e': endpoint = optarg; break;
+            case 't': loadTokens(optarg); break;
+            case 'r': perControllerPerMinute = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-h host] [-p port] [-c connections] [-d seconds] [-k] [-m] "
+                                "[-e verify|msglog|batch|snapshot|post] [-t tokens.txt] [-r rate]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (!resolve(port)) {
+        fprintf(stderr, "loadGen: can't resolve %s\n", host.c_str());
+        return 1;
+    }
+    if (tokens.empty()) {
+        char token[16];
+        for (int i = 0; i < 1000; i++) {
+            snprintf(token, sizeof(token), "04f1ee70%06x", i);
+            tokens.push_back(token);
+        }
+    }
+
+    epollFd = epoll_create1(0);
+    std::vector<Client> clients(connections);
+    for (int i = 0; i < connections; i++) {
+        clients[i].fd = -1;
+        clients[i].controller = i;
+    }
+    for (int i = 0; i < connections; i++) start(clients[i]);
+
+    uint64_t startUs = nowUs();
+    uint64_t endUs = startUs + (uint64_t)seconds * 1000000;
+    bool running = true;
+    struct epoll_event events[256];
+    for (;;) {
+        uint64_t now = nowUs();
+        if (running && now >= endUs) running = false;
+
+        // after the end, wait for what's outstanding for up to a second
+        bool outstanding = false;
+        for (int i = 0; i < connections && !outstanding; i++) {
+            outstanding = clients[i].fd >= 0 && (!keepAlive || clients[i].sent > 0);
+        }
+        if (!running && (!outstanding || now >= endUs + 1000000)) break;
+
+        int n = epoll_wait(epollFd, events, 256, 100);
+        for (int i = 0; i < n; i++) {
+            Client &c = *(Client *)events[i].data.ptr;
+            if (c.fd < 0) continue;
+
+            if ((events[i].events & EPOLLOUT) && c.sent < c.out.length()) {
+                ssize_t w = send(c.fd, c.out.data() + c.sent, c.out.length() - c.sent, MSG_NOSIGNAL);
+                if (w < 0 && errno != EAGAIN) {
+                    finish(c, -1, running);
+                    continue;
+                }
+                if (w > 0) c.sent += w;
+                if (c.sent == c.out.length()) {
+                    struct epoll_event ev;
+                    ev.events = EPOLLIN;
+                    ev.data.ptr = &c;
+                    epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+                }
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                char buffer[4096];
+                ssize_t r;
+                while ((r = recv(c.fd, buffer, sizeof(buffer), 0)) > 0) c.in.append(buffer, r);
+                bool closed = r == 0 || (r < 0 && errno != EAGAIN);
+                int result = responseComplete(c, closed);
+                if (result != 0) {
+                    c.sent = 0;
+                    if (closed) closeClient(c);
+                    finish(c, result, running);
+                } else if (closed) {
+                    closeClient(c);
+                    finish(c, -1, running);
+                }
+            }
+        }
+    }
+
+    double elapsed = (nowUs() - startUs) / 1e6;
+    std::sort(latencyUs.begin(), latencyUs.end());
+    double rate = latencyUs.size() / elapsed;
+    printf("%s%s, %d connections, %s, %.1f s\n", endpoint.c_str(), msgPack ? " (msgpack)" : "", connections,
+           keepAlive ? "keep-alive" : "a connection per request", elapsed);
+    printf("requests: %u, %.1f/s, errors %llu\n", (unsigned)latencyUs.size(), rate, (unsigned long long)errors);
+    printf("latency: p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", percentile(latencyUs, 50) / 1000.0,
+           percentile(latencyUs, 99) / 1000.0, percentile(latencyUs, 100) / 1000.0);
+    if (perControllerPerMinute > 0) {
+        printf("at %g requests/min per controller that serves %.0f controllers\n",
+               perControllerPerMinute, rate * 60 / perControllerPerMinute);
+    }
+    return errors > 0 ? 2 : 0;
+}
@@ -0,0 +1,123 @@
+// accessServer's request parsing, replies and token table
+
+#include <gtest/gtest.h>
+
+#include <HttpRequest.h>
+#include <ReplyWriter.h>
+#include <TokenTable.h>
+
+#include <sstream>
+
+TEST(AccessServer_Tests, ParsesControllerVerifyRequest) {
+  const char *raw = "GET /verify?token=04a10bff00807e&thing=1 HTTP/1.1\r\n"
+                    "Host: 192.168.1.70\r\n"
+                    "Connection: close\r\n\r\n";
+  HttpRequest r;
+
+  EXPECT_EQ((int)strlen(raw), parseHttpRequest(raw, strlen(raw), r));
+  EXPECT_EQ("GET", r.method);
+  EXPECT_EQ("/verify", r.path);
+  EXPECT_EQ("04a10bff00807e", r.param("token"));
+  EXPECT_EQ("1", r.param("thing"));
+  EXPECT_EQ("", r.param("missing"));
+  EXPECT_FALSE(r.keepAlive);
+}
+
+TEST(AccessServer_Tests, WaitsForTheWholeRequest) {
+  const char *raw = "POST /usage?thing=1 HTTP/1.1\r\nContent-Length: 4\r\n\r\n{}";
+  HttpRequest r;
+
+  EXPECT_EQ(0, parseHttpRequest(raw, strlen(raw) - 10, r));
+  EXPECT_EQ(0, parseHttpRequest(raw, strlen(raw), r));
+}
+
+TEST(AccessServer_Tests, ParsesPipelinedKeepAliveRequests) {
+  std::string raw = "POST /heap?thing=2 HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+                    "GET /msglog?thing=2&msg=Permission+granted+to%3A+abc HTTP/1.1\r\n\r\n";
+  HttpRequest r;
+
+  int first = parseHttpRequest(raw.data(), raw.length(), r);
+  ASSERT_GT(first, 0);
+  EXPECT_EQ("{}", r.body);
+  EXPECT_TRUE(r.keepAlive);
+
+  EXPECT_EQ((int)raw.length() - first, parseHttpRequest(raw.data() + first, raw.length() - first, r));
+  EXPECT_EQ("Permission granted to: abc", r.param("msg"));
+}
+
+TEST(AccessServer_Tests, NegotiatesMsgPack) {
+  const char *json = "GET /verify?token=ab HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n";
+  const char *msgPack = "GET /verify?token=ab HTTP/1.1\r\n"
+                        "Accept: application/msgpack, application/json\r\n\r\n";
+  HttpRequest r;
+
+  ASSERT_GT(parseHttpRequest(json, strlen(json), r), 0);
+  EXPECT_FALSE(r.msgPack);
+  ASSERT_GT(parseHttpRequest(msgPack, strlen(msgPack), r), 0);
+  EXPECT_TRUE(r.msgPack);
+}
+
+TEST(AccessServer_Tests, WritesRepliesInEitherEncoding) {
+  ReplyWriter json(false), msgPack(true);
+  ReplyWriter *writers[] = {&json, &msgPack};
+  for (ReplyWriter *w : writers) {
+    w->beginMap(2);
+    w->key("version");
+    w->value(300);
+    w->key("tokens");
+    w->beginMap(1);
+    w->key("deadbeef");
+    w->value(3);
+    w->endMap();
+    w->endMap();
+  }
+
+  EXPECT_EQ("{\"version\":300,\"tokens\":{\"deadbeef\":3}}\n", json.body());
+  EXPECT_STREQ("application/json", json.contentType());
+  EXPECT_EQ(std::string("\x82\xa7version\xcd\x01\x2c\xa6tokens\x81\xa8" "deadbeef\x03"),
+            msgPack.body());
+  EXPECT_STREQ("application/msgpack", msgPack.contentType());
+}
+
+TEST(AccessServer_Tests, RejectsMalformedRequest) {
+  const char *raw = "nonsense\r\n\r\n";
+  HttpRequest r;
+
+  EXPECT_EQ(-1, parseHttpRequest(raw, strlen(raw), r));
+}
+
+TEST(AccessServer_Tests, LooksUpFlagsPerThingWithWildcard) {
+  std::istringstream in("# comment\n"
+                        "04A10BFF00807E * 1\n"
+                        "04a10bff00807e lathe 3\n"
+                        "deadbeef laser 1   # trailing comment\n");
+  TokenTable t;
+  std::string error;
+
+  ASSERT_TRUE(t.load(in, error));
+  EXPECT_EQ(2u, t.size());
+  EXPECT_EQ(1u, t.version());
+  EXPECT_EQ(3, t.flags("04a10bff00807e", "lathe"));
+  EXPECT_EQ(1, t.flags("04a10bff00807e", "door"));
+  EXPECT_EQ(1, t.flags("deadbeef", "laser"));
+  EXPECT_EQ(0, t.flags("deadbeef", "lathe"));
+  EXPECT_EQ(0, t.flags("00000000", "lathe"));
+
+  std::string json;
+  t.snapshot("laser", json);
+  EXPECT_NE(std::string::npos, json.find("\"deadbeef\":1"));
+  EXPECT_NE(std::string::npos, json.find("\"04a10bff00807e\":1"));
+}
+
+TEST(AccessServer_Tests, BadTokenLineLeavesTableAsItWas) {
+  std::istringstream good("deadbeef * 1\n");
+  std::istringstream bad("deadbeef * 1\nnot-a-token * 1\n");
+  TokenTable t;
+  std::string error;
+
+  ASSERT_TRUE(t.load(good, error));
+  EXPECT_FALSE(t.load(bad, error));
+  EXPECT_EQ("line 2: expected <token hex> <thing> <flags>", error);
+  EXPECT_EQ(1, t.flags("deadbeef", "door"));
+  EXPECT_EQ(1u, t.version());
+}
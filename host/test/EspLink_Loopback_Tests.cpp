@@ -0,0 +1,273 @@
+// Loops EspLink frames through a simulated serial line, with corruption
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <EspLink.h>
+
+class Line {
+ public:
+  Line() : seed(12345), errorRate(0), corrupted(0) {}
+
+  void write(uint8_t b) {
+    if (errorRate > 0 && random() % errorRate == 0) {
+      b ^= 1 << (random() % 8);
+      corrupted++;
+    }
+    bytes.push_back(b);
+  }
+
+  // feed everything sent so far to the decoder, return the frames it produced
+  std::vector<ESPLINK_FRAME> drain(EspLinkDecoder &decoder) {
+    std::vector<ESPLINK_FRAME> frames;
+    for (size_t i = 0; i < bytes.size(); i++) {
+      if (decoder.decode(bytes[i])) frames.push_back(decoder.frame);
+    }
+    bytes.clear();
+    return frames;
+  }
+
+  uint32_t random() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+  }
+
+  std::vector<uint8_t> bytes;
+  uint32_t seed;
+  uint32_t errorRate;  // one byte in errorRate has a bit flipped, 0 = none
+  uint32_t corrupted;
+};
+
+class EspLink_Loopback_Tests : public testing::Test {
+ protected:
+  Line line;
+  EspLinkDecoder decoder;
+};
+
+TEST_F(EspLink_Loopback_Tests, VerifyRoundTrip) {
+  uint8_t token[7] = {0x04, 0x7e, 0x7d, 0x20, 0x5d, 0x5e, 0xff};
+  espLinkSend(line, 42, ESPLINK_VERIFY, token, sizeof(token));
+
+  std::vector<ESPLINK_FRAME> frames = line.drain(decoder);
+  ASSERT_EQ(1U, frames.size());
+  EXPECT_EQ(42, frames[0].seq);
+  EXPECT_EQ(ESPLINK_VERIFY, frames[0].type);
+  ASSERT_EQ(7, frames[0].length);
+  EXPECT_EQ(0, memcmp(token, frames[0].payload, 7));
+}
+
+TEST_F(EspLink_Loopback_Tests, EmptyPayload) {
+  espLinkSend(line, 1, ESPLINK_HEARTBEAT | ESPLINK_REPLY, NULL, 0);
+
+  std::vector<ESPLINK_FRAME> frames = line.drain(decoder);
+  ASSERT_EQ(1U, frames.size());
+  EXPECT_EQ(ESPLINK_HEARTBEAT | ESPLINK_REPLY, frames[0].type);
+  EXPECT_EQ(0, frames[0].length);
+}
+
+TEST_F(EspLink_Loopback_Tests, StuffedFrameFitsMaxFrame) {
+  uint8_t payload[ESPLINK_MAX_PAYLOAD];
+  memset(payload, ESPLINK_SOF, sizeof(payload));
+
+  size_t n = espLinkSend(line, ESPLINK_SOF, ESPLINK_LOG, payload, sizeof(payload));
+
+  EXPECT_EQ(line.bytes.size(), n);
+  EXPECT_GE((size_t)ESPLINK_MAX_FRAME, n);
+  EXPECT_EQ(1U, line.drain(decoder).size());
+}
+
+TEST_F(EspLink_Loopback_Tests, IgnoresNoiseBetweenFrames) {
+  const char *debug = "WiFi -> Connecting\r\n";
+  for (const char *c = debug; *c; c++) line.write(*c);
+  espLinkSend(line, 7, ESPLINK_HEARTBEAT, NULL, 0);
+  for (const char *c = debug; *c; c++) line.write(*c);
+
+  EXPECT_EQ(1U, line.drain(decoder).size());
+  EXPECT_EQ(0, decoder.crcErrors);
+  EXPECT_EQ(0, decoder.framingErrors);
+}
+
+TEST_F(EspLink_Loopback_Tests, ResyncsAfterTruncatedFrame) {
+  uint8_t msg[] = "Permission%20granted";
+  espLinkSend(line, 3, ESPLINK_LOG, msg, sizeof(msg));
+  line.bytes.resize(line.bytes.size() / 2);
+  espLinkSend(line, 4, ESPLINK_HEARTBEAT, NULL, 0);
+
+  std::vector<ESPLINK_FRAME> frames = line.drain(decoder);
+  ASSERT_EQ(1U, frames.size());
+  EXPECT_EQ(4, frames[0].seq);
+  EXPECT_EQ(1, decoder.framingErrors);
+}
+
+TEST_F(EspLink_Loopback_Tests, RejectsOversizeLength) {
+  line.write(ESPLINK_SOF);
+  line.write(ESPLINK_MAX_PAYLOAD + 1);
+  espLinkSend(line, 5, ESPLINK_HEARTBEAT, NULL, 0);
+
+  EXPECT_EQ(1U, line.drain(decoder).size());
+  EXPECT_EQ(1, decoder.framingErrors);
+}
+
+TEST_F(EspLink_Loopback_Tests, CorruptFramesNeverDecode) {
+  const int count = 5000;
+  line.errorRate = 200;
+
+  uint8_t token[7];
+  for (int i = 0; i < count; i++) {
+    token[0] = i >> 8;
+    token[1] = i & 0xff;
+    for (int j = 2; j < 7; j++) token[j] = i * 31 + j;
+    espLinkSend(line, i % 255 + 1, ESPLINK_VERIFY, token, 7);
+  }
+  std::vector<ESPLINK_FRAME> frames = line.drain(decoder);
+
+  ASSERT_GT(line.corrupted, 0U);
+
+  // every frame that got through is exactly what was sent
+  for (size_t i = 0; i < frames.size(); i++) {
+    ASSERT_EQ(ESPLINK_VERIFY, frames[i].type);
+    ASSERT_EQ(7, frames[i].length);
+    int sent = frames[i].payload[0] << 8 | frames[i].payload[1];
+    ASSERT_LT(sent, count);
+    ASSERT_EQ(sent % 255 + 1, frames[i].seq);
+    for (int j = 2; j < 7; j++) {
+      ASSERT_EQ((uint8_t)(sent * 31 + j), frames[i].payload[j]);
+    }
+  }
+
+  // a corrupted byte costs at most the frame it is in, and the next one if it made
+  // or broke a SOF, which is the only way a frame is lost without an error count
+  EXPECT_GE(frames.size() + 2 * line.corrupted, (size_t)count);
+  EXPECT_GE((size_t)count, frames.size() + decoder.crcErrors + decoder.framingErrors);
+}
+
+/*
+  * Request / reply throughput on a simulated line at several baud rates.
+  * Each verify request is answered by a loopback responder, a lost frame
+  * costs a timeout and a retry with a new seq.
+  */
+// wire offset of body byte n of the frame starting at start, skipping escapes
+static size_t wireOffset(const std::vector<uint8_t> &bytes, size_t start, size_t n) {
+  size_t i = start + 1;
+  for (size_t body = 0;; body++, i++) {
+    if (bytes[i] == ESPLINK_ESC) i++;
+    if (body == n) return i;
+  }
+}
+
+/*
+  * Verify exchanges through the real sender and decoders, with a bit flipped in
+  * some requests and a byte dropped from some replies. A lost frame costs the
+  * controller a retry with a new seq, so every fault must show up as exactly one
+  * retry and one decoder error, and no answer may reach the wrong request.
+  */
+TEST_F(EspLink_Loopback_Tests, RetriesThroughCorruptAndDroppedFrames) {
+  const int count = 1000;
+  const size_t tokenLast = ESPLINK_HEADER + 6;  // body offset of token[6]
+  const size_t flagsAt = ESPLINK_HEADER;        // body offset of the reply flags
+
+  Line reply;
+  EspLinkDecoder controller;  // the fixture's decoder is the bridge
+  uint8_t seq = 0;
+  int exchanges = 0, retries = 0, corruptRequests = 0, droppedReplies = 0, wrong = 0;
+
+  for (int i = 0; i < count; i++) {
+    uint8_t token[7] = {0x04, (uint8_t)(i >> 8), (uint8_t)i, 0x11, 0x22, 0x33, 0x44};
+    uint8_t expected = i % 2 ? 0x01 : 0x03;
+
+    for (;;) {
+      exchanges++;
+      seq = seq == 255 ? 1 : seq + 1;
+      espLinkSend(line, seq, ESPLINK_VERIFY, token, sizeof(token));
+      if (exchanges % 10 == 3) {
+        line.bytes[wireOffset(line.bytes, 0, tokenLast)] ^= 0x01;
+        corruptRequests++;
+      }
+
+      std::vector<ESPLINK_FRAME> in = line.drain(decoder);
+      if (in.empty()) {
+        retries++;
+        continue;
+      }
+      ASSERT_EQ(1U, in.size());
+
+      uint8_t flags = in[0].payload[2] % 2 ? 0x01 : 0x03;
+      espLinkSend(reply, in[0].seq, ESPLINK_VERIFY | ESPLINK_REPLY, &flags, 1);
+      if (exchanges % 15 == 7) {
+        reply.bytes.erase(reply.bytes.begin() + wireOffset(reply.bytes, 0, flagsAt));
+        droppedReplies++;
+      }
+
+      std::vector<ESPLINK_FRAME> out = reply.drain(controller);
+      if (out.empty()) {
+        retries++;
+        continue;
+      }
+      ASSERT_EQ(1U, out.size());
+      ASSERT_EQ(seq, out[0].seq);
+      if (out[0].payload[0] != expected) wrong++;
+      break;
+    }
+  }
+
+  EXPECT_EQ(0, wrong);
+  EXPECT_LT(0, corruptRequests);
+  EXPECT_LT(0, droppedReplies);
+  EXPECT_EQ(corruptRequests + droppedReplies, retries);
+  EXPECT_EQ(count + retries, exchanges);
+
+  // a flipped bit is a crc reject, a short frame is cut off by the next SOF
+  EXPECT_EQ(exchanges - corruptRequests, decoder.framesDecoded);
+  EXPECT_EQ(corruptRequests, decoder.crcErrors);
+  EXPECT_EQ(0, decoder.framingErrors);
+  EXPECT_EQ(count, controller.framesDecoded);
+  EXPECT_EQ(0, controller.crcErrors);
+  EXPECT_EQ(droppedReplies, controller.framingErrors);
+}
+
+TEST_F(EspLink_Loopback_Tests, TelemetryRecordFitsOneFrame) {
+  ESPLINK_TELEMETRY_RECORD record;
+  memset(&record, 0, sizeof(record));
+  record.uptime = 86400;
+  record.unlocks = 1234;
+  record.loopMax = 52000;
+
+  // same layout as the AVR, no padding
+  EXPECT_EQ(30U, sizeof(record));
+  ASSERT_GE(ESPLINK_MAX_PAYLOAD, (int)sizeof(record));
+
+  espLinkSend(line, 9, ESPLINK_TELEMETRY, (uint8_t *)&record, sizeof(record));
+  std::vector<ESPLINK_FRAME> frames = line.drain(decoder);
+
+  ASSERT_EQ(1U, frames.size());
+  ASSERT_EQ(sizeof(record), frames[0].length);
+  ESPLINK_TELEMETRY_RECORD received;
+  memcpy(&received, frames[0].payload, sizeof(received));
+  EXPECT_EQ(86400U, received.uptime);
+  EXPECT_EQ(1234U, received.unlocks);
+  EXPECT_EQ(52000U, received.loopMax);
+}
+
+TEST_F(EspLink_Loopback_Tests, LoopRecordFitsOneFrame) {
+  ESPLINK_LOOP_RECORD record;
+  memset(&record, 0, sizeof(record));
+  record.hist[0] = 65535;
+  record.hist[ESPLINK_LOOP_BUCKETS - 1] = 2;
+  record.longest = 5100000;
+  record.longestPhase = 1;
+  record.wdtGapMax = 5200;
+  record.wdtNearMisses = 2;
+
+  // same layout as the AVR, no padding
+  EXPECT_EQ(37U, sizeof(record));
+  ASSERT_GE(ESPLINK_MAX_PAYLOAD, (int)sizeof(record));
+
+  espLinkSend(line, 10, ESPLINK_LOOPSTATS, (uint8_t *)&record, sizeof(record));
+  std::vector<ESPLINK_FRAME> frames = line.drain(decoder);
+
+  ASSERT_EQ(1U, frames.size());
+  ASSERT_EQ(sizeof(record), frames[0].length);
+  ESPLINK_LOOP_RECORD received;
+  memcpy(&received, frames[0].payload, sizeof(received));
+  EXPECT_EQ(0, memcmp(&record, &received, sizeof(record)));
+}
@@ -0,0 +1,67 @@
+// FixedString formatting, as used for tokens and request urls
+
+#include <gtest/gtest.h>
+
+#include <FixedString.h>
+
+TEST(FixedString_Tests, FormatsSevenByteToken) {
+  char str[TOKEN_STR_SIZE];
+  uint8_t token[7] = {0x04, 0xa1, 0x0b, 0xff, 0x00, 0x80, 0x7e};
+
+  formatToken(str, token, 7);
+
+  EXPECT_STREQ("04a10bff00807e", str);
+}
+
+TEST(FixedString_Tests, FormatsFourByteTokenAndClearsTheRest) {
+  char str[TOKEN_STR_SIZE];
+  memset(str, 'x', sizeof(str));
+  uint8_t token[4] = {0xde, 0xad, 0xbe, 0xef};
+
+  formatToken(str, token, 4);
+
+  EXPECT_STREQ("deadbeef", str);
+  for (int i = 8; i < TOKEN_STR_SIZE; i++) EXPECT_EQ(0, str[i]);
+}
+
+TEST(FixedString_Tests, BuildsVerifyUrl) {
+  FixedString<96> url;
+  uint8_t token[4] = {0x01, 0x23, 0x45, 0x67};
+
+  url.append("/verify?token=").appendHex(token, 4).append("&thing=").append("DOOR");
+
+  EXPECT_STREQ("/verify?token=01234567&thing=DOOR", url.c_str());
+  EXPECT_EQ(strlen(url.c_str()), url.length());
+  EXPECT_FALSE(url.overflowed());
+}
+
+TEST(FixedString_Tests, AppendsNumbers) {
+  FixedString<64> s;
+
+  s.appendUInt(0).append(',').appendUInt(4294967295UL).append(',').appendInt(-2147483647 - 1);
+
+  EXPECT_STREQ("0,4294967295,-2147483648", s.c_str());
+}
+
+TEST(FixedString_Tests, UrlEncodesLikeAccessSystem) {
+  FixedString<64> s;
+
+  s.appendUrlEncoded("Machine powered up by:04a1 ok/1");
+
+  EXPECT_STREQ("Machine+powered+up+by%3A04a1+ok%2F1", s.c_str());
+}
+
+TEST(FixedString_Tests, TruncatesAndFlagsOverflow) {
+  FixedString<8> s;
+
+  s.append("abc").append("defgh").append('i');
+
+  EXPECT_STREQ("abcdefg", s.c_str());
+  EXPECT_EQ(7U, s.length());
+  EXPECT_EQ(7U, s.capacity());
+  EXPECT_TRUE(s.overflowed());
+
+  s.clear();
+  EXPECT_STREQ("", s.c_str());
+  EXPECT_FALSE(s.overflowed());
+}
@@ -0,0 +1,118 @@
+// HeapMonitor sampling and report export, with the ESP heap calls mocked
+
+#include <gtest/gtest.h>
+
+#include <HeapMonitor.h>
+#include <HeapMonitorMock.h>
+
+static void setHeap(uint32_t freeHeap, uint32_t maxFreeBlock, uint8_t fragmentation, uint32_t stackFree) {
+  mockHeapSample.freeHeap = freeHeap;
+  mockHeapSample.maxFreeBlock = maxFreeBlock;
+  mockHeapSample.fragmentation = fragmentation;
+  mockHeapSample.stackFree = stackFree;
+}
+
+TEST(LoopHistogram_Tests, BucketsAreLog2Milliseconds) {
+  EXPECT_EQ(0, LoopHistogram::bucketFor(0));
+  EXPECT_EQ(0, LoopHistogram::bucketFor(999));
+  EXPECT_EQ(1, LoopHistogram::bucketFor(1000));
+  EXPECT_EQ(1, LoopHistogram::bucketFor(1999));
+  EXPECT_EQ(2, LoopHistogram::bucketFor(2000));
+  EXPECT_EQ(11, LoopHistogram::bucketFor(1500000));
+  EXPECT_EQ(13, LoopHistogram::bucketFor(7900000));
+  EXPECT_EQ(LOOP_HISTOGRAM_BUCKETS - 1, LoopHistogram::bucketFor(0xFFFFFFFF));
+
+  for (uint8_t i = 0; i < LOOP_HISTOGRAM_BUCKETS; i++) {
+    EXPECT_EQ(i, LoopHistogram::bucketFor(LoopHistogram::bucketStartMs(i) * 1000));
+  }
+}
+
+TEST(LoopHistogram_Tests, CountsSaturate) {
+  LoopHistogram h;
+  for (uint32_t i = 0; i < 70000; i++) h.add(10);
+
+  EXPECT_EQ(0xFFFF, h.buckets[0]);
+  EXPECT_EQ(70000u, h.count);
+  EXPECT_EQ(10u, h.max);
+
+  h.clear();
+  EXPECT_EQ(0, h.buckets[0]);
+  EXPECT_EQ(0u, h.count);
+}
+
+TEST(HeapMonitor_Tests, KeepsWorstValuesUntilReset) {
+  HeapMonitor m;
+  setHeap(40000, 30000, 10, 3000);
+  m.loop(0, 0);
+
+  setHeap(20000, 8000, 60, 2500);
+  m.loop(1000000, 1000);
+
+  setHeap(35000, 25000, 20, 2800);
+  m.loop(2000000, 2000);
+
+  EXPECT_EQ(3, m.samples);
+  EXPECT_EQ(35000u, m.last.freeHeap);
+  EXPECT_EQ(20000u, m.worst.freeHeap);
+  EXPECT_EQ(8000u, m.worst.maxFreeBlock);
+  EXPECT_EQ(60, m.worst.fragmentation);
+  EXPECT_EQ(2500u, m.worst.stackFree);
+
+  m.reset(2000);
+  EXPECT_EQ(0, m.samples);
+  EXPECT_EQ(35000u, m.worst.freeHeap);
+  EXPECT_EQ(0u, m.loops.count);
+}
+
+TEST(HeapMonitor_Tests, SamplesOncePerIntervalAndReportsWhenDue) {
+  HeapMonitor m;
+  uint32_t ms = 5000;
+
+  EXPECT_FALSE(m.loop(ms * 1000, ms));
+  for (int i = 0; i < 100; i++) {
+    ms += 10;
+    EXPECT_FALSE(m.loop(ms * 1000, ms));
+  }
+  EXPECT_EQ(2, m.samples);
+  EXPECT_EQ(100u, m.loops.count);
+  EXPECT_EQ(100, m.loops.buckets[LoopHistogram::bucketFor(10000)]);
+
+  ms = 5000 + HEAP_REPORT_INTERVAL;
+  EXPECT_TRUE(m.loop(ms * 1000, ms));
+  m.reset(ms);
+  EXPECT_FALSE(m.loop(ms * 1000 + 10000, ms + 10));
+}
+
+TEST(HeapMonitor_Tests, ExportsJsonReport) {
+  HeapMonitor m;
+  setHeap(40000, 30000, 10, 3000);
+  m.loop(0, 0);
+  setHeap(21000, 9000, 55, 2600);
+  m.loop(3000000, 3000);    // a 3s loop
+
+  FixedString<HEAP_JSON_SIZE> json;
+  EXPECT_TRUE(m.toJson(json));
+
+  EXPECT_STREQ("{\"freeHeap\":21000,\"minFreeHeap\":21000"
+               ",\"maxFreeBlock\":9000,\"minMaxFreeBlock\":9000"
+               ",\"fragmentation\":55,\"maxFragmentation\":55"
+               ",\"stackFree\":2600,\"minStackFree\":2600"
+               ",\"samples\":2,\"loops\":1,\"loopMaxUs\":3000000"
+               ",\"loopHist\":[0,0,0,0,0,0,0,0,0,0,0,0,1,0]}", json.c_str());
+}
+
+TEST(HeapMonitor_Tests, WorstCaseReportFitsBuffer) {
+  HeapMonitor m;
+  setHeap(0xFFFFFFFF, 0xFFFFFFFF, 100, 0xFFFFFFFF);
+  m.sample();
+  for (uint8_t i = 0; i < LOOP_HISTOGRAM_BUCKETS; i++) {
+    for (uint32_t j = 0; j < 0x10000; j++) m.loops.add(LoopHistogram::bucketStartMs(i) * 1000);
+  }
+  m.loops.max = 0xFFFFFFFF;
+
+  FixedString<HEAP_JSON_SIZE> json;
+  EXPECT_TRUE(m.toJson(json));
+
+  FixedString<100> small;
+  EXPECT_FALSE(m.toJson(small));
+}
@@ -0,0 +1,180 @@
+// Drives the machineController session table through virtual time
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <sessionTable.h>
+
+struct Transition {
+  uint8_t from;
+  uint8_t to;
+  uint32_t at;
+};
+
+static std::vector<Transition> transitions;
+static uint32_t virtualNow;
+
+static void recordTransition(uint8_t from, uint8_t to) {
+  Transition t = {from, to, virtualNow};
+  transitions.push_back(t);
+}
+
+class MachineSession_Simulation_Tests : public testing::Test {
+ protected:
+  MachineSession_Simulation_Tests() : session(sessionTable, recordTransition) {}
+
+  virtual void SetUp() {
+    transitions.clear();
+    virtualNow = 1000;
+  }
+
+  // jump straight to each timed transition until the session is idle
+  void runUntilIdle() {
+    while (session.state() != SESSION_IDLE) {
+      virtualNow += session.timeRemaining(virtualNow);
+      session.loop(virtualNow);
+    }
+  }
+
+  void handle(uint8_t event) { session.handle(event, virtualNow); }
+
+  MachineSession session;
+};
+
+TEST_F(MachineSession_Simulation_Tests, StartsIdleWithNoTimeout) {
+  ASSERT_EQ(SESSION_IDLE, session.state());
+  ASSERT_EQ(SESSION_NO_TIMEOUT, session.timeRemaining(virtualNow));
+}
+
+TEST_F(MachineSession_Simulation_Tests, PrewarnsFireExactlyWhenDue) {
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+  uint32_t start = virtualNow;
+  runUntilIdle();
+
+  ASSERT_EQ(7U, transitions.size());
+  EXPECT_EQ(SESSION_AUTHORISING, transitions[0].to);
+  EXPECT_EQ(SESSION_ACTIVE, transitions[1].to);
+  EXPECT_EQ(SESSION_PREWARN1, transitions[2].to);
+  EXPECT_EQ(start + PREWARN1_TIME_MS, transitions[2].at);
+  EXPECT_EQ(SESSION_PREWARN2, transitions[3].to);
+  EXPECT_EQ(start + PREWARN2_TIME_MS, transitions[3].at);
+  EXPECT_EQ(SESSION_PREWARN3, transitions[4].to);
+  EXPECT_EQ(start + PREWARN3_TIME_MS, transitions[4].at);
+  EXPECT_EQ(SESSION_POWERING_DOWN, transitions[5].to);
+  EXPECT_EQ(start + ACTIVE_TIME_MS, transitions[5].at);
+  EXPECT_EQ(SESSION_IDLE, transitions[6].to);
+}
+
+TEST_F(MachineSession_Simulation_Tests, NothingFiresEarly) {
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+
+  for (uint32_t t = 0; t < PREWARN1_TIME_MS; t++) {
+    session.loop(virtualNow + t);
+  }
+  ASSERT_EQ(SESSION_ACTIVE, session.state());
+
+  session.loop(virtualNow + PREWARN1_TIME_MS);
+  ASSERT_EQ(SESSION_PREWARN1, session.state());
+}
+
+TEST_F(MachineSession_Simulation_Tests, LateLoopCatchesUpWithoutDrift) {
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+  uint32_t start = virtualNow;
+
+  // one loop call well after the session should have ended
+  virtualNow = start + ACTIVE_TIME_MS * 3;
+  session.loop(virtualNow);
+
+  ASSERT_EQ(SESSION_IDLE, session.state());
+  ASSERT_EQ(ACTIVE_TIME_MS * 2, session.timeInState(virtualNow));
+}
+
+TEST_F(MachineSession_Simulation_Tests, CardDuringPrewarnExtendsSession) {
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+
+  virtualNow += PREWARN2_TIME_MS + 100;
+  session.loop(virtualNow);
+  ASSERT_EQ(SESSION_PREWARN2, session.state());
+
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+  ASSERT_EQ(SESSION_ACTIVE, session.state());
+  ASSERT_EQ(PREWARN1_TIME_MS, session.timeRemaining(virtualNow));
+
+  uint32_t extendedAt = virtualNow;
+  runUntilIdle();
+  EXPECT_EQ(extendedAt + ACTIVE_TIME_MS, transitions[transitions.size() - 2].at);
+}
+
+TEST_F(MachineSession_Simulation_Tests, DeniedCardPowersDown) {
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+  handle(SESSION_CARD);
+  handle(SESSION_DENIED);
+
+  ASSERT_EQ(SESSION_POWERING_DOWN, session.state());
+  session.loop(virtualNow);
+  ASSERT_EQ(SESSION_IDLE, session.state());
+}
+
+TEST_F(MachineSession_Simulation_Tests, ButtonPowersDownImmediately) {
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+  virtualNow += PREWARN1_TIME_MS;
+  session.loop(virtualNow);
+
+  handle(SESSION_BUTTON);
+  ASSERT_EQ(SESSION_POWERING_DOWN, session.state());
+  session.loop(virtualNow);
+  ASSERT_EQ(SESSION_IDLE, session.state());
+}
+
+TEST_F(MachineSession_Simulation_Tests, IgnoresEventsThatDontApply) {
+  handle(SESSION_GRANTED);
+  handle(SESSION_DENIED);
+  ASSERT_EQ(SESSION_IDLE, session.state());
+  ASSERT_EQ(0U, transitions.size());
+}
+
+TEST_F(MachineSession_Simulation_Tests, SurvivesMillisRollover) {
+  // millis() wraps to 0 halfway to the first prewarn
+  virtualNow = 0xFFFFFFFFUL - PREWARN1_TIME_MS / 2;
+  handle(SESSION_CARD);
+  handle(SESSION_GRANTED);
+  uint32_t start = virtualNow;
+
+  // nothing fires at the wrap
+  virtualNow = 0;
+  session.loop(virtualNow);
+  ASSERT_EQ(SESSION_ACTIVE, session.state());
+  ASSERT_EQ(PREWARN1_TIME_MS / 2 + 1, session.timeInState(virtualNow));
+
+  runUntilIdle();
+  ASSERT_EQ(7U, transitions.size());
+  EXPECT_EQ(SESSION_PREWARN1, transitions[2].to);
+  EXPECT_EQ(PREWARN1_TIME_MS - PREWARN1_TIME_MS / 2 - 1, transitions[2].at);
+  EXPECT_LT(transitions[2].at, start);
+  EXPECT_EQ(SESSION_POWERING_DOWN, transitions[5].to);
+  EXPECT_EQ(static_cast<uint32_t>(start + ACTIVE_TIME_MS), transitions[5].at);
+}
+
+TEST_F(MachineSession_Simulation_Tests, DayOfSessionsWithOneMillisecondTicks) {
+  // a swipe every 7s for the first minute of each hour, machine should
+  // stay on through the swipes and power down once each hour
+  unsigned int powerDowns = 0;
+  for (uint32_t t = 0; t < 24UL * 3600 * 1000; t++) {
+    virtualNow = t;
+    if (t % 3600000UL < 60000UL && t % 7000 == 0) {
+      handle(SESSION_CARD);
+      handle(SESSION_GRANTED);
+    }
+    uint8_t before = session.state();
+    session.loop(t);
+    if (before != SESSION_IDLE && session.state() == SESSION_IDLE) powerDowns++;
+  }
+  ASSERT_EQ(24U, powerDowns);
+}
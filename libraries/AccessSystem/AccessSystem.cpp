@@ -1,13 +1,19 @@
 #include "AccessSystem.h"
 #include <ESP8266WiFi.h>
 #include <ArduinoJson.h>
+#include <FixedString.h>
 
-AccessSystem::AccessSystem(String thingId) :
+AccessSystem::AccessSystem(const char *thingId) :
     thingId(thingId)
 { }
 
+void AccessSystem::sendRequest(WiFiClient &client, const char *request, size_t length)
+{
+    client.write((const uint8_t *)request, length);
+}
+
 // send a log msg to the server, fire and forget
-void AccessSystem::sendLogMsg(String msg) 
+void AccessSystem::sendLogMsg(const char *msg, const char *token)
 {
     Serial.print(F("sendLogMsg: "));
  
@@ -23,18 +29,20 @@ void AccessSystem::sendLogMsg(String msg)
       return;
     }
  
-    String url = ACCESS_SYSTEM_URLPREFIX;
-    url += "msglog?thing=";
-    url += thingId;
-    url += "&msg=";
-    url += urlencode(msg);
+    FixedString<ACCESS_SYSTEM_REQUEST_SIZE> request;
+    request.append("GET " ACCESS_SYSTEM_URLPREFIX "msglog?thing=").append(thingId);
+    request.append("&msg=").appendUrlEncoded(msg);
+    if (token != NULL) {
+      request.appendUrlEncoded(token);
+    }
  
-    Serial.print(url);
+    Serial.print(request.c_str() + 4);
  
     // This will send the request to the server
-    client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                 "Host: " + ACCESS_SYSTEM_HOST + "\r\n" +
-                 "Connection: close\r\n\r\n");
+    request.append(" HTTP/1.1\r\n"
+                   "Host: " ACCESS_SYSTEM_HOST "\r\n"
+                   "Connection: close\r\n\r\n");
+    sendRequest(client, request.c_str(), request.length());
  
     // don't care if it succeeds, so close connection and return
     client.flush();
@@ -44,8 +52,63 @@ void AccessSystem::sendLogMsg(String msg)
     return;
  }
 
+// post a json body to the server, returns true if the server accepted it
+bool AccessSystem::post(const char *endpoint, const char *json)
+{
+    Serial.print(F("post: "));
+
+    // check if connected
+    if ( WiFi.status() != WL_CONNECTED ) {
+      Serial.println(F("Error: WiFi Not Connected"));
+      return false;
+    }
+
+    WiFiClient client;
+    if (!client.connect(ACCESS_SYSTEM_HOST, ACCESS_SYSTEM_PORT)) {
+      Serial.println(F("Error: Connection failed"));
+      return false;
+    }
+
+    size_t jsonLength = strlen(json);
+
+    FixedString<ACCESS_SYSTEM_REQUEST_SIZE> request;
+    request.append("POST " ACCESS_SYSTEM_URLPREFIX).append(endpoint);
+    request.append("?thing=").append(thingId);
+
+    Serial.print(request.c_str() + 5);
+
+    // This will send the request to the server
+    request.append(" HTTP/1.1\r\n"
+                   "Host: " ACCESS_SYSTEM_HOST "\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: ").appendUInt(jsonLength);
+    request.append("\r\nConnection: close\r\n\r\n");
+    sendRequest(client, request.c_str(), request.length());
+    sendRequest(client, json, jsonLength);
+
+    int checkCounter = 0;
+    while (!client.available() && checkCounter < ACCESS_SYSTEM_TIMEOUT) {
+      delay(10);
+      checkCounter++;
+    }
+
+    // status line is "HTTP/1.1 200 OK" if accepted
+    bool ok = false;
+    if (client.available()) {
+      char status[64];
+      size_t n = client.readBytesUntil('\n', status, sizeof(status) - 1);
+      status[n] = 0;
+      ok = strstr(status, " 200 ") != NULL;
+    }
+
+    client.stop();
+
+    Serial.println(ok ? F(":ok") : F(":failed"));
+    return ok;
+}
+
  // query server for token, and return flags
-uint8_t AccessSystem::getAccess(String cardID) 
+uint8_t AccessSystem::getAccess(const char *cardID)
 {
     Serial.print("getAccess:");
     Serial.print(ACCESS_SYSTEM_HOST);
@@ -67,19 +130,20 @@ uint8_t AccessSystem::getAccess(String cardID)
     }
  
     // We now create a URI for the request
-    String url = ACCESS_SYSTEM_URLPREFIX;
-    url += "verify";
-    url += "?token=";
-    url += cardID;
-    url += "&thing=";
-    url += thingId;
+    FixedString<ACCESS_SYSTEM_REQUEST_SIZE> request;
+    request.append("GET " ACCESS_SYSTEM_URLPREFIX "verify?token=").append(cardID);
+    request.append("&thing=").append(thingId);
  
-    Serial.println(url);
+    Serial.println(request.c_str() + 4);
  
     // This will send the request to the server
-    client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                 "Host: " + ACCESS_SYSTEM_HOST + "\r\n" +
-                 "Connection: close\r\n\r\n");
+    // MessagePack if the server has it, it's smaller and parses without any text to scan
+    request.append(" HTTP/1.1\r\n"
+                   "Host: " ACCESS_SYSTEM_HOST "\r\n"
+                   "Accept: application/msgpack, application/json\r\n"
+                   "Connection: close\r\n\r\n");
+    sendRequest(client, request.c_str(), request.length());
+
     int checkCounter = 0;
     while (!client.available() && checkCounter < ACCESS_SYSTEM_TIMEOUT) {
       delay(10);
@@ -88,42 +152,52 @@ uint8_t AccessSystem::getAccess(String cardID)
  
     // Read reply and decode json
     if (client.available()) {
-      while(client.available()){
-
-        String json;
-        boolean endOfHeaders = false;
-        while (!endOfHeaders && client.available()) {
-          yield();
-
-          json = client.readStringUntil('\n');
-          if (json == "") endOfHeaders = true;
-        }
-   
-        Serial.println(json);
-
-        StaticJsonBuffer<200> jsonBuffer;
-   
-        JsonObject& root = jsonBuffer.parseObject(json);
-   
-        // Test if parsing succeeds.
-        if (!root.success()) {
-          Serial.println("Error: Couldn't parse JSON");
-          return TOKEN_ERROR;
-        }
- 
-        if (!root.containsKey("access")) {
-          Serial.println("Error: No access info");
+      // the body follows the headers, the Content-Type says how it's encoded
+      bool msgPack = false;
+      char line[64];
+      bool continued = false;   // the last read stopped at the end of line, not at '\n'
+      for (;;) {
+        size_t n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+        if (n == 0) {
+          Serial.println("Error: No response body");
           return TOKEN_ERROR;
         }
-        
-        // Check json response for access permission
-        if (root["access"] == 1)
-          flags |= TOKEN_ACCESS;
-   
-        if (root["trainer"] == 1)
-          flags |= TOKEN_TRAINER;
+        line[n] = 0;
+        if (!continued && n == 1 && line[0] == '\r') break;
+        if (!continued && strncasecmp(line, "Content-Type:", 13) == 0)
+          msgPack = strstr(line, "msgpack") != NULL;
+        continued = n == sizeof(line) - 1;
+      }
+
+      StaticJsonBuffer<200> jsonBuffer;
+
+      // parses straight from the socket, keeping only the members used here
+      // so extra fields from the server don't overflow jsonBuffer
+      static const char *keys[] = {"access", "trainer", NULL};
+      JsonObject& root = msgPack ? jsonBuffer.parseMsgPackObject(client, JsonFilter(keys))
+                                 : jsonBuffer.parseObject(client, JsonFilter(keys));
+
+      // Test if parsing succeeds.
+      if (!root.success()) {
+        Serial.println(msgPack ? "Error: Couldn't parse MessagePack" : "Error: Couldn't parse JSON");
+        return TOKEN_ERROR;
+      }
+
+      root.printTo(Serial);
+      Serial.println();
+
+      if (!root.containsKey("access")) {
+        Serial.println("Error: No access info");
+        return TOKEN_ERROR;
       }
-      
+
+      // Check json response for access permission
+      if (root["access"] == 1)
+        flags |= TOKEN_ACCESS;
+
+      if (root["trainer"] == 1)
+        flags |= TOKEN_TRAINER;
+
     } else {
      flags = TOKEN_ERROR;
     }
@@ -132,4 +206,4 @@ uint8_t AccessSystem::getAccess(String cardID)
     client.stop();
  
     return flags;
- }
\ No newline at end of file
+ }
@@ -0,0 +1,236 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+// Parse and print costs of the documents the access controllers exchange:
+//   verify reply  {"access":1,"trainer":0}, from GET /verify
+//   batch reply   {"<hex>":<flags>,...}, 32 tokens, a whole token cache
+//   telemetry     the object thingWifi's telemetryJson() posts
+//
+//   JsonBenchmarks [results.json]
+//
+// For each document it measures
+//   parse         parseObject() in place, from a fresh copy of the text
+//   stream parse  parseObject(std::istream&), strings copied into the buffer
+//   the JsonBuffer bytes each parse consumed, what a StaticJsonBuffer needs
+//   print and prettyPrint, from the parsed tree into a char buffer
+// Each time is the best of several rounds, in ns per operation.
+// A table goes to stdout and the same results, as JSON, to the file.
+
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define BENCH_ROUNDS 7
+#define BENCH_ROUND_BYTES 4000000  // bytes of document per round
+
+static double nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+static std::string printed(const JsonObject& root) {
+  std::string json(root.measureLength() + 1, '\0');
+  root.printTo(&json[0], json.size());
+  json.resize(json.size() - 1);
+  return json;
+}
+
+static std::string verifyReply() { return "{\"access\":1,\"trainer\":0}"; }
+
+// the tokens look like loadGen's, 7 byte UIDs
+static std::string batchReply() {
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& root = jsonBuffer.createObject();
+  std::vector<std::string> tokens(32);
+  for (size_t i = 0; i < tokens.size(); i++) {
+    char token[16];
+    snprintf(token, sizeof(token), "04f1ee70%06x", static_cast<unsigned>(i));
+    tokens[i] = token;
+    root[tokens[i].c_str()] = i % 7 == 0 ? 3 : 1;
+  }
+  return printed(root);
+}
+
+// a door that has been up for a week
+static std::string telemetry() {
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& root = jsonBuffer.createObject();
+  root["uptime"] = 604800;
+  root["unlocks"] = 1372;
+  root["pn532Resets"] = 2;
+  root["espResets"] = 0;
+  root["cacheHits"] = 1291;
+  root["cacheMisses"] = 81;
+  root["cacheHitRatio"] = 1291.0 / (1291 + 81);
+  root["loops"] = 96234120;
+  root["loopAvgUs"] = 6284;
+  root["loopMaxUs"] = 52108;
+  root["linkErrors"] = 3;
+  root["bridgeUptime"] = 604795;
+  root["bridgeLinkErrors"] = 1;
+  root["droppedLogs"] = 0;
+  return printed(root);
+}
+
+// Runs op() enough times per round for the timer not to matter and
+// returns the best ns per call; op() returns false on failure.
+template <typename TOp>
+static double bestNs(size_t bytes, TOp& op) {
+  size_t repeat = BENCH_ROUND_BYTES / bytes + 1;
+  double best = 0;
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    double start = nowNs();
+    for (size_t i = 0; i < repeat; i++) {
+      if (!op()) return -1;
+    }
+    double ns = (nowNs() - start) / static_cast<double>(repeat);
+    if (round == 0 || ns < best) best = ns;
+  }
+  return best;
+}
+
+struct InPlaceParse {
+  explicit InPlaceParse(const std::string& json)
+      : _json(json), _copy(json.size() + 1), consumed(0) {}
+
+  bool operator()() {
+    memcpy(&_copy[0], _json.c_str(), _copy.size());
+    DynamicJsonBuffer jsonBuffer;
+    bool ok = jsonBuffer.parseObject(&_copy[0]).success();
+    consumed = jsonBuffer.size();
+    return ok;
+  }
+
+  const std::string& _json;
+  std::vector<char> _copy;
+  size_t consumed;
+};
+
+struct StreamParse {
+  explicit StreamParse(const std::string& json) : _json(json), consumed(0) {}
+
+  bool operator()() {
+    std::istringstream stream(_json);
+    DynamicJsonBuffer jsonBuffer;
+    bool ok = jsonBuffer.parseObject(stream).success();
+    consumed = jsonBuffer.size();
+    return ok;
+  }
+
+  const std::string& _json;
+  size_t consumed;
+};
+
+struct Printing {
+  Printing(const JsonObject& root, bool pretty)
+      : _root(root),
+        _pretty(pretty),
+        _out((pretty ? root.measurePrettyLength() : root.measureLength()) + 1),
+        length(0) {}
+
+  bool operator()() {
+    length = _pretty ? _root.prettyPrintTo(&_out[0], _out.size())
+                     : _root.printTo(&_out[0], _out.size());
+    return length > 0;
+  }
+
+  const JsonObject& _root;
+  bool _pretty;
+  std::vector<char> _out;
+  size_t length;
+};
+
+static double megabytesPerSecond(size_t bytes, double ns) {
+  return static_cast<double>(bytes) * 1e3 / ns;
+}
+
+static bool bench(const char* name, const std::string& json,
+                  JsonArray& results) {
+  InPlaceParse parse(json);
+  double parseNs = bestNs(json.size(), parse);
+
+  StreamParse streamParse(json);
+  double streamParseNs = bestNs(json.size(), streamParse);
+
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& root = jsonBuffer.parseObject(json.c_str());
+  if (parseNs < 0 || streamParseNs < 0 || !root.success()) return false;
+
+  Printing print(root, false);
+  double printNs = bestNs(json.size(), print);
+  Printing prettyPrint(root, true);
+  double prettyPrintNs = bestNs(json.size(), prettyPrint);
+  if (print.length != json.size()) return false;
+
+  printf("%-14s %6u %10.0f %6u %10.0f %6u %10.1f %10.1f\n", name,
+         static_cast<unsigned>(json.size()), parseNs,
+         static_cast<unsigned>(parse.consumed), streamParseNs,
+         static_cast<unsigned>(streamParse.consumed),
+         megabytesPerSecond(print.length, printNs),
+         megabytesPerSecond(prettyPrint.length, prettyPrintNs));
+
+  JsonObject& result = results.createNestedObject();
+  result["document"] = name;
+  result["bytes"] = json.size();
+  result["parseNs"] = parseNs;
+  result["parseJsonBufferBytes"] = parse.consumed;
+  result["streamParseNs"] = streamParseNs;
+  result["streamParseJsonBufferBytes"] = streamParse.consumed;
+  result["printNs"] = printNs;
+  result["printMBps"] = megabytesPerSecond(print.length, printNs);
+  result["prettyPrintBytes"] = prettyPrint.length;
+  result["prettyPrintNs"] = prettyPrintNs;
+  result["prettyPrintMBps"] =
+      megabytesPerSecond(prettyPrint.length, prettyPrintNs);
+  return true;
+}
+
+int main(int argc, const char* argv[]) {
+  const char* path = argc > 1 ? argv[1] : "benchmarks.json";
+
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& root = jsonBuffer.createObject();
+#if !ARDUINOJSON_ENABLE_SIMD
+  root["scanner"] = "scalar";
+#elif defined(__AVX2__)
+  root["scanner"] = "AVX2";
+#else
+  root["scanner"] = "SSE2";
+#endif
+  JsonArray& results = root.createNestedArray("results");
+
+  printf("%-14s %6s %10s %6s %10s %6s %10s %10s\n", "document", "bytes",
+         "parse ns", "JB", "stream ns", "JB", "print MB/s", "pretty MB/s");
+
+  std::string verify = verifyReply(), batch = batchReply(),
+              telemetryJson = telemetry();
+  if (!bench("verify reply", verify, results) ||
+      !bench("batch reply", batch, results) ||
+      !bench("telemetry", telemetryJson, results)) {
+    fprintf(stderr, "a document failed to parse or print\n");
+    return 1;
+  }
+
+  std::string output;
+  root.prettyPrintTo(output);
+  std::ofstream file(path);
+  file << output << '\n';
+  if (!file) {
+    fprintf(stderr, "can't write %s\n", path);
+    return 1;
+  }
+  printf("\nresults in %s\n", path);
+  return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+// How fast the parser goes through long strings, indentation and unquoted
+// values, with the scanner the build selected.
+// ScanBenchmark uses CharScanner as configured, ScanBenchmarkScalar is the
+// same program built with ARDUINOJSON_ENABLE_SIMD=0; compare their outputs.
+//
+// It reports
+//   the MB/s of each scanner function alone, ScalarScanner against CharScanner
+//   the MB/s of parseObject() on documents made of the runs the scanner takes
+
+#include <ArduinoJson.h>
+#include <ArduinoJson/Internals/CharScanner.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+using namespace ArduinoJson::Internals;
+
+#define BENCH_BYTES 200000000  // bytes scanned or parsed per measurement
+
+static double nowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<double>(ts.tv_sec) * 1e6 +
+         static_cast<double>(ts.tv_nsec) / 1e3;
+}
+
+static double megabytesPerSecond(size_t bytes, double us) {
+  return static_cast<double>(bytes) / us;
+}
+
+// Runs of 4 KB, so that the loop overhead does not matter
+// The pointer is volatile so that the compiler scans the run every time.
+template <typename TScanner>
+static size_t scanAll(const std::string& run, int which) {
+  const char* volatile input = run.c_str();
+  size_t total = 0;
+  for (size_t done = 0; done < BENCH_BYTES; done += run.size()) {
+    const char* s = input;
+    const char* end = s + run.size() + 1;
+    if (which == 0) total += TScanner::stringRun(s, end, '"');
+    if (which == 1) total += TScanner::spaces(s, end);
+    if (which == 2) total += TScanner::word(s, end);
+  }
+  return total;
+}
+
+static void benchScanner(const char* name, const std::string& run, int which) {
+  double start = nowUs();
+  size_t scalar = scanAll<ScalarScanner>(run, which);
+  double scalarUs = nowUs() - start;
+
+  start = nowUs();
+  size_t vector = scanAll<CharScanner>(run, which);
+  double vectorUs = nowUs() - start;
+
+  if (scalar != vector) fprintf(stderr, "%s: the scanners disagree\n", name);
+  printf("%-22s %10.0f %10.0f\n", name, megabytesPerSecond(scalar, scalarUs),
+         megabytesPerSecond(vector, vectorUs));
+}
+
+// An object of 16 members whose values look like what the parser meets; the
+// lists walk to their end on every add, bigger objects would measure that.
+static std::string document(const char* kind) {
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& root = jsonBuffer.createObject();
+  std::vector<std::string> strings(16);
+  for (size_t i = 0; i < strings.size(); i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%u", static_cast<unsigned>(i));
+    strings[i] = key;
+  }
+  for (size_t i = 0; i < strings.size(); i++) {
+    if (!strcmp(kind, "numbers"))
+      root[strings[i].c_str()] = 1234567.0 * static_cast<double>(i) + 0.125;
+    else if (!strcmp(kind, "long strings"))
+      root[strings[i].c_str()] =
+          "Permission granted to a member on the lathe, the session started "
+          "at half past nine and the token was read twice";
+    else
+      root[strings[i].c_str()] = "04f1ee70000001";
+  }
+
+  std::string json(root.measurePrettyLength() + 1, '\0');
+  if (!strcmp(kind, "indented"))
+    root.prettyPrintTo(&json[0], json.size());
+  else {
+    json.resize(root.measureLength() + 1);
+    root.printTo(&json[0], json.size());
+  }
+  json.resize(json.size() - 1);
+  return json;
+}
+
+static bool benchParser(const char* kind) {
+  std::string json = document(kind);
+  std::vector<char> copy(json.size() + 1);
+  int repeat = static_cast<int>(BENCH_BYTES / 10 / json.size());
+
+  double start = nowUs();
+  for (int i = 0; i < repeat; i++) {
+    memcpy(&copy[0], json.c_str(), copy.size());
+    DynamicJsonBuffer jsonBuffer;
+    if (!jsonBuffer.parseObject(&copy[0]).success()) return false;
+  }
+  double us = nowUs() - start;
+
+  printf("%-22s %10u %10.0f\n", kind, static_cast<unsigned>(json.size()),
+         megabytesPerSecond(json.size() * static_cast<size_t>(repeat), us));
+  return true;
+}
+
+int main() {
+#if !ARDUINOJSON_ENABLE_SIMD
+  const char* scanner = "scalar";
+#elif defined(__AVX2__)
+  const char* scanner = "AVX2";
+#else
+  const char* scanner = "SSE2";
+#endif
+  printf("CharScanner: %s\n\n", scanner);
+
+  printf("%-22s %10s %10s\n", "scanner, MB/s", "scalar", "CharScanner");
+  benchScanner("string run", std::string(4096, 'x'), 0);
+  benchScanner("spaces", std::string(4096, ' '), 1);
+  benchScanner("unquoted value", std::string(4096, '7'), 2);
+
+  printf("\n%-22s %10s %10s\n", "parseObject()", "bytes", "MB/s");
+  const char* kinds[] = {"tokens", "long strings", "indented", "numbers"};
+  for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+    if (!benchParser(kinds[i])) {
+      fprintf(stderr, "%s: parseObject() failed\n", kinds[i]);
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -10,4 +10,8 @@
 #include "ArduinoJson/JsonObject.hpp"
 #include "ArduinoJson/StaticJsonBuffer.hpp"
 
+#if __cplusplus >= 201103L
+#include "ArduinoJson/JsonBinding.hpp"
+#endif
+
 using namespace ArduinoJson;
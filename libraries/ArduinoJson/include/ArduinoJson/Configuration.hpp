@@ -37,6 +37,11 @@
 #endif
 #endif
 
+// the microcontrollers have no vector instructions
+#ifndef ARDUINOJSON_ENABLE_SIMD
+#define ARDUINOJSON_ENABLE_SIMD 0
+#endif
+
 #else  // assume this is a computer
 
 // on a computer we have plenty of memory so we can use doubles
@@ -72,6 +77,26 @@
 #define ARDUINOJSON_ENABLE_ALIGNMENT 1
 #endif
 
+// scan strings and spaces 16 bytes at a time with SSE2, 32 with AVX2 when the
+// compiler targets it (-mavx2 or -march=native)
+#ifndef ARDUINOJSON_ENABLE_SIMD
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define ARDUINOJSON_ENABLE_SIMD 1
+#else
+#define ARDUINOJSON_ENABLE_SIMD 0
+#endif
+#endif
+
+#endif
+
+// longest key of a JsonBinding field, longer keys in the input are skipped
+#ifndef ARDUINOJSON_BINDING_MAX_KEY
+#define ARDUINOJSON_BINDING_MAX_KEY 31
+#endif
+
+// longest number or boolean a JsonBinding reads
+#ifndef ARDUINOJSON_BINDING_MAX_VALUE
+#define ARDUINOJSON_BINDING_MAX_VALUE 31
 #endif
 
 #if ARDUINOJSON_USE_LONG_LONG && ARDUINOJSON_USE_INT64
@@ -56,6 +56,15 @@ class BlockJsonBuffer : public JsonBuffer {
     return canAllocInHead(bytes) ? allocInHead(bytes) : allocInNewBlock(bytes);
   }
 
+  virtual void* freeSpace(size_t& capacity) {
+    if (_head == NULL) {
+      capacity = 0;
+      return NULL;
+    }
+    capacity = _head->capacity - _head->size;
+    return _head->data + _head->size;
+  }
+
  private:
   bool canAllocInHead(size_t bytes) const {
     return _head != NULL && _head->size + bytes <= _head->capacity;
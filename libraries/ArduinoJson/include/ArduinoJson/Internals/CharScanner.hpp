@@ -0,0 +1,24 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../Configuration.hpp"
+#include "ScalarScanner.hpp"
+#include "SimdScanner.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// The scanner StringReader uses, see ARDUINOJSON_ENABLE_SIMD
+#if ARDUINOJSON_ENABLE_SIMD
+typedef SimdScanner CharScanner;
+#else
+typedef ScalarScanner CharScanner;
+#endif
+}
+}
@@ -9,6 +9,69 @@
 
 namespace ArduinoJson {
 namespace Internals {
-const char *skipSpacesAndComments(const char *ptr);
+template <typename TReader>
+void skipCStyleComment(TReader &reader) {
+  reader.move();
+  reader.move();
+  for (;;) {
+    switch (reader.current()) {
+      case '\0':
+        return;
+      case '*':
+        reader.move();
+        if (reader.current() == '/') {
+          reader.move();
+          return;
+        }
+        break;
+      default:
+        reader.move();
+    }
+  }
+}
+
+template <typename TReader>
+void skipCppStyleComment(TReader &reader) {
+  reader.move();
+  reader.move();
+  for (;;) {
+    switch (reader.current()) {
+      case '\0':
+      case '\n':
+        return;
+      default:
+        reader.move();
+    }
+  }
+}
+
+template <typename TReader>
+void skipSpacesAndComments(TReader &reader) {
+  for (;;) {
+    reader.skipSpaces();
+    switch (reader.current()) {
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        reader.move();
+        continue;
+      case '/':
+        switch (reader.next()) {
+          case '*':
+            skipCStyleComment(reader);
+            break;
+          case '/':
+            skipCppStyleComment(reader);
+            break;
+          default:
+            return;
+        }
+        break;
+      default:
+        return;
+    }
+  }
+}
 }
 }
@@ -0,0 +1,70 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+#include <string.h>  // for memcpy
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Writes the parsed strings in a char array chosen before each string.
+// Strings that don't fit are truncated.
+class FixedStringWriter {
+ public:
+  FixedStringWriter()
+      : _buffer(NULL), _capacity(0), _size(0), _truncated(false) {}
+
+  // The next strings go to buffer, size includes the null-terminator
+  void setBuffer(char *buffer, size_t size) {
+    _buffer = buffer;
+    _capacity = size;
+  }
+
+  void startString() {
+    _size = 0;
+    _truncated = false;
+  }
+
+  void append(char c) {
+    if (_size + 1 < _capacity)
+      _buffer[_size++] = c;
+    else
+      _truncated = true;
+  }
+
+  void append(const char *s, size_t n) {
+    size_t room = _size + 1 < _capacity ? _capacity - _size - 1 : 0;
+    if (n > room) {
+      n = room;
+      _truncated = true;
+    }
+    if (n == 0) return;
+    memcpy(_buffer + _size, s, n);
+    _size += n;
+  }
+
+  const char *terminate() {
+    _buffer[_size] = '\0';
+    return _buffer;
+  }
+
+  bool commit() { return true; }
+
+  const char *complete() { return terminate(); }
+
+  bool truncated() const { return _truncated; }
+
+ private:
+  char *_buffer;
+  size_t _capacity;
+  size_t _size;
+  bool _truncated;
+};
+}
+}
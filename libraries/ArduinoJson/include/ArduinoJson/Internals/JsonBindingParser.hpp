@@ -0,0 +1,115 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../Configuration.hpp"
+#include "../TypeTraits/IsFloatingPoint.hpp"
+#include "../TypeTraits/IsIntegral.hpp"
+#include "../TypeTraits/IsSame.hpp"
+#include "Comments.hpp"
+#include "FixedStringWriter.hpp"
+#include "JsonParser.ipp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// FNV-1a, evaluated at compile time for the keys of a JsonBinding
+constexpr uint32_t hashKey(const char *key, uint32_t hash = 2166136261u) {
+  return *key ? hashKey(key + 1,
+                        (hash ^ static_cast<uint8_t>(*key)) * 16777619u)
+              : hash;
+}
+
+// Parses a JSON object straight into a struct described by a JsonBinding.
+// This internal class is not indended to be used directly.
+// Instead, use JsonBinding.parse()
+//
+// Keys and numbers are read in buffers on the stack and strings in the char
+// arrays of the struct, nothing is allocated.
+template <typename TReader>
+class JsonBindingParser : public JsonParser<TReader, FixedStringWriter> {
+  typedef JsonParser<TReader, FixedStringWriter> base;
+
+ public:
+  JsonBindingParser(TReader reader, uint8_t nestingLimit)
+      : base(NULL, reader, FixedStringWriter(), nestingLimit) {}
+
+  template <typename TBinding, typename TStruct>
+  bool parseStruct(const TBinding &binding, TStruct &destination) {
+    if (!this->skip('{')) return false;
+    if (this->skip('}')) return true;
+
+    for (;;) {
+      // 1 - Parse key
+      char key[ARDUINOJSON_BINDING_MAX_KEY + 1];
+      this->_writer.setBuffer(key, sizeof(key));
+      this->parseString();
+      if (!this->skip(':')) return false;
+
+      // 2 - Parse value in the matching field, or skip it
+      bool found = false;
+      if (!this->_writer.truncated() &&
+          !binding.parseMember(*this, hashKey(key), key, destination, found))
+        return false;
+      if (!found && !this->skipAnything()) return false;
+
+      // 3 - More keys/values?
+      if (this->skip('}')) return true;
+      if (!this->skip(',')) return false;
+    }
+  }
+
+  template <typename TBinding, typename TStruct>
+  bool parseNested(const TBinding &binding, TStruct &destination) {
+    if (this->_nestingLimit == 0) return false;
+    this->_nestingLimit--;
+    bool success = parseStruct(binding, destination);
+    this->_nestingLimit++;
+    return success;
+  }
+
+  // Strings are truncated to the size of the array
+  template <size_t N>
+  bool parseValue(char (&destination)[N]) {
+    if (!isScalar()) return false;
+    bool hasQuotes = base::isQuote(this->_reader.current());
+    this->_writer.setBuffer(destination, N);
+    this->parseString();
+    if (!hasQuotes && !strcmp(destination, "null")) destination[0] = '\0';
+    return true;
+  }
+
+  // Numbers and booleans are converted as JsonVariant::as<T>() does
+  template <typename T>
+  bool parseValue(T &destination) {
+    static_assert(TypeTraits::IsIntegral<T>::value ||
+                      TypeTraits::IsFloatingPoint<T>::value ||
+                      TypeTraits::IsSame<T, bool>::value,
+                  "JsonBinding fields must be numbers, bool, char arrays or "
+                  "structs with a binding");
+    if (!isScalar()) return false;
+    bool hasQuotes = base::isQuote(this->_reader.current());
+    char value[ARDUINOJSON_BINDING_MAX_VALUE + 1];
+    this->_writer.setBuffer(value, sizeof(value));
+    this->parseString();
+    if (this->_writer.truncated()) return false;
+    JsonVariant variant =
+        hasQuotes ? JsonVariant(value) : JsonVariant(Unparsed(value));
+    destination = variant.as<T>();
+    return true;
+  }
+
+ private:
+  bool isScalar() {
+    skipSpacesAndComments(this->_reader);
+    char c = this->_reader.current();
+    return c != '{' && c != '[';
+  }
+};
+}
+}
@@ -0,0 +1,85 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../JsonBuffer.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Writes the parsed strings in the JsonBuffer.
+// Used when the input can't be modified, for example when reading a stream.
+//
+// The string is written in the free space at the end of the buffer and only
+// allocated once complete, so it takes exactly its length.
+// If it doesn't fit, it moves to a bigger allocation.
+class JsonBufferStringWriter {
+ public:
+  explicit JsonBufferStringWriter(JsonBuffer *buffer)
+      : _buffer(buffer),
+        _start(NULL),
+        _size(0),
+        _capacity(0),
+        _allocated(false),
+        _failed(false) {}
+
+  void startString() {
+    _start = static_cast<char *>(_buffer->freeSpace(_capacity));
+    _size = 0;
+    _allocated = false;
+    _failed = false;
+  }
+
+  void append(char c) {
+    if (_size == _capacity && !grow()) return;
+    _start[_size++] = c;
+  }
+
+  // Ends the string without allocating it, so the next string may overwrite
+  // it unless commit() is called first.
+  // Returns NULL if the buffer is full
+  const char *terminate() {
+    if (_size == _capacity && !grow()) return NULL;
+    _start[_size++] = '\0';
+    return _start;
+  }
+
+  // Allocates the terminated string in the JsonBuffer
+  bool commit() { return _allocated || _buffer->alloc(_size) != NULL; }
+
+  // Returns NULL if the buffer is full
+  const char *complete() {
+    const char *s = terminate();
+    return s != NULL && commit() ? s : NULL;
+  }
+
+ private:
+  bool grow() {
+    if (_failed) return false;
+    size_t capacity = _capacity < 16 ? 32 : _capacity * 2;
+    char *p = static_cast<char *>(_buffer->alloc(capacity));
+    if (p == NULL) {
+      _failed = true;
+      return false;
+    }
+    if (_size > 0) memcpy(p, _start, _size);
+    _start = p;
+    _capacity = capacity;
+    _allocated = true;
+    return true;
+  }
+
+  JsonBuffer *_buffer;
+  char *_start;
+  size_t _size;
+  size_t _capacity;
+  bool _allocated;
+  bool _failed;
+};
+}
+}
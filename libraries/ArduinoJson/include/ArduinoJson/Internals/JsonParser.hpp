@@ -8,6 +8,7 @@
 #pragma once
 
 #include "../JsonBuffer.hpp"
+#include "../JsonFilter.hpp"
 #include "../JsonVariant.hpp"
 
 namespace ArduinoJson {
@@ -16,21 +17,40 @@ namespace Internals {
 // Parse JSON string to create JsonArrays and JsonObjects
 // This internal class is not indended to be used directly.
 // Instead, use JsonBuffer.parseArray() or .parseObject()
+//
+// TReader supplies the characters (see StringReader and StreamReader),
+// TWriter stores the strings (see StringWriter and JsonBufferStringWriter).
+template <typename TReader, typename TWriter>
 class JsonParser {
  public:
-  JsonParser(JsonBuffer *buffer, char *json, uint8_t nestingLimit)
-      : _buffer(buffer),
-        _readPtr(json ? json : ""),
-        _writePtr(json),
-        _nestingLimit(nestingLimit) {}
+  JsonParser(JsonBuffer *buffer, TReader reader, TWriter writer,
+             uint8_t nestingLimit)
+      : _reader(reader),
+        _writer(writer),
+        _nestingLimit(nestingLimit),
+        _buffer(buffer) {}
 
   JsonArray &parseArray();
-  JsonObject &parseObject();
 
- private:
-  bool skip(char charToSkip);
+  // Members missing from filter are skipped, unless filter is NULL
+  JsonObject &parseObject(const JsonFilter *filter = NULL);
 
+ protected:
+  // For parsers that don't build a JsonObject, such as JsonBindingParser
+  bool skip(char charToSkip);
   const char *parseString();
+
+  // Same syntax checks as parsing, but nothing is stored
+  bool skipAnything();
+
+  static inline bool isQuote(char c) { return c == '\'' || c == '\"'; }
+
+  TReader _reader;
+  TWriter _writer;
+  uint8_t _nestingLimit;
+
+ private:
+  void readString(bool store);
   bool parseAnythingTo(JsonVariant *destination);
   FORCE_INLINE bool parseAnythingToUnsafe(JsonVariant *destination);
 
@@ -38,10 +58,19 @@ class JsonParser {
   inline bool parseObjectTo(JsonVariant *destination);
   inline bool parseStringTo(JsonVariant *destination);
 
+  inline bool skipArray();
+  inline bool skipObject();
+
+  static inline bool isInRange(char c, char min, char max) {
+    return min <= c && c <= max;
+  }
+
+  static inline bool isLetterOrNumber(char c) {
+    return isInRange(c, '0', '9') || isInRange(c, 'a', 'z') ||
+           isInRange(c, 'A', 'Z') || c == '-' || c == '.';
+  }
+
   JsonBuffer *_buffer;
-  const char *_readPtr;
-  char *_writePtr;
-  uint8_t _nestingLimit;
 };
 }
 }
@@ -0,0 +1,267 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "Comments.hpp"
+#include "Encoding.hpp"
+#include "JsonParser.hpp"
+#include "../JsonArray.hpp"
+#include "../JsonBuffer.hpp"
+#include "../JsonObject.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Only skips the spaces before the character, so that a stream isn't read
+// past the end of the document.
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::skip(char charToSkip) {
+  skipSpacesAndComments(_reader);
+  if (_reader.current() != charToSkip) return false;
+  _reader.move();
+  return true;
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::parseAnythingTo(
+    JsonVariant *destination) {
+  if (_nestingLimit == 0) return false;
+  _nestingLimit--;
+  bool success = parseAnythingToUnsafe(destination);
+  _nestingLimit++;
+  return success;
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::parseAnythingToUnsafe(
+    JsonVariant *destination) {
+  skipSpacesAndComments(_reader);
+
+  switch (_reader.current()) {
+    case '[':
+      return parseArrayTo(destination);
+
+    case '{':
+      return parseObjectTo(destination);
+
+    default:
+      return parseStringTo(destination);
+  }
+}
+
+template <typename TReader, typename TWriter>
+inline JsonArray &JsonParser<TReader, TWriter>::parseArray() {
+  // Create an empty array
+  JsonArray &array = _buffer->createArray();
+
+  // Check opening braket
+  if (!skip('[')) goto ERROR_MISSING_BRACKET;
+  if (skip(']')) goto SUCCESS_EMPTY_ARRAY;
+
+  // Read each value
+  for (;;) {
+    // 1 - Parse value
+    JsonVariant value;
+    if (!parseAnythingTo(&value)) goto ERROR_INVALID_VALUE;
+    if (!array.add(value)) goto ERROR_NO_MEMORY;
+
+    // 2 - More values?
+    if (skip(']')) goto SUCCES_NON_EMPTY_ARRAY;
+    if (!skip(',')) goto ERROR_MISSING_COMMA;
+  }
+
+SUCCESS_EMPTY_ARRAY:
+SUCCES_NON_EMPTY_ARRAY:
+  return array;
+
+ERROR_INVALID_VALUE:
+ERROR_MISSING_BRACKET:
+ERROR_MISSING_COMMA:
+ERROR_NO_MEMORY:
+  return JsonArray::invalid();
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::parseArrayTo(
+    JsonVariant *destination) {
+  JsonArray &array = parseArray();
+  if (!array.success()) return false;
+
+  *destination = array;
+  return true;
+}
+
+template <typename TReader, typename TWriter>
+inline JsonObject &JsonParser<TReader, TWriter>::parseObject(
+    const JsonFilter *filter) {
+  // Create an empty object
+  JsonObject &object = _buffer->createObject();
+
+  // Check opening brace
+  if (!skip('{')) goto ERROR_MISSING_BRACE;
+  if (skip('}')) goto SUCCESS_EMPTY_OBJECT;
+
+  // Read each key value pair
+  for (;;) {
+    // 1 - Parse key, only allocated if the member is kept
+    skipSpacesAndComments(_reader);
+    _writer.startString();
+    readString(true);
+    const char *key = _writer.terminate();
+    if (!key) goto ERROR_INVALID_KEY;
+    if (!skip(':')) goto ERROR_MISSING_COLON;
+
+    if (filter && !filter->allows(key)) {
+      // 2 - Skip value
+      if (!skipAnything()) goto ERROR_INVALID_VALUE;
+    } else {
+      // 2 - Parse value
+      if (!_writer.commit()) goto ERROR_NO_MEMORY;
+      JsonVariant value;
+      if (!parseAnythingTo(&value)) goto ERROR_INVALID_VALUE;
+      if (!object.set(key, value)) goto ERROR_NO_MEMORY;
+    }
+
+    // 3 - More keys/values?
+    if (skip('}')) goto SUCCESS_NON_EMPTY_OBJECT;
+    if (!skip(',')) goto ERROR_MISSING_COMMA;
+  }
+
+SUCCESS_EMPTY_OBJECT:
+SUCCESS_NON_EMPTY_OBJECT:
+  return object;
+
+ERROR_INVALID_KEY:
+ERROR_INVALID_VALUE:
+ERROR_MISSING_BRACE:
+ERROR_MISSING_COLON:
+ERROR_MISSING_COMMA:
+ERROR_NO_MEMORY:
+  return JsonObject::invalid();
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::parseObjectTo(
+    JsonVariant *destination) {
+  JsonObject &object = parseObject();
+  if (!object.success()) return false;
+
+  *destination = object;
+  return true;
+}
+
+template <typename TReader, typename TWriter>
+inline void JsonParser<TReader, TWriter>::readString(bool store) {
+  char c = _reader.current();
+
+  if (isQuote(c)) {  // quotes
+    _reader.move();
+    char stopChar = c;
+    for (;;) {
+      _reader.readStringRun(_writer, stopChar, store);
+      c = _reader.current();
+      if (c == '\0') break;
+      _reader.move();
+
+      if (c == stopChar) break;
+
+      if (c == '\\') {
+        // replace char
+        c = Encoding::unescapeChar(_reader.current());
+        if (c == '\0') break;
+        _reader.move();
+      }
+
+      if (store) _writer.append(c);
+    }
+  } else {  // no quotes
+    _reader.readWord(_writer, store);
+    c = _reader.current();
+    for (;;) {
+      if (!isLetterOrNumber(c)) break;
+      if (store) _writer.append(c);
+      _reader.move();
+      c = _reader.current();
+    }
+  }
+}
+
+template <typename TReader, typename TWriter>
+inline const char *JsonParser<TReader, TWriter>::parseString() {
+  skipSpacesAndComments(_reader);
+  _writer.startString();
+  readString(true);
+
+  // end the string here and return it, NULL if it didn't fit
+  return _writer.complete();
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::parseStringTo(
+    JsonVariant *destination) {
+  bool hasQuotes = isQuote(_reader.current());
+  const char *value = parseString();
+  if (value == NULL) return false;
+  if (hasQuotes) {
+    *destination = value;
+  } else {
+    *destination = Unparsed(value);
+  }
+  return true;
+}
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::skipAnything() {
+  if (_nestingLimit == 0) return false;
+  _nestingLimit--;
+  bool success;
+  skipSpacesAndComments(_reader);
+  switch (_reader.current()) {
+    case '[':
+      success = skipArray();
+      break;
+
+    case '{':
+      success = skipObject();
+      break;
+
+    default:
+      readString(false);
+      success = true;
+  }
+  _nestingLimit++;
+  return success;
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::skipArray() {
+  if (!skip('[')) return false;
+  if (skip(']')) return true;
+
+  for (;;) {
+    if (!skipAnything()) return false;
+    if (skip(']')) return true;
+    if (!skip(',')) return false;
+  }
+}
+
+template <typename TReader, typename TWriter>
+inline bool JsonParser<TReader, TWriter>::skipObject() {
+  if (!skip('{')) return false;
+  if (skip('}')) return true;
+
+  for (;;) {
+    skipSpacesAndComments(_reader);
+    readString(false);
+    if (!skip(':')) return false;
+    if (!skipAnything()) return false;
+    if (skip('}')) return true;
+    if (!skip(',')) return false;
+  }
+}
+}
+}
@@ -11,6 +11,7 @@
 #include "DummyPrint.hpp"
 #include "IndentedPrint.hpp"
 #include "JsonWriter.hpp"
+#include "MsgPackWriter.hpp"
 #include "Prettyfier.hpp"
 #include "StaticStringBuilder.hpp"
 #include "DynamicStringBuilder.hpp"
@@ -83,6 +84,36 @@ class JsonPrintable {
     return prettyPrintTo(dp);
   }
 
+  // Same tree, MessagePack encoding: smaller on the wire and no number
+  // formatting. Strings are written as str, integers with the smallest
+  // encoding, raw JSON tokens by their MessagePack type.
+  size_t printMsgPackTo(Print &print) const {
+    MsgPackWriter writer(print);
+    downcast().writeTo(writer);
+    return writer.bytesWritten();
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+  std::ostream &printMsgPackTo(std::ostream &os) const {
+    StreamPrintAdapter adapter(os);
+    printMsgPackTo(adapter);
+    return os;
+  }
+#endif
+
+  // Like printTo(char*, size_t), the output is null-terminated so one byte of
+  // the buffer is lost; compare the result with measureMsgPackLength() to
+  // detect truncation.
+  size_t printMsgPackTo(char *buffer, size_t bufferSize) const {
+    StaticStringBuilder sb(buffer, bufferSize);
+    return printMsgPackTo(sb);
+  }
+
+  size_t measureMsgPackLength() const {
+    DummyPrint dp;
+    return printMsgPackTo(dp);
+  }
+
  private:
   const T &downcast() const { return *static_cast<const T *>(this); }
 };
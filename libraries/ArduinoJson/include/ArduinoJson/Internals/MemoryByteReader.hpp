@@ -0,0 +1,48 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Reads MessagePack bytes from a buffer of known length.
+// Unlike StringReader, the end is the length and not a '\0', since 0x00 is a
+// valid MessagePack byte.
+class MemoryByteReader {
+ public:
+  MemoryByteReader(const uint8_t *data, size_t length)
+      : _ptr(data), _end(data + length) {}
+
+  bool readByte(uint8_t &c) {
+    if (_ptr == _end) return false;
+    c = *_ptr++;
+    return true;
+  }
+
+  bool readBytes(char *dest, size_t n) {
+    if (!skipBytes(n)) return false;
+    memcpy(dest, _ptr - n, n);
+    return true;
+  }
+
+  bool skipBytes(size_t n) {
+    if (static_cast<size_t>(_end - _ptr) < n) return false;
+    _ptr += n;
+    return true;
+  }
+
+ private:
+  const uint8_t *_ptr;
+  const uint8_t *_end;
+};
+}
+}
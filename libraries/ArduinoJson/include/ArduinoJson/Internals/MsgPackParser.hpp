@@ -0,0 +1,89 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../JsonBuffer.hpp"
+#include "../JsonFilter.hpp"
+#include "../JsonVariant.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Parse MessagePack data to create JsonArrays and JsonObjects
+// This internal class is not indended to be used directly.
+// Instead, use JsonBuffer.parseMsgPackArray() or .parseMsgPackObject()
+//
+// TReader supplies the bytes (see MemoryByteReader and StreamByteReader).
+// Strings are always copied in the JsonBuffer.
+// Types that JsonVariant can't hold (bin, ext) fail the parsing, and so do map
+// keys that aren't strings.
+template <typename TReader>
+class MsgPackParser {
+ public:
+  MsgPackParser(JsonBuffer *buffer, TReader reader, uint8_t nestingLimit)
+      : _reader(reader), _nestingLimit(nestingLimit), _buffer(buffer) {}
+
+  JsonArray &parseArray();
+
+  // Members missing from filter are skipped, unless filter is NULL
+  JsonObject &parseObject(const JsonFilter *filter = NULL);
+
+ private:
+  // The decimals JSON gets when printing a float read from MessagePack
+  static const uint8_t FLOAT_DECIMALS = 6;
+
+  bool parseAnythingTo(JsonVariant *destination);
+  bool parseValueTo(uint8_t marker, JsonVariant *destination);
+  bool skipAnything();
+
+  JsonArray &readArray(size_t size);
+  JsonObject &readObject(size_t size, const JsonFilter *filter);
+
+  // Reads the string at the end of the JsonBuffer; committed tells whether
+  // it's already allocated, see commitString()
+  const char *readString(size_t size, bool &committed);
+  bool commitString(size_t size, bool committed) {
+    return committed || _buffer->alloc(size + 1) != NULL;
+  }
+
+  static bool isString(uint8_t m) {
+    return (m & 0xe0) == 0xa0 || (0xd9 <= m && m <= 0xdb);
+  }
+  static bool isArray(uint8_t m) {
+    return (m & 0xf0) == 0x90 || m == 0xdc || m == 0xdd;
+  }
+  static bool isMap(uint8_t m) {
+    return (m & 0xf0) == 0x80 || m == 0xde || m == 0xdf;
+  }
+
+  // Reads the length of a string, or the item count of an array or map
+  bool readSize(uint8_t marker, size_t &size);
+
+  template <typename T>
+  bool readBigEndian(T &value);
+
+  bool readFloat32(JsonVariant *destination);
+  bool readFloat64(JsonVariant *destination);
+
+  template <typename TUnsigned>
+  bool readUnsigned(JsonVariant *destination);
+
+  template <typename TUnsigned, typename TSigned>
+  bool readSigned(JsonVariant *destination);
+
+  // Larger integers are stored as floats
+  static uint64_t maxInteger() {
+    return (static_cast<uint64_t>(1) << (sizeof(JsonInteger) * 8 - 1)) - 1;
+  }
+
+  TReader _reader;
+  uint8_t _nestingLimit;
+  JsonBuffer *_buffer;
+};
+}
+}
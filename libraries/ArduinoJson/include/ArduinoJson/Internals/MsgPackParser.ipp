@@ -0,0 +1,368 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <math.h>    // for ldexp
+#include <string.h>  // for memcpy
+
+#include "MsgPackParser.hpp"
+#include "../JsonArray.hpp"
+#include "../JsonBuffer.hpp"
+#include "../JsonObject.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+template <typename TReader>
+inline JsonArray &MsgPackParser<TReader>::parseArray() {
+  uint8_t marker;
+  size_t size;
+  if (!_reader.readByte(marker) || !isArray(marker)) return JsonArray::invalid();
+  if (!readSize(marker, size)) return JsonArray::invalid();
+  return readArray(size);
+}
+
+template <typename TReader>
+inline JsonObject &MsgPackParser<TReader>::parseObject(
+    const JsonFilter *filter) {
+  uint8_t marker;
+  size_t size;
+  if (!_reader.readByte(marker) || !isMap(marker)) return JsonObject::invalid();
+  if (!readSize(marker, size)) return JsonObject::invalid();
+  return readObject(size, filter);
+}
+
+template <typename TReader>
+inline bool MsgPackParser<TReader>::parseAnythingTo(JsonVariant *destination) {
+  if (_nestingLimit == 0) return false;
+  uint8_t marker;
+  if (!_reader.readByte(marker)) return false;
+  _nestingLimit--;
+  bool success = parseValueTo(marker, destination);
+  _nestingLimit++;
+  return success;
+}
+
+template <typename TReader>
+inline bool MsgPackParser<TReader>::parseValueTo(uint8_t marker,
+                                                 JsonVariant *destination) {
+  if (marker <= 0x7f) {  // positive fixint
+    *destination = static_cast<JsonInteger>(marker);
+    return true;
+  }
+
+  if (marker >= 0xe0) {  // negative fixint
+    *destination = static_cast<JsonInteger>(static_cast<int8_t>(marker));
+    return true;
+  }
+
+  size_t size;
+  if (isString(marker)) {
+    bool committed;
+    if (!readSize(marker, size)) return false;
+    const char *value = readString(size, committed);
+    if (!value || !commitString(size, committed)) return false;
+    *destination = value;
+    return true;
+  }
+
+  if (isArray(marker)) {
+    if (!readSize(marker, size)) return false;
+    JsonArray &array = readArray(size);
+    if (!array.success()) return false;
+    *destination = array;
+    return true;
+  }
+
+  if (isMap(marker)) {
+    if (!readSize(marker, size)) return false;
+    JsonObject &object = readObject(size, NULL);
+    if (!object.success()) return false;
+    *destination = object;
+    return true;
+  }
+
+  switch (marker) {
+    case 0xc0:
+      // same as a null parsed from JSON
+      *destination = Unparsed("null");
+      return true;
+
+    case 0xc2:
+      *destination = false;
+      return true;
+
+    case 0xc3:
+      *destination = true;
+      return true;
+
+    case 0xca:
+      return readFloat32(destination);
+
+    case 0xcb:
+      return readFloat64(destination);
+
+    case 0xcc:
+      return readUnsigned<uint8_t>(destination);
+
+    case 0xcd:
+      return readUnsigned<uint16_t>(destination);
+
+    case 0xce:
+      return readUnsigned<uint32_t>(destination);
+
+    case 0xcf:
+      return readUnsigned<uint64_t>(destination);
+
+    case 0xd0:
+      return readSigned<uint8_t, int8_t>(destination);
+
+    case 0xd1:
+      return readSigned<uint16_t, int16_t>(destination);
+
+    case 0xd2:
+      return readSigned<uint32_t, int32_t>(destination);
+
+    case 0xd3:
+      return readSigned<uint64_t, int64_t>(destination);
+
+    default:  // bin, ext and the never used 0xc1
+      return false;
+  }
+}
+
+template <typename TReader>
+inline bool MsgPackParser<TReader>::skipAnything() {
+  if (_nestingLimit == 0) return false;
+  uint8_t marker;
+  if (!_reader.readByte(marker)) return false;
+
+  size_t size;
+  if (isString(marker))
+    return readSize(marker, size) && _reader.skipBytes(size);
+
+  if (isArray(marker) || isMap(marker)) {
+    if (!readSize(marker, size)) return false;
+    if (isMap(marker)) size *= 2;  // keys and values
+
+    bool success = true;
+    _nestingLimit--;
+    for (; success && size > 0; size--) success = skipAnything();
+    _nestingLimit++;
+    return success;
+  }
+
+  if (marker <= 0x7f || marker >= 0xe0) return true;
+
+  switch (marker) {
+    case 0xc0:
+    case 0xc2:
+    case 0xc3:
+      return true;
+
+    case 0xcc:
+    case 0xd0:
+      return _reader.skipBytes(1);
+
+    case 0xcd:
+    case 0xd1:
+      return _reader.skipBytes(2);
+
+    case 0xca:
+    case 0xce:
+    case 0xd2:
+      return _reader.skipBytes(4);
+
+    case 0xcb:
+    case 0xcf:
+    case 0xd3:
+      return _reader.skipBytes(8);
+
+    default:
+      return false;
+  }
+}
+
+template <typename TReader>
+inline JsonArray &MsgPackParser<TReader>::readArray(size_t size) {
+  JsonArray &array = _buffer->createArray();
+  if (!array.success()) return JsonArray::invalid();
+
+  for (; size > 0; size--) {
+    JsonVariant value;
+    if (!parseAnythingTo(&value)) return JsonArray::invalid();
+    if (!array.add(value)) return JsonArray::invalid();
+  }
+
+  return array;
+}
+
+template <typename TReader>
+inline JsonObject &MsgPackParser<TReader>::readObject(
+    size_t size, const JsonFilter *filter) {
+  JsonObject &object = _buffer->createObject();
+  if (!object.success()) return JsonObject::invalid();
+
+  for (; size > 0; size--) {
+    // 1 - Read key, only allocated if the member is kept
+    uint8_t marker;
+    size_t keySize;
+    bool committed;
+    if (!_reader.readByte(marker) || !isString(marker))
+      return JsonObject::invalid();
+    if (!readSize(marker, keySize)) return JsonObject::invalid();
+    const char *key = readString(keySize, committed);
+    if (!key) return JsonObject::invalid();
+
+    if (filter && !filter->allows(key)) {
+      // 2 - Skip value
+      if (!skipAnything()) return JsonObject::invalid();
+    } else {
+      // 2 - Parse value
+      if (!commitString(keySize, committed)) return JsonObject::invalid();
+      JsonVariant value;
+      if (!parseAnythingTo(&value)) return JsonObject::invalid();
+      if (!object.set(key, value)) return JsonObject::invalid();
+    }
+  }
+
+  return object;
+}
+
+template <typename TReader>
+inline const char *MsgPackParser<TReader>::readString(size_t size,
+                                                      bool &committed) {
+  if (size + 1 == 0) return NULL;
+
+  size_t capacity;
+  char *dest = static_cast<char *>(_buffer->freeSpace(capacity));
+  committed = dest == NULL || capacity <= size;
+  if (committed) dest = static_cast<char *>(_buffer->alloc(size + 1));
+
+  if (!dest || !_reader.readBytes(dest, size)) return NULL;
+  dest[size] = '\0';
+  return dest;
+}
+
+template <typename TReader>
+inline bool MsgPackParser<TReader>::readSize(uint8_t marker, size_t &size) {
+  if ((marker & 0xe0) == 0xa0) {  // fixstr
+    size = marker & 0x1f;
+    return true;
+  }
+
+  if ((marker & 0xe0) == 0x80) {  // fixmap and fixarray
+    size = marker & 0x0f;
+    return true;
+  }
+
+  switch (marker) {
+    case 0xd9: {
+      uint8_t value;
+      if (!readBigEndian(value)) return false;
+      size = value;
+      return true;
+    }
+
+    case 0xda:
+    case 0xdc:
+    case 0xde: {
+      uint16_t value;
+      if (!readBigEndian(value)) return false;
+      size = value;
+      return true;
+    }
+
+    case 0xdb:
+    case 0xdd:
+    case 0xdf: {
+      uint32_t value;
+      if (!readBigEndian(value)) return false;
+      size = value;
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+template <typename TReader>
+template <typename T>
+inline bool MsgPackParser<TReader>::readBigEndian(T &value) {
+  value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    uint8_t c;
+    if (!_reader.readByte(c)) return false;
+    value = static_cast<T>((value << 8) | c);
+  }
+  return true;
+}
+
+template <typename TReader>
+inline bool MsgPackParser<TReader>::readFloat32(JsonVariant *destination) {
+  uint32_t bits;
+  if (!readBigEndian(bits)) return false;
+
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  *destination = JsonVariant(value, FLOAT_DECIMALS);
+  return true;
+}
+
+template <typename TReader>
+inline bool MsgPackParser<TReader>::readFloat64(JsonVariant *destination) {
+  uint64_t bits;
+  if (!readBigEndian(bits)) return false;
+
+  double value;
+  if (sizeof(value) == sizeof(bits)) {
+    memcpy(&value, &bits, sizeof(value));
+  } else {
+    // double is a float on AVR, so the bits must be decoded by hand
+    int exponent = static_cast<int>((bits >> 52) & 0x7ff);
+    double mantissa = static_cast<double>(bits & 0xfffffffffffffULL) /
+                      4503599627370496.0;  // 2^52
+    value = exponent ? ldexp(1 + mantissa, exponent - 1023)
+                     : ldexp(mantissa, -1022);
+    if (bits >> 63) value = -value;
+  }
+
+  *destination = JsonVariant(static_cast<JsonFloat>(value), FLOAT_DECIMALS);
+  return true;
+}
+
+template <typename TReader>
+template <typename TUnsigned>
+inline bool MsgPackParser<TReader>::readUnsigned(JsonVariant *destination) {
+  TUnsigned value;
+  if (!readBigEndian(value)) return false;
+
+  if (static_cast<uint64_t>(value) <= maxInteger())
+    *destination = static_cast<JsonInteger>(value);
+  else
+    *destination = JsonVariant(static_cast<JsonFloat>(value), 0);
+  return true;
+}
+
+template <typename TReader>
+template <typename TUnsigned, typename TSigned>
+inline bool MsgPackParser<TReader>::readSigned(JsonVariant *destination) {
+  TUnsigned bits;
+  if (!readBigEndian(bits)) return false;
+
+  int64_t value = static_cast<TSigned>(bits);
+  int64_t max = static_cast<int64_t>(maxInteger());
+  if (-max - 1 <= value && value <= max)
+    *destination = static_cast<JsonInteger>(value);
+  else
+    *destination = JsonVariant(static_cast<JsonFloat>(value), 0);
+  return true;
+}
+}
+}
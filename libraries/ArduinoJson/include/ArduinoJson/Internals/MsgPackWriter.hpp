@@ -0,0 +1,161 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Arduino/Print.hpp"
+#include "JsonFloat.hpp"
+#include "JsonInteger.hpp"
+#include "Parse.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Writes the MessagePack encoding of a tree to a Print implementation
+// This class is used by:
+// - JsonArray::writeTo()
+// - JsonObject::writeTo()
+// - JsonVariant::writeTo()
+// It mirrors JsonWriter but, since MessagePack is length-prefixed, arrays and
+// objects must announce their size up front and there are no separators.
+class MsgPackWriter {
+ public:
+  explicit MsgPackWriter(Print &sink) : _sink(sink), _length(0) {}
+
+  // Returns the number of bytes sent to the Print implementation.
+  size_t bytesWritten() const { return _length; }
+
+  void beginArray(size_t size) { writeHeader(0x90, 0xdc, size); }
+  void beginObject(size_t size) { writeHeader(0x80, 0xde, size); }
+
+  void writeNil() { writeByte(0xc0); }
+
+  void writeBoolean(bool value) { writeByte(value ? 0xc3 : 0xc2); }
+
+  void writeString(const char *value) {
+    if (!value) return writeNil();
+
+    size_t size = strlen(value);
+    if (size < 32) {
+      writeByte(static_cast<uint8_t>(0xa0 | size));
+    } else if (size <= 0xff) {
+      writeByte(0xd9);
+      writeBigEndian(static_cast<uint8_t>(size));
+    } else if (size <= 0xffff) {
+      writeByte(0xda);
+      writeBigEndian(static_cast<uint16_t>(size));
+    } else {
+      writeByte(0xdb);
+      writeBigEndian(static_cast<uint32_t>(size));
+    }
+    while (*value) writeByte(static_cast<uint8_t>(*value++));
+  }
+
+  // Uses the smallest encoding that holds the value
+  void writeInteger(JsonInteger value) {
+    if (value >= 0) {
+      if (value <= 0x7f) {
+        writeByte(static_cast<uint8_t>(value));
+      } else if (value <= 0xff) {
+        writeByte(0xcc);
+        writeBigEndian(static_cast<uint8_t>(value));
+      } else if (value <= 0xffff) {
+        writeByte(0xcd);
+        writeBigEndian(static_cast<uint16_t>(value));
+      } else if (static_cast<uint64_t>(value) <= 0xffffffffUL) {
+        writeByte(0xce);
+        writeBigEndian(static_cast<uint32_t>(value));
+      } else {
+        writeByte(0xcf);
+        writeBigEndian(static_cast<uint64_t>(value));
+      }
+    } else {
+      if (value >= -32) {
+        writeByte(static_cast<uint8_t>(value));
+      } else if (value >= -128) {
+        writeByte(0xd0);
+        writeBigEndian(static_cast<uint8_t>(value));
+      } else if (value >= -32768) {
+        writeByte(0xd1);
+        writeBigEndian(static_cast<uint16_t>(value));
+      } else if (value >= -2147483647L - 1) {
+        writeByte(0xd2);
+        writeBigEndian(static_cast<uint32_t>(value));
+      } else {
+        writeByte(0xd3);
+        writeBigEndian(static_cast<uint64_t>(value));
+      }
+    }
+  }
+
+  // float 64 when JsonFloat is a double, float 32 otherwise (including AVR,
+  // where double is only 4 bytes).
+  void writeFloat(JsonFloat value) {
+    if (sizeof(JsonFloat) == sizeof(uint64_t)) {
+      uint64_t bits = 0;
+      memcpy(&bits, &value, sizeof(value));
+      writeByte(0xcb);
+      writeBigEndian(bits);
+    } else {
+      float single = static_cast<float>(value);
+      uint32_t bits;
+      memcpy(&bits, &single, sizeof(bits));
+      writeByte(0xca);
+      writeBigEndian(bits);
+    }
+  }
+
+  // Unparsed values are raw JSON tokens (null, true, false, numbers) that the
+  // parser kept as text; MessagePack has proper types for all of them.
+  void writeRaw(const char *value) {
+    if (!strcmp(value, "null")) return writeNil();
+    if (!strcmp(value, "true")) return writeBoolean(true);
+    if (!strcmp(value, "false")) return writeBoolean(false);
+
+    char *end;
+    JsonFloat number = static_cast<JsonFloat>(strtod(value, &end));
+    if (end == value || *end) return writeString(value);
+
+    if (strpbrk(value, ".eE"))
+      writeFloat(number);
+    else
+      writeInteger(parse<JsonInteger>(value));
+  }
+
+ protected:
+  void writeByte(uint8_t c) { _length += _sink.write(c); }
+
+  template <typename T>
+  void writeBigEndian(T value) {
+    for (size_t i = sizeof(T); i > 0; i--)
+      writeByte(static_cast<uint8_t>(value >> (8 * (i - 1))));
+  }
+
+  void writeHeader(uint8_t fixed, uint8_t marker16, size_t size) {
+    if (size < 16) {
+      writeByte(static_cast<uint8_t>(fixed | size));
+    } else if (size <= 0xffff) {
+      writeByte(marker16);
+      writeBigEndian(static_cast<uint16_t>(size));
+    } else {
+      writeByte(static_cast<uint8_t>(marker16 + 1));
+      writeBigEndian(static_cast<uint32_t>(size));
+    }
+  }
+
+  Print &_sink;
+  size_t _length;
+
+ private:
+  MsgPackWriter &operator=(const MsgPackWriter &);  // cannot be assigned
+};
+}
+}
@@ -0,0 +1,51 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <stddef.h>  // for size_t
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Measures the runs of characters that the parser can take in one go, in a
+// null-terminated string.
+// end points just past the terminator; the terminator ends every run, so
+// this portable version doesn't need it, see SimdScanner for the vectorized
+// one.
+class ScalarScanner {
+ public:
+  // Number of characters before the first quote, backslash or terminator
+  static size_t stringRun(const char *s, const char *, char quote) {
+    const char *p = s;
+    while (*p != quote && *p != '\\' && *p != '\0') p++;
+    return static_cast<size_t>(p - s);
+  }
+
+  // Number of leading spaces, tabs and line breaks
+  static size_t spaces(const char *s, const char *) {
+    const char *p = s;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return static_cast<size_t>(p - s);
+  }
+
+  // Number of leading characters of an unquoted value, the same set as
+  // JsonParser::isLetterOrNumber()
+  static size_t word(const char *s, const char *) {
+    const char *p = s;
+    while (isWordChar(*p)) p++;
+    return static_cast<size_t>(p - s);
+  }
+
+ private:
+  static bool isWordChar(char c) {
+    return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') ||
+           ('A' <= c && c <= 'Z') || c == '-' || c == '.';
+  }
+};
+}
+}
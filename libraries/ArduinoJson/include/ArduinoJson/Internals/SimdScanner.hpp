@@ -0,0 +1,152 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../Configuration.hpp"
+
+#if ARDUINOJSON_ENABLE_SIMD
+
+#include <stddef.h>  // for size_t, ptrdiff_t
+#include <stdint.h>  // for uint32_t
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#include "ScalarScanner.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Same as ScalarScanner, 32 characters at a time with AVX2, 16 with SSE2.
+//
+// A block is only loaded when it lies before end, so nothing outside the
+// input is read; the last few characters are left to ScalarScanner.
+class SimdScanner {
+ public:
+  static size_t stringRun(const char *s, const char *end, char quote) {
+    return find(s, end, StringStop(quote));
+  }
+
+  static size_t spaces(const char *s, const char *end) {
+    return find(s, end, SpaceStop());
+  }
+
+  static size_t word(const char *s, const char *end) {
+    return find(s, end, WordStop());
+  }
+
+ private:
+#ifdef __AVX2__
+  typedef __m256i Vector;
+  static const uint32_t ALL_BITS = 0xffffffff;
+
+  static Vector load(const char *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const Vector *>(p));
+  }
+  static Vector splat(char c) { return _mm256_set1_epi8(c); }
+  static Vector eq(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+  static Vector gt(Vector a, Vector b) { return _mm256_cmpgt_epi8(a, b); }
+  static Vector both(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+  static Vector either(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+  static uint32_t bits(Vector v) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+  }
+#else
+  typedef __m128i Vector;
+  static const uint32_t ALL_BITS = 0xffff;
+
+  static Vector load(const char *p) {
+    return _mm_loadu_si128(reinterpret_cast<const Vector *>(p));
+  }
+  static Vector splat(char c) { return _mm_set1_epi8(c); }
+  static Vector eq(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+  static Vector gt(Vector a, Vector b) { return _mm_cmpgt_epi8(a, b); }
+  static Vector both(Vector a, Vector b) { return _mm_and_si128(a, b); }
+  static Vector either(Vector a, Vector b) { return _mm_or_si128(a, b); }
+  static uint32_t bits(Vector v) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(v));
+  }
+#endif
+
+  // Signed comparisons: bytes above 0x7f are negative, so never in range
+  static Vector inRange(Vector x, char min, char max) {
+    return both(gt(x, splat(static_cast<char>(min - 1))),
+                gt(splat(static_cast<char>(max + 1)), x));
+  }
+
+  // Each stop sets bit i when the character i of the block ends the run.
+  // All of them stop at the terminator, which ends the search.
+  // rest() finishes the run one character at a time.
+  struct StringStop {
+    explicit StringStop(char quote)
+        : _quote(splat(quote)),
+          _backslash(splat('\\')),
+          _zero(splat(0)),
+          _quoteChar(quote) {}
+
+    uint32_t operator()(const char *block) const {
+      Vector x = load(block);
+      return bits(
+          either(either(eq(x, _quote), eq(x, _backslash)), eq(x, _zero)));
+    }
+
+    size_t rest(const char *p, const char *end) const {
+      return ScalarScanner::stringRun(p, end, _quoteChar);
+    }
+
+    Vector _quote, _backslash, _zero;
+    char _quoteChar;
+  };
+
+  struct SpaceStop {
+    uint32_t operator()(const char *block) const {
+      Vector x = load(block);
+      Vector space = either(either(eq(x, splat(' ')), eq(x, splat('\t'))),
+                            either(eq(x, splat('\r')), eq(x, splat('\n'))));
+      return ~bits(space) & ALL_BITS;
+    }
+
+    size_t rest(const char *p, const char *end) const {
+      return ScalarScanner::spaces(p, end);
+    }
+  };
+
+  struct WordStop {
+    uint32_t operator()(const char *block) const {
+      Vector x = load(block);
+      Vector word = either(either(inRange(x, '0', '9'), inRange(x, 'a', 'z')),
+                           either(inRange(x, 'A', 'Z'),
+                                  either(eq(x, splat('-')), eq(x, splat('.')))));
+      return ~bits(word) & ALL_BITS;
+    }
+
+    size_t rest(const char *p, const char *end) const {
+      return ScalarScanner::word(p, end);
+    }
+  };
+
+  template <typename TStop>
+  static size_t find(const char *s, const char *end, const TStop &stop) {
+    const char *block = s;
+    while (end - block >= static_cast<ptrdiff_t>(sizeof(Vector))) {
+      uint32_t found = stop(block);
+      if (found)
+        return static_cast<size_t>(block - s) +
+               static_cast<size_t>(__builtin_ctz(found));
+      block += sizeof(Vector);
+    }
+    return static_cast<size_t>(block - s) + stop.rest(block, end);
+  }
+};
+}
+}
+
+#endif
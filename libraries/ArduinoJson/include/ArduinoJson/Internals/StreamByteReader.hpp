@@ -0,0 +1,71 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../Configuration.hpp"
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+#include <istream>
+#endif
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
+namespace ArduinoJson {
+namespace Internals {
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+inline size_t readStreamBytes(std::istream &stream, char *dest, size_t n) {
+  stream.read(dest, static_cast<std::streamsize>(n));
+  return static_cast<size_t>(stream.gcount());
+}
+#endif
+
+#ifdef ARDUINO
+// readBytes() waits up to the stream timeout, unlike read()
+inline size_t readStreamBytes(Stream &stream, char *dest, size_t n) {
+  return stream.readBytes(dest, n);
+}
+#endif
+
+// Reads MessagePack bytes from a stream.
+// Strings are read with a single call, straight into the JsonBuffer, and
+// nothing after the end of the root array or map is consumed.
+// The end of the stream (or a timeout) fails the read.
+template <typename TStream>
+class StreamByteReader {
+ public:
+  explicit StreamByteReader(TStream &stream) : _stream(stream) {}
+
+  bool readByte(uint8_t &c) {
+    char tmp;
+    if (readStreamBytes(_stream, &tmp, 1) != 1) return false;
+    c = static_cast<uint8_t>(tmp);
+    return true;
+  }
+
+  bool readBytes(char *dest, size_t n) {
+    return readStreamBytes(_stream, dest, n) == n;
+  }
+
+  bool skipBytes(size_t n) {
+    char tmp[16];
+    while (n > 0) {
+      size_t chunk = n < sizeof(tmp) ? n : sizeof(tmp);
+      if (!readBytes(tmp, chunk)) return false;
+      n -= chunk;
+    }
+    return true;
+  }
+
+ private:
+  TStream &_stream;
+};
+}
+}
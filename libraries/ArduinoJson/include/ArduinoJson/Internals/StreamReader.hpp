@@ -0,0 +1,92 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "../Configuration.hpp"
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+#include <istream>
+#endif
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
+namespace ArduinoJson {
+namespace Internals {
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+inline char readStreamChar(std::istream &stream) {
+  int c = stream.get();
+  return c == std::char_traits<char>::eof() ? '\0' : static_cast<char>(c);
+}
+#endif
+
+#ifdef ARDUINO
+// readBytes() waits up to the stream timeout, unlike read()
+inline char readStreamChar(Stream &stream) {
+  char c;
+  return stream.readBytes(&c, 1) == 1 ? c : '\0';
+}
+#endif
+
+// Reads the JSON characters from a stream, one at a time.
+// Characters are only pulled from the stream when the parser looks at them,
+// so nothing after the end of the root object or array is consumed.
+// The end of the stream (or a timeout) reads as '\0'.
+template <typename TStream>
+class StreamReader {
+ public:
+  explicit StreamReader(TStream &stream)
+      : _stream(stream),
+        _current(0),
+        _next(0),
+        _hasCurrent(false),
+        _hasNext(false) {}
+
+  char current() {
+    if (!_hasCurrent) {
+      _current = readStreamChar(_stream);
+      _hasCurrent = true;
+    }
+    return _current;
+  }
+
+  char next() {
+    if (!_hasNext) {
+      current();
+      _next = readStreamChar(_stream);
+      _hasNext = true;
+    }
+    return _next;
+  }
+
+  void move() {
+    current();
+    _current = _next;
+    _hasCurrent = _hasNext;
+    _hasNext = false;
+  }
+
+  // There's nothing to scan ahead in a stream, the parser reads these runs
+  // one character at a time.
+  template <typename TWriter>
+  void readStringRun(TWriter &, char, bool) {}
+
+  template <typename TWriter>
+  void readWord(TWriter &, bool) {}
+
+  void skipSpaces() {}
+
+ private:
+  TStream &_stream;
+  char _current, _next;
+  bool _hasCurrent, _hasNext;
+};
+}
+}
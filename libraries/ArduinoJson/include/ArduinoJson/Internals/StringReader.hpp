@@ -0,0 +1,54 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <string.h>  // for strlen
+
+#include "CharScanner.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Reads the JSON characters from a null-terminated string.
+// This is the reader used when parsing in place.
+class StringReader {
+ public:
+  explicit StringReader(const char *ptr)
+      : _ptr(ptr ? ptr : ""), _end(_ptr + strlen(_ptr) + 1) {}
+
+  char current() const { return _ptr[0]; }
+  char next() const { return _ptr[1]; }
+  void move() { ++_ptr; }
+
+  // The runs the parser would otherwise read one character at a time.
+  // The whole string is in memory, so CharScanner can look ahead up to _end.
+  template <typename TWriter>
+  void readStringRun(TWriter &writer, char quote, bool store) {
+    size_t n = CharScanner::stringRun(_ptr, _end, quote);
+    if (store) writer.append(_ptr, n);
+    _ptr += n;
+  }
+
+  template <typename TWriter>
+  void readWord(TWriter &writer, bool store) {
+    size_t n = CharScanner::word(_ptr, _end);
+    if (store) writer.append(_ptr, n);
+    _ptr += n;
+  }
+
+  // Compact JSON has no spaces between tokens: one test, not a block scan
+  void skipSpaces() {
+    if (*_ptr <= ' ') _ptr += CharScanner::spaces(_ptr, _end);
+  }
+
+ private:
+  const char *_ptr;
+  const char *_end;  // just past the terminator, the scanners read no further
+};
+}
+}
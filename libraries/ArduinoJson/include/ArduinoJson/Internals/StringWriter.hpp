@@ -0,0 +1,46 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <string.h>  // for memmove
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Writes the parsed strings back over the JSON input.
+// This works because a string never takes more room once unescaped and
+// null-terminated than it did in the input.
+class StringWriter {
+ public:
+  explicit StringWriter(char *ptr) : _ptr(ptr), _start(ptr) {}
+
+  void startString() { _start = _ptr; }
+  void append(char c) { *_ptr++ = c; }
+
+  // The characters come from further in the same input, so they may overlap
+  void append(const char *s, size_t n) {
+    memmove(_ptr, s, n);
+    _ptr += n;
+  }
+
+  // Ends the string, commit() has nothing more to do in place
+  const char *terminate() {
+    *_ptr++ = '\0';
+    return _start;
+  }
+
+  bool commit() { return true; }
+
+  const char *complete() { return terminate(); }
+
+ private:
+  char *_ptr;
+  char *_start;
+};
+}
+}
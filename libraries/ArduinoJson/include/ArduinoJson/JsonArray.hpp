@@ -158,8 +158,9 @@ class JsonArray : public Internals::JsonPrintable<JsonArray>,
   // This is used when memory allocation or JSON parsing fail.
   static JsonArray &invalid() { return _invalid; }
 
-  // Serialize the array to the specified JsonWriter.
+  // Serialize the array to the specified JsonWriter or MsgPackWriter.
   void writeTo(Internals::JsonWriter &writer) const;
+  void writeTo(Internals::MsgPackWriter &writer) const;
 
  private:
   node_type *getNodeAt(size_t index) const;
@@ -60,6 +60,10 @@ class JsonArraySubscript : public JsonVariantBase<JsonArraySubscript> {
     _array.get(_index).writeTo(writer);
   }
 
+  void writeTo(Internals::MsgPackWriter& writer) const {
+    _array.get(_index).writeTo(writer);
+  }
+
   template <typename TValue>
   void set(TValue value) {
     _array.set(_index, value);
@@ -0,0 +1,190 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include "Internals/JsonBindingParser.hpp"
+#include "Internals/StreamReader.hpp"
+#include "Internals/StringReader.hpp"
+
+namespace ArduinoJson {
+namespace Internals {
+
+// Binds a key to a member of TStruct
+template <typename TStruct, typename TMember>
+class JsonField {
+ public:
+  typedef TStruct struct_type;
+
+  constexpr JsonField(const char *key, TMember TStruct::*member)
+      : _key(key), _hash(hashKey(key)), _member(member) {}
+
+  bool matches(uint32_t hash, const char *key) const {
+    return hash == _hash && !strcmp(key, _key);
+  }
+
+  template <typename TParser>
+  bool parseTo(TParser &parser, TStruct &destination) const {
+    return parser.parseValue(destination.*_member);
+  }
+
+ protected:
+  const char *_key;
+  uint32_t _hash;
+  TMember TStruct::*_member;
+};
+
+// Binds a key to a struct member of TStruct, itself described by TBinding
+template <typename TStruct, typename TMember, typename TBinding>
+class JsonNestedField : public JsonField<TStruct, TMember> {
+ public:
+  constexpr JsonNestedField(const char *key, TMember TStruct::*member,
+                            TBinding binding)
+      : JsonField<TStruct, TMember>(key, member), _binding(binding) {}
+
+  template <typename TParser>
+  bool parseTo(TParser &parser, TStruct &destination) const {
+    return parser.parseNested(_binding, destination.*(this->_member));
+  }
+
+ private:
+  TBinding _binding;
+};
+
+// The fields of a binding, tried in turn for each key
+template <typename... TFields>
+class JsonFieldList;
+
+template <>
+class JsonFieldList<> {
+ public:
+  constexpr JsonFieldList() {}
+
+  template <typename TParser, typename TStruct>
+  bool parseMember(TParser &, uint32_t, const char *, TStruct &,
+                   bool &found) const {
+    found = false;
+    return true;
+  }
+};
+
+template <typename TField, typename... TRest>
+class JsonFieldList<TField, TRest...> {
+ public:
+  constexpr JsonFieldList(TField field, TRest... rest)
+      : _field(field), _rest(rest...) {}
+
+  template <typename TParser, typename TStruct>
+  bool parseMember(TParser &parser, uint32_t hash, const char *key,
+                   TStruct &destination, bool &found) const {
+    if (!_field.matches(hash, key))
+      return _rest.parseMember(parser, hash, key, destination, found);
+    found = true;
+    return _field.parseTo(parser, destination);
+  }
+
+ private:
+  TField _field;
+  JsonFieldList<TRest...> _rest;
+};
+}
+
+// Decodes a JSON object straight into a struct, for messages with a known
+// shape. There's no JsonBuffer and no JsonObject to look the keys up in.
+//
+//   struct VerifyReply {
+//     int access;
+//     bool trainer;
+//   };
+//
+//   constexpr auto verifyReply = jsonBinding(
+//       jsonField("access", &VerifyReply::access),
+//       jsonField("trainer", &VerifyReply::trainer));
+//
+//   VerifyReply reply = {0, false};
+//   if (verifyReply.parse(client, reply)) ...
+//
+// Fields can be numbers, bool, char arrays and structs with a binding of
+// their own (see jsonField()). Members of the object without a field are
+// skipped, fields without a member in the object are left as they were.
+template <typename TStruct, typename... TFields>
+class JsonBinding {
+ public:
+  constexpr explicit JsonBinding(TFields... fields) : _fields(fields...) {}
+
+  // Returns false if the JSON is invalid or a value doesn't suit its field,
+  // in which case destination may be partly filled.
+  bool parse(const char *json, TStruct &destination,
+             uint8_t nestingLimit = DEFAULT_LIMIT) const {
+    return parseFrom(Internals::StringReader(json), destination, nestingLimit);
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+  // Same as above, the stream is read up to the closing brace only
+  bool parse(std::istream &json, TStruct &destination,
+             uint8_t nestingLimit = DEFAULT_LIMIT) const {
+    return parseFrom(Internals::StreamReader<std::istream>(json), destination,
+                     nestingLimit);
+  }
+#endif
+
+#ifdef ARDUINO
+  // Same as above, the stream is read up to the closing brace only
+  bool parse(Stream &json, TStruct &destination,
+             uint8_t nestingLimit = DEFAULT_LIMIT) const {
+    return parseFrom(Internals::StreamReader<Stream>(json), destination,
+                     nestingLimit);
+  }
+#endif
+
+  template <typename TParser>
+  bool parseMember(TParser &parser, uint32_t hash, const char *key,
+                   TStruct &destination, bool &found) const {
+    return _fields.parseMember(parser, hash, key, destination, found);
+  }
+
+ private:
+  template <typename TReader>
+  bool parseFrom(TReader reader, TStruct &destination,
+                 uint8_t nestingLimit) const {
+    Internals::JsonBindingParser<TReader> parser(reader, nestingLimit);
+    return parser.parseStruct(*this, destination);
+  }
+
+  // Same as JsonBuffer's
+  static const uint8_t DEFAULT_LIMIT = 10;
+
+  Internals::JsonFieldList<TFields...> _fields;
+};
+
+// Describes a field, key must be a string literal
+template <typename TStruct, typename TMember, size_t N>
+constexpr Internals::JsonField<TStruct, TMember> jsonField(
+    const char (&key)[N], TMember TStruct::*member) {
+  static_assert(N <= ARDUINOJSON_BINDING_MAX_KEY + 1,
+                "key longer than ARDUINOJSON_BINDING_MAX_KEY");
+  return Internals::JsonField<TStruct, TMember>(key, member);
+}
+
+// Describes a struct field, with the binding of that struct
+template <typename TStruct, typename TMember, typename TBinding, size_t N>
+constexpr Internals::JsonNestedField<TStruct, TMember, TBinding> jsonField(
+    const char (&key)[N], TMember TStruct::*member, const TBinding &binding) {
+  static_assert(N <= ARDUINOJSON_BINDING_MAX_KEY + 1,
+                "key longer than ARDUINOJSON_BINDING_MAX_KEY");
+  return Internals::JsonNestedField<TStruct, TMember, TBinding>(key, member,
+                                                               binding);
+}
+
+// Describes a struct from its fields
+template <typename TField, typename... TFields>
+constexpr JsonBinding<typename TField::struct_type, TField, TFields...>
+jsonBinding(TField field, TFields... fields) {
+  return JsonBinding<typename TField::struct_type, TField, TFields...>(
+      field, fields...);
+}
+}
@@ -11,9 +11,19 @@
 #include <stdint.h>  // for uint8_t
 #include <string.h>
 
+#include "Configuration.hpp"
 #include "Arduino/String.hpp"
+#include "JsonFilter.hpp"
 #include "JsonVariant.hpp"
 
+#if ARDUINOJSON_ENABLE_STD_STREAM
+#include <istream>
+#endif
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
 #if defined(__clang__)
 #pragma clang diagnostic ignored "-Wnon-virtual-dtor"
 #elif defined(__GNUC__)
@@ -71,6 +81,20 @@ class JsonBuffer {
     return parseArray(json.c_str(), nesting);
   }
 
+#if ARDUINOJSON_ENABLE_STD_STREAM
+  // Same as above, reading the JSON from a std::istream.
+  // The strings are stored in the JsonBuffer and the stream is read up to the
+  // closing bracket only.
+  JsonArray &parseArray(std::istream &json, uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
+#ifdef ARDUINO
+  // Same as above, reading the JSON from a Stream, such as a WiFiClient.
+  // The strings are stored in the JsonBuffer and the stream is read up to the
+  // closing bracket only.
+  JsonArray &parseArray(Stream &json, uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
   // Allocates and populate a JsonObject from a JSON string.
   //
   // The First argument is a pointer to the JSON string, the memory must be
@@ -94,6 +118,87 @@ class JsonBuffer {
     return parseObject(json.c_str(), nesting);
   }
 
+#if ARDUINOJSON_ENABLE_STD_STREAM
+  // Same as above, reading the JSON from a std::istream.
+  // The strings are stored in the JsonBuffer and the stream is read up to the
+  // closing brace only.
+  JsonObject &parseObject(std::istream &json, uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
+#ifdef ARDUINO
+  // Same as above, reading the JSON from a Stream, such as a WiFiClient.
+  // No copy of the response is needed: the strings are stored in the
+  // JsonBuffer and the stream is read up to the closing brace only.
+  JsonObject &parseObject(Stream &json, uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
+  // Same as the parseObject() above, keeping only the members listed in the
+  // filter. The other members are skipped without allocating anything.
+  JsonObject &parseObject(char *json, const JsonFilter &filter,
+                          uint8_t nesting = DEFAULT_LIMIT);
+
+  JsonObject &parseObject(const char *json, const JsonFilter &filter,
+                          uint8_t nesting = DEFAULT_LIMIT) {
+    return parseObject(strdup(json), filter, nesting);
+  }
+
+  JsonObject &parseObject(const String &json, const JsonFilter &filter,
+                          uint8_t nesting = DEFAULT_LIMIT) {
+    return parseObject(json.c_str(), filter, nesting);
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+  JsonObject &parseObject(std::istream &json, const JsonFilter &filter,
+                          uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
+#ifdef ARDUINO
+  JsonObject &parseObject(Stream &json, const JsonFilter &filter,
+                          uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
+  // Allocates and populate a JsonArray from MessagePack data.
+  //
+  // The first two arguments are the data and its length; the data isn't
+  // modified as the strings are copied in the JsonBuffer.
+  //
+  // The third argument set the nesting limit (see comment on DEFAULT_LIMIT)
+  //
+  // Returns a reference to the new JsonArray or JsonArray::invalid() if the
+  // data isn't a valid MessagePack array, or if the allocation fails.
+  JsonArray &parseMsgPackArray(const uint8_t *data, size_t length,
+                               uint8_t nesting = DEFAULT_LIMIT);
+
+  // Same for a MessagePack map.
+  // The keys must be strings; nil reads like a JSON null.
+  JsonObject &parseMsgPackObject(const uint8_t *data, size_t length,
+                                 uint8_t nesting = DEFAULT_LIMIT);
+
+  // Same, keeping only the members listed in the filter.
+  JsonObject &parseMsgPackObject(const uint8_t *data, size_t length,
+                                 const JsonFilter &filter,
+                                 uint8_t nesting = DEFAULT_LIMIT);
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+  // Same as above, reading the MessagePack from a std::istream up to the end
+  // of the root array or map only.
+  JsonArray &parseMsgPackArray(std::istream &data,
+                               uint8_t nesting = DEFAULT_LIMIT);
+  JsonObject &parseMsgPackObject(std::istream &data,
+                                 uint8_t nesting = DEFAULT_LIMIT);
+  JsonObject &parseMsgPackObject(std::istream &data, const JsonFilter &filter,
+                                 uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
+#ifdef ARDUINO
+  // Same as above, reading the MessagePack from a Stream, such as a
+  // WiFiClient, up to the end of the root array or map only.
+  JsonArray &parseMsgPackArray(Stream &data, uint8_t nesting = DEFAULT_LIMIT);
+  JsonObject &parseMsgPackObject(Stream &data, uint8_t nesting = DEFAULT_LIMIT);
+  JsonObject &parseMsgPackObject(Stream &data, const JsonFilter &filter,
+                                 uint8_t nesting = DEFAULT_LIMIT);
+#endif
+
   // Duplicate a string
   char *strdup(const char *src) {
     return src ? strdup(src, strlen(src)) : NULL;
@@ -104,6 +209,15 @@ class JsonBuffer {
   // Return a pointer to the allocated memory or NULL if allocation fails.
   virtual void *alloc(size_t size) = 0;
 
+  // Returns the memory that the next alloc() will return, if it fits, and
+  // sets capacity to its size.
+  // Used to write a string of unknown length before allocating it.
+  // Returns NULL if there is no such memory.
+  virtual void *freeSpace(size_t &capacity) {
+    capacity = 0;
+    return NULL;
+  }
+
  protected:
   // Preserve aligment if nessary
   static FORCE_INLINE size_t round_size_up(size_t bytes) {
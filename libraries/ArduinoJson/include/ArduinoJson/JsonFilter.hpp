@@ -0,0 +1,39 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#pragma once
+
+#include <stddef.h>  // for NULL
+#include <string.h>  // for strcmp
+
+namespace ArduinoJson {
+
+// Lists the members that JsonBuffer::parseObject() keeps.
+//
+// The other members of the object are still checked by the parser, but
+// nothing is allocated for them, so a response that grows new fields doesn't
+// need a bigger JsonBuffer.
+// The filter applies to the root object only, kept values are parsed whole.
+//
+//   const char *keys[] = {"access", "trainer", NULL};
+//   JsonObject& root = jsonBuffer.parseObject(json, JsonFilter(keys));
+class JsonFilter {
+ public:
+  // keys is an array of member names ended by NULL
+  explicit JsonFilter(const char *const *keys) : _keys(keys) {}
+
+  bool allows(const char *key) const {
+    for (const char *const *k = _keys; *k != NULL; k++) {
+      if (!strcmp(*k, key)) return true;
+    }
+    return false;
+  }
+
+ private:
+  const char *const *_keys;
+};
+}
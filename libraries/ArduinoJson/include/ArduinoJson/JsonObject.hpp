@@ -128,8 +128,9 @@ class JsonObject : public Internals::JsonPrintable<JsonObject>,
   // This is used when memory allocation or JSON parsing fail.
   static JsonObject& invalid() { return _invalid; }
 
-  // Serialize the object to the specified JsonWriter
+  // Serialize the object to the specified JsonWriter or MsgPackWriter
   void writeTo(Internals::JsonWriter& writer) const;
+  void writeTo(Internals::MsgPackWriter& writer) const;
 
  private:
   // Returns the list node that matches the specified key.
@@ -75,6 +75,10 @@ class JsonObjectSubscript : public JsonVariantBase<JsonObjectSubscript<TKey> > {
     _object.get(_key).writeTo(writer);
   }
 
+  void writeTo(Internals::MsgPackWriter& writer) const {
+    _object.get(_key).writeTo(writer);
+  }
+
  private:
   JsonObject& _object;
   TKey _key;
@@ -159,8 +159,9 @@ class JsonVariant : public JsonVariantBase<JsonVariant> {
   template <typename T>
   bool is() const;
 
-  // Serialize the variant to a JsonWriter
+  // Serialize the variant to a JsonWriter or a MsgPackWriter
   void writeTo(Internals::JsonWriter &writer) const;
+  void writeTo(Internals::MsgPackWriter &writer) const;
 
   // TODO: rename
   template <typename T>
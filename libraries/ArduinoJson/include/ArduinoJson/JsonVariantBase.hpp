@@ -64,8 +64,9 @@ class JsonVariantBase : public Internals::JsonPrintable<TImpl> {
   FORCE_INLINE const JsonObjectSubscript<const String &> operator[](
       const String &key) const;
 
-  // Serialize the variant to a JsonWriter
+  // Serialize the variant to a JsonWriter or a MsgPackWriter
   void writeTo(Internals::JsonWriter &writer) const;
+  void writeTo(Internals::MsgPackWriter &writer) const;
 
  private:
   const TImpl *impl() const { return static_cast<const TImpl *>(this); }
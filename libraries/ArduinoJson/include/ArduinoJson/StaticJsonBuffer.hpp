@@ -29,6 +29,11 @@ class StaticJsonBuffer : public JsonBuffer {
     return p;
   }
 
+  virtual void* freeSpace(size_t& capacity) {
+    capacity = CAPACITY - _size;
+    return &_buffer[_size];
+  }
+
  private:
   uint8_t _buffer[CAPACITY];
   size_t _size;
@@ -38,3 +38,10 @@ void JsonArray::writeTo(JsonWriter &writer) const {
 
   writer.endArray();
 }
+
+void JsonArray::writeTo(MsgPackWriter &writer) const {
+  writer.beginArray(size());
+
+  for (const node_type *child = _firstNode; child; child = child->next)
+    child->content.writeTo(writer);
+}
@@ -7,7 +7,14 @@
 
 #include "../include/ArduinoJson/JsonBuffer.hpp"
 
-#include "../include/ArduinoJson/Internals/JsonParser.hpp"
+#include "../include/ArduinoJson/Internals/JsonBufferStringWriter.hpp"
+#include "../include/ArduinoJson/Internals/JsonParser.ipp"
+#include "../include/ArduinoJson/Internals/MemoryByteReader.hpp"
+#include "../include/ArduinoJson/Internals/MsgPackParser.ipp"
+#include "../include/ArduinoJson/Internals/StreamByteReader.hpp"
+#include "../include/ArduinoJson/Internals/StreamReader.hpp"
+#include "../include/ArduinoJson/Internals/StringReader.hpp"
+#include "../include/ArduinoJson/Internals/StringWriter.hpp"
 #include "../include/ArduinoJson/JsonArray.hpp"
 #include "../include/ArduinoJson/JsonObject.hpp"
 
@@ -24,16 +31,150 @@ JsonObject &JsonBuffer::createObject() {
   return ptr ? *ptr : JsonObject::invalid();
 }
 
+typedef JsonParser<StringReader, StringWriter> InPlaceParser;
+
 JsonArray &JsonBuffer::parseArray(char *json, uint8_t nestingLimit) {
-  JsonParser parser(this, json, nestingLimit);
+  InPlaceParser parser(this, StringReader(json), StringWriter(json),
+                       nestingLimit);
   return parser.parseArray();
 }
 
 JsonObject &JsonBuffer::parseObject(char *json, uint8_t nestingLimit) {
-  JsonParser parser(this, json, nestingLimit);
+  InPlaceParser parser(this, StringReader(json), StringWriter(json),
+                       nestingLimit);
+  return parser.parseObject();
+}
+
+JsonObject &JsonBuffer::parseObject(char *json, const JsonFilter &filter,
+                                    uint8_t nestingLimit) {
+  InPlaceParser parser(this, StringReader(json), StringWriter(json),
+                       nestingLimit);
+  return parser.parseObject(&filter);
+}
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+typedef JsonParser<StreamReader<std::istream>, JsonBufferStringWriter>
+    StdStreamParser;
+
+JsonArray &JsonBuffer::parseArray(std::istream &json, uint8_t nestingLimit) {
+  StdStreamParser parser(this, StreamReader<std::istream>(json),
+                         JsonBufferStringWriter(this), nestingLimit);
+  return parser.parseArray();
+}
+
+JsonObject &JsonBuffer::parseObject(std::istream &json, uint8_t nestingLimit) {
+  StdStreamParser parser(this, StreamReader<std::istream>(json),
+                         JsonBufferStringWriter(this), nestingLimit);
+  return parser.parseObject();
+}
+
+JsonObject &JsonBuffer::parseObject(std::istream &json,
+                                    const JsonFilter &filter,
+                                    uint8_t nestingLimit) {
+  StdStreamParser parser(this, StreamReader<std::istream>(json),
+                         JsonBufferStringWriter(this), nestingLimit);
+  return parser.parseObject(&filter);
+}
+#endif
+
+#ifdef ARDUINO
+typedef JsonParser<StreamReader<Stream>, JsonBufferStringWriter>
+    ArduinoStreamParser;
+
+JsonArray &JsonBuffer::parseArray(Stream &json, uint8_t nestingLimit) {
+  ArduinoStreamParser parser(this, StreamReader<Stream>(json),
+                             JsonBufferStringWriter(this), nestingLimit);
+  return parser.parseArray();
+}
+
+JsonObject &JsonBuffer::parseObject(Stream &json, uint8_t nestingLimit) {
+  ArduinoStreamParser parser(this, StreamReader<Stream>(json),
+                             JsonBufferStringWriter(this), nestingLimit);
+  return parser.parseObject();
+}
+
+JsonObject &JsonBuffer::parseObject(Stream &json, const JsonFilter &filter,
+                                    uint8_t nestingLimit) {
+  ArduinoStreamParser parser(this, StreamReader<Stream>(json),
+                             JsonBufferStringWriter(this), nestingLimit);
+  return parser.parseObject(&filter);
+}
+#endif
+
+typedef MsgPackParser<MemoryByteReader> MemoryMsgPackParser;
+
+JsonArray &JsonBuffer::parseMsgPackArray(const uint8_t *data, size_t length,
+                                         uint8_t nestingLimit) {
+  MemoryMsgPackParser parser(this, MemoryByteReader(data, length),
+                             nestingLimit);
+  return parser.parseArray();
+}
+
+JsonObject &JsonBuffer::parseMsgPackObject(const uint8_t *data, size_t length,
+                                           uint8_t nestingLimit) {
+  MemoryMsgPackParser parser(this, MemoryByteReader(data, length),
+                             nestingLimit);
+  return parser.parseObject();
+}
+
+JsonObject &JsonBuffer::parseMsgPackObject(const uint8_t *data, size_t length,
+                                           const JsonFilter &filter,
+                                           uint8_t nestingLimit) {
+  MemoryMsgPackParser parser(this, MemoryByteReader(data, length),
+                             nestingLimit);
+  return parser.parseObject(&filter);
+}
+
+#if ARDUINOJSON_ENABLE_STD_STREAM
+typedef MsgPackParser<StreamByteReader<std::istream> > StdStreamMsgPackParser;
+
+JsonArray &JsonBuffer::parseMsgPackArray(std::istream &data,
+                                         uint8_t nestingLimit) {
+  StdStreamMsgPackParser parser(this, StreamByteReader<std::istream>(data),
+                                nestingLimit);
+  return parser.parseArray();
+}
+
+JsonObject &JsonBuffer::parseMsgPackObject(std::istream &data,
+                                           uint8_t nestingLimit) {
+  StdStreamMsgPackParser parser(this, StreamByteReader<std::istream>(data),
+                                nestingLimit);
+  return parser.parseObject();
+}
+
+JsonObject &JsonBuffer::parseMsgPackObject(std::istream &data,
+                                           const JsonFilter &filter,
+                                           uint8_t nestingLimit) {
+  StdStreamMsgPackParser parser(this, StreamByteReader<std::istream>(data),
+                                nestingLimit);
+  return parser.parseObject(&filter);
+}
+#endif
+
+#ifdef ARDUINO
+typedef MsgPackParser<StreamByteReader<Stream> > ArduinoStreamMsgPackParser;
+
+JsonArray &JsonBuffer::parseMsgPackArray(Stream &data, uint8_t nestingLimit) {
+  ArduinoStreamMsgPackParser parser(this, StreamByteReader<Stream>(data),
+                                    nestingLimit);
+  return parser.parseArray();
+}
+
+JsonObject &JsonBuffer::parseMsgPackObject(Stream &data, uint8_t nestingLimit) {
+  ArduinoStreamMsgPackParser parser(this, StreamByteReader<Stream>(data),
+                                    nestingLimit);
   return parser.parseObject();
 }
 
+JsonObject &JsonBuffer::parseMsgPackObject(Stream &data,
+                                           const JsonFilter &filter,
+                                           uint8_t nestingLimit) {
+  ArduinoStreamMsgPackParser parser(this, StreamByteReader<Stream>(data),
+                                    nestingLimit);
+  return parser.parseObject(&filter);
+}
+#endif
+
 char *JsonBuffer::strdup(const char *source, size_t length) {
   size_t size = length + 1;
   char *dest = static_cast<char *>(alloc(size));
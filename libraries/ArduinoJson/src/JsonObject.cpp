@@ -42,3 +42,12 @@ void JsonObject::writeTo(JsonWriter &writer) const {
 
   writer.endObject();
 }
+
+void JsonObject::writeTo(MsgPackWriter &writer) const {
+  writer.beginObject(size());
+
+  for (const node_type *node = _firstNode; node; node = node->next) {
+    writer.writeString(node->content.key);
+    node->content.value.writeTo(writer);
+  }
+}
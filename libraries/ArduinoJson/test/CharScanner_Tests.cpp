@@ -0,0 +1,117 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include <ArduinoJson/Internals/CharScanner.hpp>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace ArduinoJson::Internals;
+
+// CharScanner must give the same answers as ScalarScanner whatever the
+// alignment of the string and wherever the stop character falls in a block.
+class CharScanner_Tests : public testing::Test {
+ protected:
+  // Copies s at every offset of a 64-byte aligned buffer and compares
+  void checkAllOffsets(const std::string& s) {
+    for (size_t offset = 0; offset < 64; offset++) {
+      char* p = _buffer + offset;
+      memcpy(p, s.c_str(), s.size() + 1);
+      compare(p, p + s.size() + 1, s, offset);
+    }
+  }
+
+  // The same in an allocation of exactly the string's size, so that a
+  // sanitizer build catches any read past its terminator
+  void checkExactAllocation(const std::string& s) {
+    std::vector<char> copy(s.c_str(), s.c_str() + s.size() + 1);
+    compare(&copy[0], &copy[0] + copy.size(), s, 0);
+  }
+
+  void compare(const char* p, const char* end, const std::string& s,
+               size_t offset) {
+    ASSERT_EQ(ScalarScanner::stringRun(p, end, '"'),
+              CharScanner::stringRun(p, end, '"'))
+        << s << " at " << offset;
+    ASSERT_EQ(ScalarScanner::stringRun(p, end, '\''),
+              CharScanner::stringRun(p, end, '\''))
+        << s << " at " << offset;
+    ASSERT_EQ(ScalarScanner::spaces(p, end), CharScanner::spaces(p, end))
+        << s << " at " << offset;
+    ASSERT_EQ(ScalarScanner::word(p, end), CharScanner::word(p, end))
+        << s << " at " << offset;
+  }
+
+  static size_t run(const char* s, char quote) {
+    return ScalarScanner::stringRun(s, s + strlen(s) + 1, quote);
+  }
+  static size_t spaces(const char* s) {
+    return ScalarScanner::spaces(s, s + strlen(s) + 1);
+  }
+  static size_t word(const char* s) {
+    return ScalarScanner::word(s, s + strlen(s) + 1);
+  }
+
+  alignas(64) char _buffer[256];
+};
+
+TEST_F(CharScanner_Tests, ScalarRuns) {
+  EXPECT_EQ(5U, run("hello\"", '"'));
+  EXPECT_EQ(2U, run("a'\\", '\\'));
+  EXPECT_EQ(1U, run("a\\nb\"", '"'));
+  EXPECT_EQ(3U, run("a\"b", '\''));
+  EXPECT_EQ(4U, spaces(" \t\r\n{"));
+  EXPECT_EQ(0U, spaces("/* */"));
+  EXPECT_EQ(6U, word("-1.5e3,"));
+  EXPECT_EQ(4U, word("true}"));
+}
+
+TEST_F(CharScanner_Tests, EveryStopPosition) {
+  const char stops[] = {'"', '\'', '\\', ' ', '\t', '\n', ',', ':', '}', ']',
+                        '{', '[', '/', '+', '_', '\x7f', '\x80', '\xff'};
+  for (size_t length = 0; length < 70; length++) {
+    for (size_t i = 0; i < sizeof(stops); i++) {
+      checkAllOffsets(std::string(length, 'a') + stops[i] + "tail");
+      checkAllOffsets(std::string(length, ' ') + stops[i] + "tail");
+      checkAllOffsets(std::string(length, '7') + stops[i]);
+    }
+    checkAllOffsets(std::string(length, 'x'));
+    checkAllOffsets(std::string(length, '\n'));
+    checkExactAllocation(std::string(length, 'x'));
+    checkExactAllocation(std::string(length, ' '));
+    checkExactAllocation(std::string(length, '7'));
+  }
+}
+
+TEST_F(CharScanner_Tests, RandomStrings) {
+  const char alphabet[] = "aZ09-. \t\r\n\"'\\,:{}[]/\x80\xfe";
+  srand(42);
+  for (int n = 0; n < 2000; n++) {
+    std::string s(static_cast<size_t>(rand() % 120), 'a');
+    for (size_t i = 0; i < s.size(); i++)
+      s[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+    checkAllOffsets(s);
+  }
+}
+
+TEST_F(CharScanner_Tests, ParserUsesTheRuns) {
+  std::string name(100, 'n');
+  std::string json = "{  \"" + name + "\\\"x\"  :\n\t [ 123456789012 , '" +
+                     name + "'  , true ] , \"k\"  : value }";
+  DynamicJsonBuffer jsonBuffer;
+  JsonObject& root = jsonBuffer.parseObject(json.c_str());
+  ASSERT_TRUE(root.success());
+
+  JsonArray& array = root[(name + "\"x").c_str()];
+  ASSERT_TRUE(array.success());
+  EXPECT_EQ(123456789012LL, array[0].as<long long>());
+  EXPECT_EQ(name, array[1].as<const char*>());
+  EXPECT_TRUE(array[2].as<bool>());
+  EXPECT_STREQ("value", root["k"]);
+}
@@ -0,0 +1,136 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include <sstream>
+
+namespace {
+struct Induction {
+  char by[8];
+  long on;
+};
+
+struct Reply {
+  int access;
+  bool trainer;
+  unsigned char level;
+  float credit;
+  char name[8];
+  Induction induction;
+};
+
+constexpr auto inductionBinding =
+    jsonBinding(jsonField("by", &Induction::by), jsonField("on", &Induction::on));
+
+constexpr auto replyBinding =
+    jsonBinding(jsonField("access", &Reply::access),
+                jsonField("trainer", &Reply::trainer),
+                jsonField("level", &Reply::level),
+                jsonField("credit", &Reply::credit),
+                jsonField("name", &Reply::name),
+                jsonField("induction", &Reply::induction, inductionBinding));
+}
+
+class JsonBinding_Tests : public testing::Test {
+ protected:
+  virtual void SetUp() { memset(&_reply, 0, sizeof(_reply)); }
+
+  void parseMustSucceed(const char* json) {
+    ASSERT_TRUE(replyBinding.parse(json, _reply));
+  }
+
+  void parseMustFail(const char* json, uint8_t nestingLimit = 10) {
+    EXPECT_FALSE(replyBinding.parse(json, _reply, nestingLimit));
+  }
+
+  Reply _reply;
+};
+
+TEST_F(JsonBinding_Tests, KeysAreHashedAtCompileTime) {
+  static_assert(Internals::hashKey("access") != Internals::hashKey("trainer"),
+                "distinct hashes");
+  EXPECT_EQ(2166136261u, Internals::hashKey(""));
+}
+
+TEST_F(JsonBinding_Tests, AllFields) {
+  parseMustSucceed(
+      "{\"access\":1,\"trainer\":true,\"level\":3,\"credit\":2.5,"
+      "\"name\":\"Bob\",\"induction\":{\"by\":\"Alice\",\"on\":1462060800}}");
+  EXPECT_EQ(1, _reply.access);
+  EXPECT_TRUE(_reply.trainer);
+  EXPECT_EQ(3, _reply.level);
+  EXPECT_FLOAT_EQ(2.5f, _reply.credit);
+  EXPECT_STREQ("Bob", _reply.name);
+  EXPECT_STREQ("Alice", _reply.induction.by);
+  EXPECT_EQ(1462060800L, _reply.induction.on);
+}
+
+TEST_F(JsonBinding_Tests, ConvertsAsJsonVariant) {
+  parseMustSucceed("{\"access\":\"1\",\"trainer\":1,\"credit\":\"0.5\"}");
+  EXPECT_EQ(1, _reply.access);
+  EXPECT_TRUE(_reply.trainer);
+  EXPECT_FLOAT_EQ(0.5f, _reply.credit);
+}
+
+TEST_F(JsonBinding_Tests, MissingFieldsAreLeftAlone) {
+  _reply.access = 7;
+  parseMustSucceed("{\"trainer\":false}");
+  EXPECT_EQ(7, _reply.access);
+  EXPECT_FALSE(_reply.trainer);
+}
+
+TEST_F(JsonBinding_Tests, UnknownMembersAreSkipped) {
+  parseMustSucceed(
+      "{\"extra\":[1,{\"access\":5}],\"access\":1,\"accessX\":2,"
+      "\"thisKeyIsLongerThanAnyFieldCanBeSoItIsSkipped\":3}");
+  EXPECT_EQ(1, _reply.access);
+}
+
+TEST_F(JsonBinding_Tests, StringsAreTruncated) {
+  parseMustSucceed("{\"name\":\"Bartholomew\"}");
+  EXPECT_STREQ("Barthol", _reply.name);
+}
+
+TEST_F(JsonBinding_Tests, NullString) {
+  strcpy(_reply.name, "Bob");
+  parseMustSucceed("{\"name\":null}");
+  EXPECT_STREQ("", _reply.name);
+}
+
+TEST_F(JsonBinding_Tests, SpacesAndComments) {
+  parseMustSucceed(" { 'access' /* c */ : 1 , // c\n \"name\" : 'Bob' } ");
+  EXPECT_EQ(1, _reply.access);
+  EXPECT_STREQ("Bob", _reply.name);
+}
+
+TEST_F(JsonBinding_Tests, WrongTypeFails) {
+  parseMustFail("{\"access\":[1]}");
+  parseMustFail("{\"name\":{}}");
+  parseMustFail("{\"induction\":1}");
+}
+
+TEST_F(JsonBinding_Tests, InvalidJsonFails) {
+  parseMustFail("");
+  parseMustFail("[1]");
+  parseMustFail("{\"access\" 1}");
+  parseMustFail("{\"access\":1");
+  parseMustFail("{\"access\":1,\"extra\":[1 2]}");
+}
+
+TEST_F(JsonBinding_Tests, NestingLimit) {
+  parseMustFail("{\"induction\":{\"by\":\"Alice\"}}", 0);
+  parseMustSucceed("{\"induction\":{\"by\":\"Alice\"}}");
+}
+
+TEST_F(JsonBinding_Tests, Stream) {
+  std::istringstream stream("{\"access\":1,\"name\":\"Bob\"}\r\nnext");
+  ASSERT_TRUE(replyBinding.parse(stream, _reply));
+  EXPECT_EQ(1, _reply.access);
+  EXPECT_STREQ("Bob", _reply.name);
+  EXPECT_EQ('\r', stream.get());
+}
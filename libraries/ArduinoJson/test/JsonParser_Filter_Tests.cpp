@@ -0,0 +1,117 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include <sstream>
+
+static const char* accessKeys[] = {"access", "trainer", NULL};
+
+class JsonParser_Filter_Tests : public testing::Test {
+ protected:
+  void whenInputIs(const char* json) { strcpy(_jsonString, json); }
+
+  void parseMustSucceed(const char** keys = accessKeys) {
+    _object = &_jsonBuffer.parseObject(_jsonString, JsonFilter(keys));
+    ASSERT_TRUE(_object->success());
+  }
+
+  void parseMustFail(uint8_t nestingLimit = 10) {
+    EXPECT_FALSE(_jsonBuffer
+                     .parseObject(_jsonString, JsonFilter(accessKeys),
+                                  nestingLimit)
+                     .success());
+  }
+
+  DynamicJsonBuffer _jsonBuffer;
+  JsonObject* _object;
+  char _jsonString[256];
+};
+
+TEST_F(JsonParser_Filter_Tests, KeepsListedMembers) {
+  whenInputIs("{\"access\":1,\"name\":\"Bob\",\"trainer\":0,\"expiry\":9}");
+  parseMustSucceed();
+  EXPECT_EQ(2, _object->size());
+  EXPECT_EQ(1, (*_object)["access"]);
+  EXPECT_EQ(0, (*_object)["trainer"]);
+  EXPECT_FALSE(_object->containsKey("name"));
+  EXPECT_FALSE(_object->containsKey("expiry"));
+}
+
+TEST_F(JsonParser_Filter_Tests, MissingMembers) {
+  whenInputIs("{\"name\":\"Bob\"}");
+  parseMustSucceed();
+  EXPECT_EQ(0, _object->size());
+}
+
+TEST_F(JsonParser_Filter_Tests, EmptyFilter) {
+  const char* none[] = {NULL};
+  whenInputIs("{\"access\":1}");
+  parseMustSucceed(none);
+  EXPECT_EQ(0, _object->size());
+}
+
+TEST_F(JsonParser_Filter_Tests, SkipsAnyValue) {
+  whenInputIs(
+      "{'a':[1,[2,{}],{'x':'}'}],\"b\":{\"c\":\"]\\\",\",'d':[]},"
+      "\"access\":1, /* comment */ \"e\":true, 'f' : \"\\u00e9\"}");
+  parseMustSucceed();
+  EXPECT_EQ(1, _object->size());
+  EXPECT_EQ(1, (*_object)["access"]);
+}
+
+TEST_F(JsonParser_Filter_Tests, KeptValuesAreParsedWhole) {
+  whenInputIs("{\"access\":{\"name\":\"Bob\",\"list\":[1,2]}}");
+  parseMustSucceed();
+  EXPECT_STREQ("Bob", (*_object)["access"]["name"]);
+  EXPECT_EQ(2, (*_object)["access"]["list"][1]);
+}
+
+TEST_F(JsonParser_Filter_Tests, InvalidSkippedValue) {
+  whenInputIs("{\"name\":[1 2],\"access\":1}");
+  parseMustFail();
+}
+
+TEST_F(JsonParser_Filter_Tests, UnterminatedSkippedValue) {
+  whenInputIs("{\"access\":1,\"name\":{\"first\":\"Bob\"");
+  parseMustFail();
+}
+
+TEST_F(JsonParser_Filter_Tests, NestingLimitAppliesToSkippedValues) {
+  whenInputIs("{\"access\":1,\"a\":[[1]]}");
+  parseMustFail(1);
+}
+
+TEST(JsonParser_StaticFilter_Tests, SkippedMembersTakeNoMemory) {
+  StaticJsonBuffer<JSON_OBJECT_SIZE(2)> jsonBuffer;
+  char json[] =
+      "{\"access\":1,\"name\":\"Robert\",\"trainer\":1,"
+      "\"expiry\":\"2017-01-01\",\"roles\":[\"a\",\"b\",\"c\"]}";
+  JsonObject& object = jsonBuffer.parseObject(json, JsonFilter(accessKeys));
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ(JSON_OBJECT_SIZE(2), jsonBuffer.size());
+  EXPECT_EQ(1, object["trainer"]);
+}
+
+TEST(JsonParser_StaticFilter_Tests, StreamAllocatesKeptStringsOnly) {
+  StaticJsonBuffer<JSON_OBJECT_SIZE(2) + 64> jsonBuffer;
+  std::istringstream stream(
+      "{\"name\":\"Robert\",\"access\":1,\"expiry\":\"2017-01-01\","
+      "\"trainer\":0,\"roles\":[\"a\",\"b\"]} rest");
+  JsonObject& object = jsonBuffer.parseObject(stream, JsonFilter(accessKeys));
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ(1, object["access"]);
+  EXPECT_EQ(0, object["trainer"]);
+
+  // the two members and their strings only
+  StaticJsonBuffer<JSON_OBJECT_SIZE(2) + 64> reference;
+  std::istringstream kept("{\"access\":1,\"trainer\":0}");
+  reference.parseObject(kept);
+  EXPECT_EQ(reference.size(), jsonBuffer.size());
+
+  EXPECT_EQ(' ', stream.get());
+}
@@ -0,0 +1,145 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include <sstream>
+#include <string>
+
+class JsonParser_Stream_Tests : public testing::Test {
+ protected:
+  void whenInputIs(const char* json) { _stream.str(json); }
+
+  void parseObjectMustSucceed() {
+    _object = &_jsonBuffer.parseObject(_stream);
+    ASSERT_TRUE(_object->success());
+  }
+
+  void parseObjectMustFail() {
+    EXPECT_FALSE(_jsonBuffer.parseObject(_stream).success());
+  }
+
+  std::string remainingInput() {
+    std::string rest;
+    std::getline(_stream, rest, '\0');
+    return rest;
+  }
+
+  DynamicJsonBuffer _jsonBuffer;
+  std::istringstream _stream;
+  JsonObject* _object;
+};
+
+TEST_F(JsonParser_Stream_Tests, EmptyObject) {
+  whenInputIs("{}");
+  parseObjectMustSucceed();
+  EXPECT_EQ(0, _object->size());
+}
+
+TEST_F(JsonParser_Stream_Tests, EmptyStream) {
+  whenInputIs("");
+  parseObjectMustFail();
+}
+
+TEST_F(JsonParser_Stream_Tests, Values) {
+  whenInputIs("{\"access\":1,\"trainer\":0,\"name\":\"door\",\"t\":12.5}");
+  parseObjectMustSucceed();
+  EXPECT_EQ(1, (*_object)["access"]);
+  EXPECT_EQ(0, (*_object)["trainer"]);
+  EXPECT_STREQ("door", (*_object)["name"]);
+  EXPECT_EQ(12.5, (*_object)["t"]);
+}
+
+TEST_F(JsonParser_Stream_Tests, SpacesAndComments) {
+  whenInputIs(" /* c */ { \"a\" // c\n : 1 ,\t'b' : true\r\n}");
+  parseObjectMustSucceed();
+  EXPECT_EQ(1, (*_object)["a"]);
+  EXPECT_TRUE((*_object)["b"].as<bool>());
+}
+
+TEST_F(JsonParser_Stream_Tests, EscapedChars) {
+  whenInputIs("{\"a\":\"1\\\"2\\\\3\\/4\\n5\"}");
+  parseObjectMustSucceed();
+  EXPECT_STREQ("1\"2\\3/4\n5", (*_object)["a"]);
+}
+
+TEST_F(JsonParser_Stream_Tests, NestedValues) {
+  whenInputIs("{\"tokens\":[\"a1\",\"b2\"],\"o\":{\"x\":[1,[2]]}}");
+  parseObjectMustSucceed();
+  EXPECT_STREQ("b2", (*_object)["tokens"][1]);
+  EXPECT_EQ(2, (*_object)["o"]["x"][1][0]);
+}
+
+TEST_F(JsonParser_Stream_Tests, Array) {
+  _stream.str("[1, \"two\", {\"three\":3}]");
+  JsonArray& array = _jsonBuffer.parseArray(_stream);
+  ASSERT_TRUE(array.success());
+  EXPECT_EQ(3, array.size());
+  EXPECT_STREQ("two", array[1]);
+  EXPECT_EQ(3, array[2]["three"]);
+}
+
+TEST_F(JsonParser_Stream_Tests, StopsAfterClosingBrace) {
+  whenInputIs("{\"a\":1}\r\n{\"a\":2}");
+  parseObjectMustSucceed();
+  EXPECT_EQ("\r\n{\"a\":2}", remainingInput());
+}
+
+TEST_F(JsonParser_Stream_Tests, StopsAfterClosingBracket) {
+  _stream.str("[1,2] trailing");
+  ASSERT_TRUE(_jsonBuffer.parseArray(_stream).success());
+  EXPECT_EQ(" trailing", remainingInput());
+}
+
+TEST_F(JsonParser_Stream_Tests, UnterminatedObject) {
+  whenInputIs("{\"a\":1");
+  parseObjectMustFail();
+}
+
+TEST_F(JsonParser_Stream_Tests, UnterminatedString) {
+  whenInputIs("{\"a\":\"abc");
+  parseObjectMustFail();
+}
+
+TEST_F(JsonParser_Stream_Tests, StringsOutliveTheStream) {
+  {
+    std::istringstream stream("{\"key\":\"value\"}");
+    _object = &_jsonBuffer.parseObject(stream);
+  }
+  ASSERT_TRUE(_object->success());
+  EXPECT_STREQ("value", (*_object)["key"]);
+}
+
+TEST_F(JsonParser_Stream_Tests, StringLongerThanABlock) {
+  std::string value(1000, 'x');
+  whenInputIs(("{\"v\":\"" + value + "\",\"w\":\"" + value + "\"}").c_str());
+  parseObjectMustSucceed();
+  EXPECT_EQ(value, (*_object)["v"].as<const char*>());
+  EXPECT_EQ(value, (*_object)["w"].as<const char*>());
+}
+
+TEST(JsonParser_StaticStream_Tests, StringsTakeOnlyTheirLength) {
+  StaticJsonBuffer<JSON_OBJECT_SIZE(1) + 64> jsonBuffer;
+  std::istringstream stream("{\"key\":\"value\"}");
+  JsonObject& object = jsonBuffer.parseObject(stream);
+  ASSERT_TRUE(object.success());
+  EXPECT_STREQ("value", object["key"]);
+
+  // same nodes as parsing in place, plus a copy of each string
+  StaticJsonBuffer<JSON_OBJECT_SIZE(1) + 64> reference;
+  char json[] = "{\"key\":\"value\"}";
+  reference.parseObject(json);
+  reference.strdup("key");
+  reference.strdup("value");
+  EXPECT_EQ(reference.size(), jsonBuffer.size());
+}
+
+TEST(JsonParser_StaticStream_Tests, TooSmallBufferForString) {
+  StaticJsonBuffer<JSON_OBJECT_SIZE(1) + 8> jsonBuffer;
+  std::istringstream stream("{\"key\":\"a value too long\"}");
+  EXPECT_FALSE(jsonBuffer.parseObject(stream).success());
+}
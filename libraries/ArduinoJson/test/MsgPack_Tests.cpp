@@ -0,0 +1,204 @@
+// Copyright Benoit Blanchon 2014-2016
+// MIT License
+//
+// Arduino JSON library
+// https://github.com/bblanchon/ArduinoJson
+// If you like this project, please add a star!
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include <sstream>
+#include <string>
+
+// Builds a byte string from a literal that may contain '\0'
+#define BYTES(literal) std::string(literal, sizeof(literal) - 1)
+
+class MsgPack_Tests : public testing::Test {
+ protected:
+  template <typename T>
+  std::string pack(const T& value) {
+    std::ostringstream os;
+    value.printMsgPackTo(os);
+    EXPECT_EQ(os.str().size(), value.measureMsgPackLength());
+    return os.str();
+  }
+
+  std::string packJson(const char* json) {
+    return pack(_jsonBuffer.parseObject(json));
+  }
+
+  JsonObject& unpackObject(const std::string& data, uint8_t nesting = 10) {
+    return _jsonBuffer.parseMsgPackObject(
+        reinterpret_cast<const uint8_t*>(data.data()), data.size(), nesting);
+  }
+
+  JsonArray& unpackArray(const std::string& data) {
+    return _jsonBuffer.parseMsgPackArray(
+        reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  }
+
+  std::string toJson(const JsonObject& object) {
+    std::ostringstream os;
+    object.printTo(os);
+    return os.str();
+  }
+
+  DynamicJsonBuffer _jsonBuffer;
+};
+
+TEST_F(MsgPack_Tests, EncodesScalars) {
+  EXPECT_EQ(BYTES("\x85\xa1s\xa2hi\xa1t\xc3\xa1" "f\xc2\xa1n\xc0\xa1i\x05"),
+            packJson("{s:'hi',t:true,f:false,n:null,i:5}"));
+}
+
+TEST_F(MsgPack_Tests, EncodesIntegersCompactly) {
+  JsonArray& array = _jsonBuffer.createArray();
+  array.add(127);
+  array.add(128);
+  array.add(65535);
+  array.add(65536);
+  array.add(-32);
+  array.add(-33);
+  array.add(-129);
+  EXPECT_EQ(BYTES("\x97\x7f\xcc\x80\xcd\xff\xff\xce\x00\x01\x00\x00"
+                  "\xe0\xd0\xdf\xd1\xff\x7f"),
+            pack(array));
+}
+
+TEST_F(MsgPack_Tests, EncodesRawJsonTokensByType) {
+  EXPECT_EQ(BYTES("\x83\xa1" "a\xcd\x01\x2c\xa1" "b\xff\xa1" "c\xa3xyz"),
+            packJson("{a:300,b:-1,c:xyz}"));
+}
+
+TEST_F(MsgPack_Tests, EncodesFloats) {
+  std::string packed = packJson("{x:1.5}");
+  // float 64 when JsonFloat is a double
+  EXPECT_EQ(packed[3] == '\xcb' ? 12U : 8U, packed.size());
+  EXPECT_FLOAT_EQ(1.5f, unpackObject(packed)["x"].as<float>());
+}
+
+TEST_F(MsgPack_Tests, EncodesNestedAndLongContainers) {
+  JsonObject& root = _jsonBuffer.createObject();
+  JsonArray& tokens = root.createNestedArray("tokens");
+  for (int i = 0; i < 16; i++) tokens.add(i);
+  std::string packed = pack(root);
+  EXPECT_EQ(BYTES("\x81\xa6tokens\xdc\x00\x10\x00\x01"), packed.substr(0, 13));
+  EXPECT_EQ(27U, packed.size());
+}
+
+TEST_F(MsgPack_Tests, EncodesLongStrings) {
+  std::string text(40, 'x');
+  JsonArray& array = _jsonBuffer.createArray();
+  array.add(text.c_str());
+  EXPECT_EQ(BYTES("\x91\xd9\x28") + text, pack(array));
+}
+
+TEST_F(MsgPack_Tests, RoundTrip) {
+  const char* json =
+      "{\"access\":1,\"trainer\":0,\"name\":\"Bob\","
+      "\"tokens\":[\"04a1b2c3\",\"04d5e6f7\"],\"limits\":{\"max\":-70000}}";
+  JsonObject& object = unpackObject(packJson(json));
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ(json, toJson(object));
+}
+
+TEST_F(MsgPack_Tests, DecodesAllIntegerWidths) {
+  JsonArray& array = unpackArray(
+      BYTES("\x98\x01\xff\xcc\xc8\xcd\x01\x00\xce\x00\x01\x00\x00"
+            "\xd0\x80\xd1\x80\x00\xd2\x80\x00\x00\x00"));
+  ASSERT_TRUE(array.success());
+  EXPECT_EQ(1, array[0]);
+  EXPECT_EQ(-1, array[1]);
+  EXPECT_EQ(200, array[2]);
+  EXPECT_EQ(256, array[3]);
+  EXPECT_EQ(65536, array[4]);
+  EXPECT_EQ(-128, array[5]);
+  EXPECT_EQ(-32768, array[6]);
+  EXPECT_EQ(-2147483647L - 1, array[7].as<long>());
+}
+
+TEST_F(MsgPack_Tests, DecodesFloat64) {
+  JsonArray& array =
+      unpackArray(BYTES("\x91\xcb\x40\x09\x21\xfb\x54\x44\x2d\x18"));
+  ASSERT_TRUE(array.success());
+  EXPECT_NEAR(3.14159265, array[0].as<double>(), 1e-6);
+}
+
+TEST_F(MsgPack_Tests, NilReadsAsNull) {
+  JsonObject& object = unpackObject(BYTES("\x81\xa1n\xc0"));
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ("{\"n\":null}", toJson(object));
+}
+
+TEST_F(MsgPack_Tests, KeepsStringsWithoutTheInput) {
+  std::string packed = packJson("{\"name\":\"Bob\"}");
+  JsonObject& object = unpackObject(packed);
+  packed.assign(packed.size(), 'x');
+  EXPECT_STREQ("Bob", object["name"]);
+}
+
+TEST_F(MsgPack_Tests, Filter) {
+  static const char* keys[] = {"access", "trainer", NULL};
+  std::string packed = packJson(
+      "{\"name\":\"Bob\",\"access\":1,\"x\":[[1,{\"y\":2.5}],\"z\"],"
+      "\"trainer\":0}");
+  JsonObject& object = _jsonBuffer.parseMsgPackObject(
+      reinterpret_cast<const uint8_t*>(packed.data()), packed.size(),
+      JsonFilter(keys));
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ("{\"access\":1,\"trainer\":0}", toJson(object));
+}
+
+TEST_F(MsgPack_Tests, StopsAtTheEndOfTheRoot) {
+  std::istringstream stream(packJson("{\"access\":1}") + "rest");
+  JsonObject& object = _jsonBuffer.parseMsgPackObject(stream);
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ(1, object["access"]);
+  std::string rest;
+  stream >> rest;
+  EXPECT_EQ("rest", rest);
+}
+
+TEST_F(MsgPack_Tests, StreamFilter) {
+  static const char* keys[] = {"access", NULL};
+  std::istringstream stream(packJson("{\"name\":\"Bob\",\"access\":1}"));
+  JsonObject& object = _jsonBuffer.parseMsgPackObject(stream, JsonFilter(keys));
+  ASSERT_TRUE(object.success());
+  EXPECT_EQ("{\"access\":1}", toJson(object));
+}
+
+TEST_F(MsgPack_Tests, FailsOnTruncatedData) {
+  std::string packed = packJson("{\"name\":\"Bob\",\"n\":300}");
+  for (size_t i = 0; i < packed.size(); i++)
+    EXPECT_FALSE(unpackObject(packed.substr(0, i)).success()) << i;
+
+  std::istringstream stream(packed.substr(0, packed.size() - 1));
+  EXPECT_FALSE(_jsonBuffer.parseMsgPackObject(stream).success());
+}
+
+TEST_F(MsgPack_Tests, FailsOnWrongRootType) {
+  EXPECT_FALSE(unpackObject(BYTES("\x90")).success());
+  EXPECT_FALSE(unpackArray(BYTES("\x80")).success());
+}
+
+TEST_F(MsgPack_Tests, FailsOnUnsupportedTypes) {
+  EXPECT_FALSE(unpackArray(BYTES("\x91\xc4\x01x")).success());      // bin
+  EXPECT_FALSE(unpackArray(BYTES("\x91\xd4\x01\x02")).success());   // ext
+  EXPECT_FALSE(unpackObject(BYTES("\x81\x01\x02")).success());      // key
+}
+
+TEST_F(MsgPack_Tests, NestingLimit) {
+  std::string packed = BYTES("\x81\xa1" "a\x91\x91\x01");
+  EXPECT_FALSE(unpackObject(packed, 2).success());
+  EXPECT_TRUE(unpackObject(packed, 3).success());
+}
+
+TEST_F(MsgPack_Tests, FailsWhenBufferIsFull) {
+  StaticJsonBuffer<JSON_OBJECT_SIZE(1) + 2> buffer;
+  std::string packed = packJson("{\"name\":\"Bob\"}");
+  EXPECT_FALSE(buffer
+                   .parseMsgPackObject(
+                       reinterpret_cast<const uint8_t*>(packed.data()),
+                       packed.size())
+                   .success());
+}
@@ -2,7 +2,9 @@
 
 CardReader522::CardReader522() :
     mfrc522(SS_PIN, RST_PIN)
-{ }
+{
+    lastToken[0] = 0;
+}
 
 void CardReader522::init()
 {
@@ -15,13 +17,13 @@ bool CardReader522::check()
   bool ret = false;
 
   // Token debounce
-  if (lastToken != "" && millis() > lastTokenTime + TOKEN_DEBOUNCE_TIME_MS) {
+  if (lastToken[0] != 0 && millis() > lastTokenTime + TOKEN_DEBOUNCE_TIME_MS) {
     Serial.println(F("Clear last token"));
-    lastToken = "";
+    lastToken[0] = 0;
   }
 
   // Check card reader
-  if (millis() > cardreaderLastCheck + CARDREADER_CHECK_INTERVAL_MS && lastToken=="") {
+  if (millis() > cardreaderLastCheck + CARDREADER_CHECK_INTERVAL_MS && lastToken[0] == 0) {
 
     // Init the reader on every call to make sure its working correctly.
     // Checking version first doesn't seem a reliable way to test if its working
@@ -35,13 +37,13 @@ bool CardReader522::check()
       if (mfrc522.PICC_ReadCardSerial()) {
         lastTokenTime = millis();
 
-        updateTokenStr(mfrc522.uid.uidByte, mfrc522.uid.size);
+        formatToken(tokenStr, mfrc522.uid.uidByte, mfrc522.uid.size);
 
         Serial.print(F(" -> with UID: "));
-        Serial.println(String(tokenStr));
+        Serial.println(tokenStr);
 
-        if (lastToken != String(tokenStr)) {
-          lastToken = String(tokenStr);
+        if (strcmp(lastToken, tokenStr) != 0) {
+          memcpy(lastToken, tokenStr, TOKEN_STR_SIZE);
           lastLen = mfrc522.uid.size;
           memcpy(lastUID, mfrc522.uid.uidByte, mfrc522.uid.size);
           ret = true;
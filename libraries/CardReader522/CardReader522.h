@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <MFRC522.h>
 #include <TokenCache.h>
+#include <FixedString.h>
 
 // RST-PIN for RC522 - RFID - SPI - Modul GPIO5 
 #define RST_PIN 16 
@@ -19,7 +20,7 @@ public:
     CardReader522();
     void init();
     bool check();
-    String lastToken; // last token as string
+    char lastToken[TOKEN_STR_SIZE]; // last token as hex string, empty if none
     uint8_t lastLen; // last token length
     TOKEN lastUID; // lasttokenUID
 
@@ -27,26 +28,7 @@ private:
     MFRC522 mfrc522; 
     unsigned long cardreaderLastCheck; // last time we polled the card reader
     unsigned long lastTokenTime; // millis when last token was detected
-    char tokenStr[14]; // token as hex string
-
-    void updateTokenStr(const uint8_t *data, const uint32_t numBytes) {
-        const char * hex = "0123456789abcdef";
-        uint8_t b = 0;
-        for (uint8_t i = 0; i < numBytes; i++) {
-                tokenStr[b] = hex[(data[i]>>4)&0xF];
-                b++;
-                tokenStr[b] = hex[(data[i])&0xF];
-                b++;
-        }
-
-        // null remaining bytes in string
-        for (uint8_t i=numBytes; i < 7; i++) {
-                tokenStr[b] = 0;
-                b++;
-                tokenStr[b] = 0;
-                b++;
-        }
-    }
+    char tokenStr[TOKEN_STR_SIZE]; // token as hex string
 };
 
 #endif
\ No newline at end of file
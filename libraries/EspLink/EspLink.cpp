@@ -0,0 +1,85 @@
+#include "EspLink.h"
+
+#include <string.h>
+
+uint16_t espLinkCrc(uint16_t crc, uint8_t b)
+{
+    crc ^= (uint16_t)b << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+EspLinkDecoder::EspLinkDecoder() :
+    framesDecoded(0),
+    crcErrors(0),
+    framingErrors(0)
+{
+    reset();
+}
+
+void EspLinkDecoder::reset()
+{
+    pos = 0;
+    inFrame = false;
+    escaped = false;
+}
+
+bool EspLinkDecoder::decode(uint8_t b)
+{
+    if (b == ESPLINK_SOF) {
+        if (inFrame && pos > 0) {
+            // previous frame never finished
+            framingErrors++;
+        }
+        reset();
+        inFrame = true;
+        return false;
+    }
+
+    if (!inFrame) {
+        return false;
+    }
+
+    if (b == ESPLINK_ESC) {
+        escaped = true;
+        return false;
+    }
+    if (escaped) {
+        b ^= 0x20;
+        escaped = false;
+    }
+
+    body[pos++] = b;
+
+    if (body[0] > ESPLINK_MAX_PAYLOAD) {
+        framingErrors++;
+        reset();
+        return false;
+    }
+
+    if (pos < ESPLINK_HEADER + body[0] + 2) {
+        return false;
+    }
+
+    // complete, check the crc
+    uint8_t length = body[0];
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < ESPLINK_HEADER + length; i++) {
+        crc = espLinkCrc(crc, body[i]);
+    }
+    reset();
+
+    if (crc != ((uint16_t)body[ESPLINK_HEADER + length] << 8 | body[ESPLINK_HEADER + length + 1])) {
+        crcErrors++;
+        return false;
+    }
+
+    frame.length = length;
+    frame.seq = body[1];
+    frame.type = body[2];
+    memcpy(frame.payload, &body[ESPLINK_HEADER], length);
+    framesDecoded++;
+    return true;
+}
@@ -0,0 +1,145 @@
+#ifndef ESP_LINK_H
+#define ESP_LINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  * Framed serial link between a controller and its ESP8266 wifi bridge.
+  *
+  * frame on the wire:
+  *   SOF, length, seq, type, payload[length], crc hi, crc lo
+  *
+  * crc is CRC-16/CCITT (0x1021, init 0xFFFF) over length, seq, type and payload.
+  * Any SOF or ESC after the first byte is sent as ESC, byte ^ 0x20, so a SOF
+  * always marks the start of a frame and the decoder resyncs on the next one.
+  *
+  * seq is chosen by the requester and copied into the reply, 0 is never used.
+  */
+
+#define ESPLINK_SOF           0x7E
+#define ESPLINK_ESC           0x7D
+#define ESPLINK_MAX_PAYLOAD   48
+#define ESPLINK_HEADER        3   // length, seq, type
+#define ESPLINK_MAX_BODY      (ESPLINK_HEADER + ESPLINK_MAX_PAYLOAD + 2)
+#define ESPLINK_MAX_FRAME     (1 + 2 * ESPLINK_MAX_BODY)  // worst case, every byte escaped
+
+// message types, a reply has the request type | ESPLINK_REPLY
+#define ESPLINK_REPLY         0x80
+#define ESPLINK_VERIFY        0x01  // payload: token bytes, reply payload: flags
+#define ESPLINK_LOG           0x02  // payload: url encoded message, no reply
+#define ESPLINK_HEARTBEAT     0x03  // no payload, reply has no payload
+#define ESPLINK_TELEMETRY     0x04  // payload: ESPLINK_TELEMETRY_RECORD, no reply
+#define ESPLINK_LOOPSTATS     0x05  // payload: ESPLINK_LOOP_RECORD, no reply
+
+#define ESPLINK_LOOP_BUCKETS  14    // same as LOOP_HISTOGRAM_BUCKETS
+
+struct ESPLINK_FRAME {
+    uint8_t length;   // payload length
+    uint8_t seq;
+    uint8_t type;
+    uint8_t payload[ESPLINK_MAX_PAYLOAD];
+};
+
+/*
+  * controller stats, sent every telemetry interval
+  * packed and little endian, the same on AVR and ESP8266
+  * counts are since boot unless marked per interval
+  */
+struct ESPLINK_TELEMETRY_RECORD {
+    uint32_t uptime;        // seconds
+    uint32_t unlocks;
+    uint16_t pn532Resets;
+    uint16_t espResets;
+    uint16_t cacheHits;     // per interval
+    uint16_t cacheMisses;   // per interval
+    uint32_t loops;         // per interval
+    uint32_t loopAvg;       // us, per interval
+    uint32_t loopMax;       // us, per interval
+    uint16_t linkErrors;    // crc, framing and uart errors
+} __attribute__((packed));
+
+/*
+  * door loop timing for the telemetry interval, sent after each ESPLINK_TELEMETRY_RECORD
+  * hist - loop periods, bucket 0 under 1ms, bucket n 2^(n-1) to 2^n ms, counts stop at 65535
+  * longest, longestPhase - slowest loop, and the phase that took most of it (doorController LOOP_PHASE_)
+  * wdtGapMax - longest time between watchdog resets, the watchdog fires at 8000ms
+  * wdtNearMisses - gaps over half the watchdog timeout
+  */
+struct ESPLINK_LOOP_RECORD {
+    uint16_t hist[ESPLINK_LOOP_BUCKETS];
+    uint32_t longest;       // us
+    uint8_t longestPhase;
+    uint16_t wdtGapMax;     // ms
+    uint16_t wdtNearMisses;
+} __attribute__((packed));
+
+uint16_t espLinkCrc(uint16_t crc, uint8_t b);
+
+/*
+  * Rebuilds frames from a byte stream, one byte at a time.
+  * Bytes outside a frame are ignored, so debug output on the same line is harmless.
+  */
+class EspLinkDecoder
+{
+public:
+    EspLinkDecoder();
+
+    bool decode(uint8_t b);     // returns true when frame holds a new, valid frame
+    void reset();
+
+    ESPLINK_FRAME frame;
+
+    uint16_t framesDecoded;
+    uint16_t crcErrors;         // complete frame with a bad crc
+    uint16_t framingErrors;     // frame cut short or too long
+
+private:
+    uint8_t body[ESPLINK_MAX_BODY];
+    uint8_t pos;
+    bool inFrame;
+    bool escaped;
+};
+
+/*
+  * Writes one frame to out, which needs a write(uint8_t) e.g. an Arduino Stream.
+  * Returns the number of bytes written.
+  */
+template <class T>
+size_t espLinkSend(T &out, uint8_t seq, uint8_t type, const uint8_t *payload, uint8_t length)
+{
+    uint8_t header[ESPLINK_HEADER] = { length, seq, type };
+    uint16_t crc = 0xFFFF;
+    size_t n = 1;
+
+    out.write((uint8_t)ESPLINK_SOF);
+
+    for (uint8_t i = 0; i < ESPLINK_HEADER + length + 2; i++) {
+        uint8_t b;
+        if (i < ESPLINK_HEADER) {
+            b = header[i];
+        } else if (i < ESPLINK_HEADER + length) {
+            b = payload[i - ESPLINK_HEADER];
+        } else if (i == ESPLINK_HEADER + length) {
+            b = crc >> 8;
+        } else {
+            b = crc & 0xff;
+        }
+
+        if (i < ESPLINK_HEADER + length) {
+            crc = espLinkCrc(crc, b);
+        }
+
+        if (b == ESPLINK_SOF || b == ESPLINK_ESC) {
+            out.write((uint8_t)ESPLINK_ESC);
+            b ^= 0x20;
+            n++;
+        }
+        out.write(b);
+        n++;
+    }
+
+    return n;
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "FixedString.h"
+
+#include <string.h>
+
+static const char hexDigits[] = "0123456789abcdef";
+
+void formatToken(char *str, const uint8_t *token, uint8_t length)
+{
+    uint8_t b = 0;
+    for (uint8_t i = 0; i < length && i < 7; i++) {
+        str[b++] = hexDigits[(token[i] >> 4) & 0xF];
+        str[b++] = hexDigits[token[i] & 0xF];
+    }
+
+    // null remaining bytes in string
+    while (b < TOKEN_STR_SIZE) {
+        str[b++] = 0;
+    }
+}
+
+FixedStringBase::FixedStringBase(char *buffer, size_t size) :
+    buffer(buffer),
+    size(size)
+{
+    clear();
+}
+
+void FixedStringBase::clear()
+{
+    len = 0;
+    overflow = false;
+    buffer[0] = 0;
+}
+
+FixedStringBase &FixedStringBase::append(char c)
+{
+    if (len + 1 < size) {
+        buffer[len++] = c;
+        buffer[len] = 0;
+    } else {
+        overflow = true;
+    }
+    return *this;
+}
+
+FixedStringBase &FixedStringBase::append(const char *str, size_t length)
+{
+    if (len + length >= size) {
+        length = size - 1 - len;
+        overflow = true;
+    }
+    memcpy(buffer + len, str, length);
+    len += length;
+    buffer[len] = 0;
+    return *this;
+}
+
+FixedStringBase &FixedStringBase::append(const char *str)
+{
+    return append(str, strlen(str));
+}
+
+#ifdef ARDUINO
+FixedStringBase &FixedStringBase::append(const __FlashStringHelper *str)
+{
+    PGM_P p = reinterpret_cast<PGM_P>(str);
+    char c;
+    while ((c = pgm_read_byte(p++)) != 0) {
+        append(c);
+    }
+    return *this;
+}
+#endif
+
+FixedStringBase &FixedStringBase::appendUInt(uint32_t value)
+{
+    // digits come out backwards
+    char digits[10];
+    uint8_t n = 0;
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    while (n > 0) {
+        append(digits[--n]);
+    }
+    return *this;
+}
+
+FixedStringBase &FixedStringBase::appendInt(int32_t value)
+{
+    if (value < 0) {
+        append('-');
+        return appendUInt((uint32_t)0 - (uint32_t)value);
+    }
+    return appendUInt((uint32_t)value);
+}
+
+FixedStringBase &FixedStringBase::appendHex(const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        append(hexDigits[(data[i] >> 4) & 0xF]);
+        append(hexDigits[data[i] & 0xF]);
+    }
+    return *this;
+}
+
+// as AccessSystem::urlencode did: space to +, alphanumerics as is, the rest as %XX
+FixedStringBase &FixedStringBase::appendUrlEncoded(const char *str)
+{
+    static const char upperHex[] = "0123456789ABCDEF";
+    for (; *str; str++) {
+        char c = *str;
+        if (c == ' ') {
+            append('+');
+        } else if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            append(c);
+        } else {
+            append('%');
+            append(upperHex[(c >> 4) & 0xF]);
+            append(upperHex[c & 0xF]);
+        }
+    }
+    return *this;
+}
@@ -0,0 +1,71 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// a 7 byte token as hex, plus the null
+#define TOKEN_STR_SIZE 15
+
+// token bytes as zero padded lowercase hex, str must hold TOKEN_STR_SIZE
+void formatToken(char *str, const uint8_t *token, uint8_t length);
+
+/*
+  * Appends text into a caller supplied buffer, never allocates.
+  * Anything that does not fit is dropped and overflowed() returns true,
+  * the buffer is always null terminated.
+  */
+class FixedStringBase
+{
+public:
+    FixedStringBase &append(const char *str);
+    FixedStringBase &append(const char *str, size_t length);
+    FixedStringBase &append(char c);
+    FixedStringBase &appendUInt(uint32_t value);
+    FixedStringBase &appendInt(int32_t value);
+    FixedStringBase &appendHex(const uint8_t *data, size_t length);
+    FixedStringBase &appendUrlEncoded(const char *str);
+#ifdef ARDUINO
+    FixedStringBase &append(const __FlashStringHelper *str);
+#endif
+
+    void clear();
+    const char *c_str() const { return buffer; }
+    size_t length() const { return len; }
+    size_t capacity() const { return size - 1; }
+    bool overflowed() const { return overflow; }
+
+protected:
+    FixedStringBase(char *buffer, size_t size);
+
+private:
+    char *buffer;
+    size_t size;
+    size_t len;
+    bool overflow;
+
+    // not copyable, would copy the pointer to another object's buffer
+    FixedStringBase(const FixedStringBase &);
+    FixedStringBase &operator=(const FixedStringBase &);
+};
+
+/*
+  * FixedStringBase with its own buffer of N - 1 chars, e.g. on the stack
+  *   FixedString<128> url;
+  *   url.append("verify?token=").append(tokenStr);
+  */
+template <size_t N>
+class FixedString : public FixedStringBase
+{
+public:
+    FixedString() : FixedStringBase(storage, N) { }
+
+private:
+    char storage[N];
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "HeapMonitor.h"
+
+#if defined(ESP8266)
+#include <Esp.h>
+
+void readHeapSample(HEAP_SAMPLE &sample)
+{
+    sample.freeHeap = ESP.getFreeHeap();
+    sample.maxFreeBlock = ESP.getMaxFreeBlockSize();
+    sample.fragmentation = ESP.getHeapFragmentation();
+    sample.stackFree = ESP.getFreeContStack();
+}
+#endif
+
+HeapMonitor::HeapMonitor() :
+    lastLoopUs(0),
+    lastSampleMs(0),
+    lastReportMs(0),
+    started(false)
+{
+    HEAP_SAMPLE none = {0, 0, 0, 0};
+    last = none;
+    reset(0);
+}
+
+bool HeapMonitor::loop(uint32_t nowUs, uint32_t nowMs)
+{
+    // the first call has no previous loop to measure from
+    if (started) {
+        loops.add(nowUs - lastLoopUs);
+    } else {
+        started = true;
+        lastSampleMs = nowMs;
+        lastReportMs = nowMs;
+        sample();
+    }
+    lastLoopUs = nowUs;
+
+    if (nowMs - lastSampleMs >= HEAP_SAMPLE_INTERVAL) {
+        lastSampleMs = nowMs;
+        sample();
+    }
+
+    return nowMs - lastReportMs >= HEAP_REPORT_INTERVAL;
+}
+
+void HeapMonitor::sample()
+{
+    HEAP_SAMPLE s;
+    readHeapSample(s);
+    add(s);
+}
+
+void HeapMonitor::add(const HEAP_SAMPLE &sample)
+{
+    last = sample;
+
+    if (samples == 0) {
+        worst = sample;
+    } else {
+        if (sample.freeHeap < worst.freeHeap) worst.freeHeap = sample.freeHeap;
+        if (sample.maxFreeBlock < worst.maxFreeBlock) worst.maxFreeBlock = sample.maxFreeBlock;
+        if (sample.fragmentation > worst.fragmentation) worst.fragmentation = sample.fragmentation;
+        if (sample.stackFree < worst.stackFree) worst.stackFree = sample.stackFree;
+    }
+
+    if (samples < 0xFFFF) samples++;
+}
+
+bool HeapMonitor::toJson(FixedStringBase &json) const
+{
+    json.append("{\"freeHeap\":").appendUInt(last.freeHeap);
+    json.append(",\"minFreeHeap\":").appendUInt(worst.freeHeap);
+    json.append(",\"maxFreeBlock\":").appendUInt(last.maxFreeBlock);
+    json.append(",\"minMaxFreeBlock\":").appendUInt(worst.maxFreeBlock);
+    json.append(",\"fragmentation\":").appendUInt(last.fragmentation);
+    json.append(",\"maxFragmentation\":").appendUInt(worst.fragmentation);
+    json.append(",\"stackFree\":").appendUInt(last.stackFree);
+    json.append(",\"minStackFree\":").appendUInt(worst.stackFree);
+    json.append(",\"samples\":").appendUInt(samples);
+    json.append(",\"loops\":").appendUInt(loops.count);
+    json.append(",\"loopMaxUs\":").appendUInt(loops.max);
+
+    // bucket n counts loops of 2^(n-1) to 2^n ms, bucket 0 is under 1ms
+    json.append(",\"loopHist\":[");
+    for (uint8_t i = 0; i < LOOP_HISTOGRAM_BUCKETS; i++) {
+        if (i > 0) json.append(',');
+        json.appendUInt(loops.buckets[i]);
+    }
+    json.append("]}");
+
+    return !json.overflowed();
+}
+
+// start a new report period, keeping the latest sample
+void HeapMonitor::reset(uint32_t nowMs)
+{
+    worst = last;
+    samples = 0;
+    loops.clear();
+    lastReportMs = nowMs;
+}
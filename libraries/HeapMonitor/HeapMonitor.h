@@ -0,0 +1,66 @@
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <stdint.h>
+#include <FixedString.h>
+#include <LoopHistogram.h>
+
+#define HEAP_SAMPLE_INTERVAL   1000     // ms between heap samples
+#define HEAP_REPORT_INTERVAL   600000   // ms between reports
+#define HEAP_JSON_SIZE         384      // a report is about 300 bytes
+
+/*
+  * one reading of the heap and stack
+  * freeHeap - total free bytes
+  * maxFreeBlock - largest single allocation that would succeed
+  * fragmentation - percent, 0 is one free block, approaches 100 as free space splinters
+  * stackFree - bytes of the loop stack never touched since boot, the high-water mark
+  */
+struct HEAP_SAMPLE {
+    uint32_t freeHeap;
+    uint32_t maxFreeBlock;
+    uint8_t fragmentation;
+    uint32_t stackFree;
+};
+
+// reads the platform, ESP8266 core on the device, a settable mock on the host build
+void readHeapSample(HEAP_SAMPLE &sample);
+
+/*
+  * samples the heap once a second and keeps the worst values and a loop period histogram
+  * between reports, so slow leaks and fragmentation show up long before a crash
+  *
+  *   if (heapMonitor.loop(micros(), millis())) {
+  *     heapMonitor.toJson(json);
+  *     accessSystem.post("heap", json.c_str());
+  *     heapMonitor.reset(millis());
+  *   }
+  */
+class HeapMonitor
+{
+public:
+    HeapMonitor();
+
+    // call at the top of loop(), returns true when a report is due
+    bool loop(uint32_t nowUs, uint32_t nowMs);
+
+    void sample();
+    void add(const HEAP_SAMPLE &sample);
+
+    // report since the last reset, returns false if json was too small
+    bool toJson(FixedStringBase &json) const;
+    void reset(uint32_t nowMs);
+
+    HEAP_SAMPLE last;
+    HEAP_SAMPLE worst;    // lowest free, block and stack, highest fragmentation
+    uint16_t samples;
+    LoopHistogram loops;
+
+private:
+    uint32_t lastLoopUs;
+    uint32_t lastSampleMs;
+    uint32_t lastReportMs;
+    bool started;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "LoopHistogram.h"
+
+LoopHistogram::LoopHistogram()
+{
+    clear();
+}
+
+void LoopHistogram::add(uint32_t us)
+{
+    uint16_t &b = buckets[bucketFor(us)];
+    if (b < 0xFFFF) b++;
+
+    count++;
+    if (us > max) max = us;
+}
+
+void LoopHistogram::clear()
+{
+    for (uint8_t i = 0; i < LOOP_HISTOGRAM_BUCKETS; i++) {
+        buckets[i] = 0;
+    }
+    count = 0;
+    max = 0;
+}
+
+uint8_t LoopHistogram::bucketFor(uint32_t us)
+{
+    uint32_t ms = us / 1000;
+    uint8_t bucket = 0;
+    while (ms > 0 && bucket < LOOP_HISTOGRAM_BUCKETS - 1) {
+        ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// lower bound of bucket in ms, 0 for bucket 0
+uint32_t LoopHistogram::bucketStartMs(uint8_t bucket)
+{
+    return bucket == 0 ? 0 : (uint32_t)1 << (bucket - 1);
+}
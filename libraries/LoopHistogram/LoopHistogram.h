@@ -0,0 +1,30 @@
+#ifndef LOOP_HISTOGRAM_H
+#define LOOP_HISTOGRAM_H
+
+#include <stdint.h>
+
+// bucket 0 is under 1ms, bucket n is 2^(n-1) to 2^n ms,
+// the last bucket also holds everything longer (4s and up, close to an 8s watchdog)
+#define LOOP_HISTOGRAM_BUCKETS 14
+
+/*
+  * log2 histogram of loop periods, 28 bytes of counts
+  * counts stop at 65535 rather than wrapping, clear() after each report
+  */
+class LoopHistogram
+{
+public:
+    LoopHistogram();
+
+    void add(uint32_t us);
+    void clear();
+
+    static uint8_t bucketFor(uint32_t us);
+    static uint32_t bucketStartMs(uint8_t bucket);
+
+    uint16_t buckets[LOOP_HISTOGRAM_BUCKETS];
+    uint32_t count;   // periods added since clear, not saturated
+    uint32_t max;     // longest period since clear, microseconds
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "MachineSession.h"
+
+MachineSession::MachineSession(const SESSION_STATE_INFO *table, TransitionFunction fn) :
+    table(table),
+    transitionFunction(fn)
+{ }
+
+void MachineSession::handle(uint8_t event, uint32_t now)
+{
+    uint8_t to = table[current].next[event];
+    if (to != current) {
+        enter(to, now);
+    }
+}
+
+void MachineSession::loop(uint32_t now)
+{
+    // Timed states are entered at the exact time the previous one expired,
+    // so a late call catches up without the session drifting.
+    uint32_t timeout = table[current].timeout;
+    while (timeout != SESSION_NO_TIMEOUT && now - enteredAt >= timeout) {
+        enter(table[current].next[SESSION_TIMEOUT], enteredAt + timeout);
+        timeout = table[current].timeout;
+    }
+}
+
+uint8_t MachineSession::state()
+{
+    return current;
+}
+
+uint32_t MachineSession::timeInState(uint32_t now)
+{
+    return now - enteredAt;
+}
+
+uint32_t MachineSession::timeRemaining(uint32_t now)
+{
+    uint32_t timeout = table[current].timeout;
+    if (timeout == SESSION_NO_TIMEOUT) {
+        return SESSION_NO_TIMEOUT;
+    }
+    uint32_t elapsed = now - enteredAt;
+    return elapsed >= timeout ? 0 : timeout - elapsed;
+}
+
+void MachineSession::enter(uint8_t to, uint32_t at)
+{
+    uint8_t from = current;
+    current = to;
+    enteredAt = at;
+    if (transitionFunction != NULL) {
+        transitionFunction(from, to);
+    }
+}
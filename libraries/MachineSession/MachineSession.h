@@ -0,0 +1,67 @@
+#ifndef MACHINE_SESSION_H
+#define MACHINE_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// timeout value for states that only change on an event, the largest session time
+#define SESSION_NO_TIMEOUT ((uint32_t)0xFFFFFFFF)
+
+// session states
+#define SESSION_IDLE            0  // machine off, waiting for a token
+#define SESSION_AUTHORISING     1  // token presented, checking permission
+#define SESSION_ACTIVE          2  // machine on
+#define SESSION_PREWARN1        3  // machine on, time nearly up
+#define SESSION_PREWARN2        4
+#define SESSION_PREWARN3        5
+#define SESSION_POWERING_DOWN   6  // turning the machine off
+#define SESSION_STATE_COUNT     7
+
+// session events
+#define SESSION_CARD            0  // token presented
+#define SESSION_GRANTED         1  // token has access
+#define SESSION_DENIED          2  // token refused or unknown
+#define SESSION_BUTTON          3  // power down button pressed
+#define SESSION_TIMEOUT         4  // time in state is up
+#define SESSION_EVENT_COUNT     5
+
+/*
+  * one row of the session table, indexed by state
+  * timeout - ms in this state before SESSION_TIMEOUT fires, or SESSION_NO_TIMEOUT
+  * next - state to move to for each event, same state to ignore the event
+  *
+  * a state with a timeout of 0 must not time out to itself
+  */
+struct SESSION_STATE_INFO {
+    uint32_t timeout;
+    uint8_t next[SESSION_EVENT_COUNT];
+};
+
+/*
+  * Table driven state machine for a machine controller session.
+  * Time is passed in rather than read from millis() so the session
+  * can be driven through virtual time off-device. It is 32 bits on every
+  * target, as millis() is on the AVR and ESP8266, so it rolls over the same way.
+  */
+class MachineSession
+{
+public:
+    typedef void(*TransitionFunction) (uint8_t from, uint8_t to);
+
+    MachineSession(const SESSION_STATE_INFO *table, TransitionFunction fn);
+    void handle(uint8_t event, uint32_t now);
+    void loop(uint32_t now);           // fire any timed transition that is due
+    uint8_t state();
+    uint32_t timeInState(uint32_t now);
+    uint32_t timeRemaining(uint32_t now);  // until the next timed transition
+
+private:
+    const SESSION_STATE_INFO *table;
+    TransitionFunction transitionFunction;
+    uint8_t current = SESSION_IDLE;
+    uint32_t enteredAt = 0;            // time the current state was entered
+
+    void enter(uint8_t to, uint32_t at);
+};
+
+#endif
@@ -31,7 +31,8 @@ void PN532::begin()
 
 /**************************************************************************/
 /*!
-    @brief  Prints a hexadecimal value in plain characters
+    @brief  Prints a hexadecimal value in plain characters, nothing on
+            Arduino with PN532_NO_SERIAL, for sketches without Serial
 
     @param  data      Pointer to the uint8_t data
     @param  numBytes  Data length in bytes
@@ -39,7 +40,7 @@ void PN532::begin()
 /**************************************************************************/
 void PN532::PrintHex(const uint8_t *data, const uint32_t numBytes)
 {
-#ifdef ARDUINO
+#if defined(ARDUINO) && !defined(PN532_NO_SERIAL)
     for (uint8_t i = 0; i < numBytes; i++) {
         if (data[i] < 0x10) {
             Serial.print(" 0");
@@ -49,7 +50,7 @@ void PN532::PrintHex(const uint8_t *data, const uint32_t numBytes)
         Serial.print(data[i], HEX);
     }
     Serial.println("");
-#else
+#elif !defined(ARDUINO)
     for (uint8_t i = 0; i < numBytes; i++) {
         printf(" %2X", data[i]);
     }
@@ -70,7 +71,7 @@ void PN532::PrintHex(const uint8_t *data, const uint32_t numBytes)
 /**************************************************************************/
 void PN532::PrintHexChar(const uint8_t *data, const uint32_t numBytes)
 {
-#ifdef ARDUINO
+#if defined(ARDUINO) && !defined(PN532_NO_SERIAL)
     for (uint8_t i = 0; i < numBytes; i++) {
         if (data[i] < 0x10) {
             Serial.print(" 0");
@@ -89,7 +90,7 @@ void PN532::PrintHexChar(const uint8_t *data, const uint32_t numBytes)
         }
     }
     Serial.println("");
-#else
+#elif !defined(ARDUINO)
     for (uint8_t i = 0; i < numBytes; i++) {
         printf(" %2X", data[i]);
     }
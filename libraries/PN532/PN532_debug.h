@@ -5,7 +5,7 @@
 
 #include "Arduino.h"
 
-#ifdef DEBUG
+#if defined(DEBUG) && !defined(PN532_NO_SERIAL)
 #define DMSG(args...)       Serial.print(args)
 #define DMSG_STR(str)       Serial.println(str)
 #define DMSG_HEX(num)       Serial.print(' '); Serial.print(num, HEX)
@@ -0,0 +1,58 @@
+#include "PatternPlayer.h"
+
+PatternPlayer::PatternPlayer(OutputFunction fn) :
+    outputFunction(fn)
+{ }
+
+void PatternPlayer::play(const PATTERN_STEP *steps, uint8_t count, bool repeat)
+{
+    if (count == 0) {
+        stop();
+        return;
+    }
+
+    this->steps = steps;
+    this->count = count;
+    this->repeat = repeat;
+    pos = 0;
+    stepStart = millis();
+    outputFunction(steps[0].outputs);
+}
+
+void PatternPlayer::stop()
+{
+    steps = NULL;
+    outputFunction(idleOutputs);
+}
+
+void PatternPlayer::setIdle(uint8_t outputs)
+{
+    idleOutputs = outputs;
+    if (steps == NULL) {
+        outputFunction(idleOutputs);
+    }
+}
+
+bool PatternPlayer::isPlaying()
+{
+    return steps != NULL;
+}
+
+void PatternPlayer::loop()
+{
+    if (steps == NULL || millis() - stepStart < steps[pos].duration) {
+        return;
+    }
+
+    pos++;
+    if (pos == count) {
+        if (!repeat) {
+            stop();
+            return;
+        }
+        pos = 0;
+    }
+
+    stepStart = millis();
+    outputFunction(steps[pos].outputs);
+}
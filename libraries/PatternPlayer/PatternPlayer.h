@@ -0,0 +1,52 @@
+#ifndef PATTERN_PLAYER_H
+#define PATTERN_PLAYER_H
+
+#include <Arduino.h>
+
+// output bits for PATTERN_STEP
+#define PATTERN_OFF     0x00
+#define PATTERN_BUZZER  0x01
+#define PATTERN_RED     0x02
+#define PATTERN_GREEN   0x04
+
+// number of steps in a pattern table
+#define PATTERN_LENGTH(p) (sizeof(p) / sizeof(PATTERN_STEP))
+
+/*
+  * one segment of a feedback pattern
+  * outputs - bitmask of outputs that are on during the segment
+  * duration - length of the segment in milliseconds
+  */
+struct PATTERN_STEP {
+    uint8_t outputs;
+    uint16_t duration;
+};
+
+/*
+  * Plays a table of PATTERN_STEPs without blocking.
+  * loop() advances the pattern, call it from the main loop or from a timer
+  * so that beeps and flashes don't hold up anything else.
+  */
+class PatternPlayer
+{
+public:
+    typedef void(*OutputFunction) (uint8_t outputs);
+
+    PatternPlayer(OutputFunction fn);
+    void play(const PATTERN_STEP *steps, uint8_t count, bool repeat = false);
+    void stop();
+    void setIdle(uint8_t outputs); // outputs to show when no pattern is playing
+    bool isPlaying();
+    void loop();
+
+private:
+    OutputFunction outputFunction;
+    const PATTERN_STEP *steps = NULL; // pattern being played, NULL if idle
+    uint8_t count = 0;                // number of steps in pattern
+    uint8_t pos = 0;                  // current step
+    bool repeat = false;              // start again once the last step finishes
+    uint8_t idleOutputs = PATTERN_OFF;
+    unsigned long stepStart = 0;      // millis when the current step started
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "PixelRing.h"
+
+#ifdef PIXELRING_UART
+// UART1 at 4x the pixel bit rate, 6N1 with the TX line inverted.
+// Each 6 bit UART character (plus start and stop bits) carries two pixel
+// bits, so the hardware generates the 0.4/0.8us pulses.
+#define PIXELRING_UART_BAUD 3200000
+static const uint8_t uartBitPairs[4] = { 0b110111, 0b000111, 0b110100, 0b000100 };
+#endif
+
+PixelRing::PixelRing(uint16_t n, uint8_t p, neoPixelType t) :
+    Adafruit_NeoPixel(n, p, t)
+{ }
+
+void PixelRing::begin()
+{
+#ifdef PIXELRING_UART
+    Serial1.begin(PIXELRING_UART_BAUD, SERIAL_6N1, SERIAL_TX_ONLY);
+    CLEAR_PERI_REG_MASK(UART_CONF0(UART1), UART_INV_MASK);
+    SET_PERI_REG_MASK(UART_CONF0(UART1), BIT(UCTXI));
+#else
+    Adafruit_NeoPixel::begin();
+#endif
+    changed = true;
+}
+
+void PixelRing::show()
+{
+    if (!changed) {
+        framesSkipped++;
+        return;
+    }
+
+    if (!held && millis() - lastFrame >= frameInterval) {
+        output();
+    }
+}
+
+void PixelRing::showNow()
+{
+    output();
+}
+
+void PixelRing::loop()
+{
+    if (changed && !held && millis() - lastFrame >= frameInterval) {
+        output();
+    }
+}
+
+void PixelRing::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint32_t old = getPixelColor(n);
+    Adafruit_NeoPixel::setPixelColor(n, r, g, b);
+    if (getPixelColor(n) != old) {
+        changed = true;
+    }
+}
+
+void PixelRing::setPixelColor(uint16_t n, uint32_t c)
+{
+    uint32_t old = getPixelColor(n);
+    Adafruit_NeoPixel::setPixelColor(n, c);
+    if (getPixelColor(n) != old) {
+        changed = true;
+    }
+}
+
+void PixelRing::setBrightness(uint8_t b)
+{
+    if (b != getBrightness()) {
+        Adafruit_NeoPixel::setBrightness(b);
+        changed = true;
+    }
+}
+
+void PixelRing::setFrameInterval(uint16_t ms)
+{
+    frameInterval = ms;
+}
+
+void PixelRing::setHold(bool hold)
+{
+    if (hold && !held && changed) {
+        output();
+    }
+    held = hold;
+}
+
+bool PixelRing::isChanged()
+{
+    return changed;
+}
+
+void PixelRing::output()
+{
+#ifdef PIXELRING_UART
+    uartShow();
+#else
+    Adafruit_NeoPixel::show();
+#endif
+    changed = false;
+    lastFrame = millis();
+    framesShown++;
+}
+
+#ifdef PIXELRING_UART
+// Feed the pixel data into the UART1 FIFO, interrupts stay enabled and the
+// hardware does all of the bit timing
+void PixelRing::uartShow()
+{
+    const uint8_t *p = getPixels();
+    const uint8_t *end = p + numPixels() * 3;
+
+    // wait for the previous frame to drain, then hold the line low for the latch
+    while (((USS(UART1) >> USTXC) & 0xff) != 0) yield();
+    delayMicroseconds(50);
+
+    for (; p < end; p++) {
+        // 4 characters per pixel byte, wait for room in the 128 byte FIFO
+        while (((USS(UART1) >> USTXC) & 0xff) > 124) ;
+        uint8_t v = *p;
+        USF(UART1) = uartBitPairs[(v >> 6) & 3];
+        USF(UART1) = uartBitPairs[(v >> 4) & 3];
+        USF(UART1) = uartBitPairs[(v >> 2) & 3];
+        USF(UART1) = uartBitPairs[v & 3];
+    }
+}
+#endif
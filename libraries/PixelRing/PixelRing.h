@@ -0,0 +1,63 @@
+#ifndef PIXEL_RING_H
+#define PIXEL_RING_H
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+
+// minimum time between frames sent to the pixels (ms), 50 fps
+#ifndef PIXELRING_FRAME_INTERVAL
+#define PIXELRING_FRAME_INTERVAL 20
+#endif
+
+/*
+  * ESP8266 only: define PIXELRING_UART (here or as a build flag) to drive the
+  * pixels from the UART1 hardware instead of bit-banging with interrupts disabled.
+  * UART1 TX is fixed to GPIO2 (D4 on a NodeMCU), so the data line must be
+  * wired there. 800 KHz RGB pixels only.
+  */
+//#define PIXELRING_UART
+#if defined(PIXELRING_UART) && !defined(ESP8266)
+#error PIXELRING_UART is only supported on ESP8266
+#endif
+
+/*
+  * Adafruit_NeoPixel that only sends a frame when the pixel buffer has changed,
+  * and no more often than PIXELRING_FRAME_INTERVAL.
+  * A frame that is held back by the rate limit goes out from loop().
+  *
+  * Sending a frame disables interrupts (about 30us per pixel), long enough to
+  * overrun a UART receiving at 115200 or faster. setHold(true) sends any pending
+  * frame straight away and then holds new frames until setHold(false).
+  */
+class PixelRing : public Adafruit_NeoPixel
+{
+public:
+    PixelRing(uint16_t n, uint8_t p=6, neoPixelType t=NEO_GRB + NEO_KHZ800);
+
+    void begin();
+    void show();        // send the frame if it has changed and the rate limit allows
+    void showNow();     // send the frame now, changed or not
+    void loop();        // send any frame held back by the rate limit
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+    void setPixelColor(uint16_t n, uint32_t c);
+    void setBrightness(uint8_t b);
+    void setFrameInterval(uint16_t ms);
+    void setHold(bool hold);    // hold back frames, e.g. while a serial reply is due
+    bool isChanged();
+
+    uint32_t framesShown = 0;   // frames actually sent to the pixels
+    uint32_t framesSkipped = 0; // show() calls with nothing to send
+
+private:
+    bool changed = true;        // pixel buffer differs from what was last sent
+    bool held = false;
+    unsigned long lastFrame = 0;
+    uint16_t frameInterval = PIXELRING_FRAME_INTERVAL;
+
+    void output();
+#ifdef PIXELRING_UART
+    void uartShow();
+#endif
+};
+
+#endif
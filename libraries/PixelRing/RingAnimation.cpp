@@ -0,0 +1,144 @@
+#include "RingAnimation.h"
+
+// gamma 2.2 correction, so brightness steps look even
+static const uint8_t PROGMEM gammaTable[256] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,
+    1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,   3,
+    4,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,   6,   7,   7,   7,
+    8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,  12,  13,  13,  13,
+   14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,  20,  20,  21,  22,
+   22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,  30,  30,  31,  32,
+   33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,  42,  43,  43,  44,
+   45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,
+   60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,  73,  74,  75,  76,
+   77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,  91,  93,  94,  95,
+   97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111, 113, 114, 116, 117,
+  119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135, 137, 138, 140, 141,
+  143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161, 163, 165, 166, 168,
+  170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190, 192, 194, 196, 197,
+  199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221, 223, 225, 227, 229
+};
+
+RingAnimation::RingAnimation(PixelRing &ring) :
+    ring(ring)
+{
+    colour[0] = colour[1] = colour[2] = 0;
+}
+
+void RingAnimation::play(const RING_ANIMATION *animation, uint32_t colour)
+{
+    memcpy_P(&this->animation, animation, sizeof(RING_ANIMATION));
+    playing = animation;
+
+    duration = this->animation.frameTime *
+        (this->animation.flags & RING_INTERPOLATE ? this->animation.count - 1 : this->animation.count);
+    finished = false;
+    redraw = true;
+    startTime = millis();
+    setColour(colour);
+}
+
+void RingAnimation::setColour(uint32_t c)
+{
+    uint8_t r = (c >> 16) & 0xff, g = (c >> 8) & 0xff, b = c & 0xff;
+    if (r != colour[0] || g != colour[1] || b != colour[2]) {
+        colour[0] = r;
+        colour[1] = g;
+        colour[2] = b;
+        redraw = true;
+    }
+}
+
+void RingAnimation::setBrightness(uint8_t b)
+{
+    if (b != brightness) {
+        brightness = b;
+        redraw = true;
+    }
+}
+
+bool RingAnimation::isPlaying()
+{
+    return playing != NULL && !finished;
+}
+
+const RING_ANIMATION *RingAnimation::current()
+{
+    return playing;
+}
+
+void RingAnimation::loop()
+{
+    if (playing == NULL || (finished && !redraw)) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (!redraw && now - lastDraw < RING_REDRAW_INTERVAL) {
+        return;
+    }
+
+    lastDraw = now;
+    redraw = false;
+    draw(now - startTime);
+    ring.show();
+}
+
+// draw the animation at elapsed ms from the start
+void RingAnimation::draw(unsigned long elapsed)
+{
+    RING_KEYFRAME k, next;
+
+    if (duration == 0 || elapsed >= duration) {
+        if (animation.flags & RING_LOOP && duration > 0) {
+            elapsed %= duration;
+        } else {
+            // hold the last keyframe
+            finished = true;
+            memcpy_P(&k, &animation.keyframes[animation.count - 1], sizeof(k));
+            drawKeyframe(k);
+            return;
+        }
+    }
+
+    uint8_t i = elapsed / animation.frameTime;
+    memcpy_P(&k, &animation.keyframes[i], sizeof(k));
+
+    if (animation.flags & RING_INTERPOLATE) {
+        // blend towards the next keyframe, pos is 0-255 through this one,
+        // in 32 bits as a 255 step times pos overflows an AVR int
+        memcpy_P(&next, &animation.keyframes[i + 1], sizeof(next));
+        int16_t pos = ((elapsed - i * animation.frameTime) << 8) / animation.frameTime;
+        k.start += ((int32_t)(next.start - k.start) * pos) >> 8;
+        k.length += ((int32_t)(next.length - k.length) * pos) >> 8;
+        k.head += ((int32_t)(next.head - k.head) * pos) >> 8;
+        k.tail += ((int32_t)(next.tail - k.tail) * pos) >> 8;
+    }
+
+    drawKeyframe(k);
+}
+
+void RingAnimation::drawKeyframe(const RING_KEYFRAME &k)
+{
+    uint16_t n = ring.numPixels();
+    uint8_t length = k.length > n ? n : k.length;
+
+    // brightness along the arc in 8.8 fixed point, one divide per frame
+    int32_t level = (int32_t)k.head << 8;
+    int32_t step = length > 1 ? ((int32_t)(k.tail - k.head) << 8) / (length - 1) : 0;
+
+    int16_t pix = k.start % (int16_t)n;
+    if (pix < 0) pix += n;
+
+    for (uint16_t i = 0; i < n; i++) {
+        if (i < length) {
+            uint8_t v = pgm_read_byte(&gammaTable[((uint16_t)(level >> 8) * (brightness + 1)) >> 8]);
+            ring.setPixelColor(pix, (colour[0] * (v + 1)) >> 8, (colour[1] * (v + 1)) >> 8, (colour[2] * (v + 1)) >> 8);
+            level += step;
+        } else {
+            ring.setPixelColor(pix, 0);
+        }
+        pix = pix == 0 ? n - 1 : pix - 1;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef RING_ANIMATION_H
+#define RING_ANIMATION_H
+
+#include <Arduino.h>
+#include "PixelRing.h"
+
+// time between redraws of a playing animation (ms)
+#ifndef RING_REDRAW_INTERVAL
+#define RING_REDRAW_INTERVAL 40
+#endif
+
+// flags for RING_ANIMATION
+#define RING_LOOP         0x01  // start again after the last keyframe
+#define RING_INTERPOLATE  0x02  // blend between keyframes, otherwise step
+
+/*
+  * keyframe - an arc of lit pixels
+  * start - pixel at the head of the arc, the arc runs anti-clockwise from here, wraps around the ring
+  * length - number of lit pixels
+  * head, tail - brightness at each end of the arc, 0-255 before gamma correction
+  */
+struct RING_KEYFRAME {
+    int16_t start;
+    uint8_t length;
+    uint8_t head;
+    uint8_t tail;
+};
+
+/*
+  * animation - a PROGMEM table of keyframes
+  * frameTime - ms per keyframe
+  * an interpolated animation runs for (count - 1) x frameTime, ending on the last keyframe,
+  * otherwise each keyframe is shown for frameTime
+  */
+struct RING_ANIMATION {
+    const RING_KEYFRAME *keyframes;
+    uint8_t count;
+    uint8_t flags;
+    uint32_t frameTime;
+};
+
+/*
+  * Plays RING_ANIMATIONs on a PixelRing.
+  * loop() only redraws every RING_REDRAW_INTERVAL, in between it costs a millis() compare.
+  */
+class RingAnimation
+{
+public:
+    RingAnimation(PixelRing &ring);
+
+    void play(const RING_ANIMATION *animation, uint32_t colour);  // animation in PROGMEM
+    void setColour(uint32_t colour);
+    void setBrightness(uint8_t brightness);
+    bool isPlaying(); // false once a non-looping animation has finished
+    const RING_ANIMATION *current();
+    void loop();
+
+private:
+    PixelRing &ring;
+    const RING_ANIMATION *playing = NULL; // PROGMEM address of the animation
+    RING_ANIMATION animation;             // RAM copy of it
+    uint32_t duration = 0;
+    uint8_t colour[3];                    // r, g, b
+    uint8_t brightness = 255;
+    bool finished = true;
+    bool redraw = false;                  // force a redraw, e.g. colour changed
+    unsigned long startTime = 0;
+    unsigned long lastDraw = 0;
+
+    void draw(unsigned long elapsed);
+    void drawKeyframe(const RING_KEYFRAME &k);
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "RingUart.h"
+
+// without it the core's HardwareSerial keeps USART0, see RingUart.h
+#ifdef RINGUART_USART0
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define RX_MASK (RINGUART_RX_SIZE - 1)
+#define TX_MASK (RINGUART_TX_SIZE - 1)
+
+RingUart Uart;
+
+ISR(USART_RX_vect)
+{
+    Uart.rxInterrupt();
+}
+
+ISR(USART_UDRE_vect)
+{
+    Uart.txInterrupt();
+}
+
+void RingUart::rxInterrupt()
+{
+    // read status before data, reading UDR0 clears it
+    bool error = UCSR0A & (_BV(DOR0) | _BV(FE0));
+    uint8_t b = UDR0;
+
+    if (error) {
+        rxErrors++;
+        return;
+    }
+
+    uint8_t next = (rxHead + 1) & RX_MASK;
+    if (next == rxTail) {
+        rxOverruns++;
+        return;
+    }
+    rxBuffer[rxHead] = b;
+    rxHead = next;
+}
+
+void RingUart::txInterrupt()
+{
+    if (txHead == txTail) {
+        // empty, stop the interrupt
+        UCSR0B &= ~_BV(UDRIE0);
+        return;
+    }
+    UDR0 = txBuffer[txTail];
+    txTail = (txTail + 1) & TX_MASK;
+}
+
+void RingUart::begin(unsigned long baud)
+{
+    // double speed mode, as HardwareSerial
+    uint16_t ubrr = (F_CPU / 4 / baud - 1) / 2;
+
+    UCSR0A = _BV(U2X0);
+    UBRR0H = ubrr >> 8;
+    UBRR0L = ubrr;
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);  // 8N1
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+}
+
+int RingUart::available()
+{
+    return (RINGUART_RX_SIZE + rxHead - rxTail) & RX_MASK;
+}
+
+int RingUart::peek()
+{
+    if (rxHead == rxTail) return -1;
+    return rxBuffer[rxTail];
+}
+
+int RingUart::read()
+{
+    if (rxHead == rxTail) return -1;
+    uint8_t b = rxBuffer[rxTail];
+    rxTail = (rxTail + 1) & RX_MASK;
+    return b;
+}
+
+int RingUart::availableForWrite()
+{
+    return (RINGUART_TX_SIZE - 1) - ((RINGUART_TX_SIZE + txHead - txTail) & TX_MASK);
+}
+
+void RingUart::flush()
+{
+    while (txHead != txTail) { }
+    while (!(UCSR0A & _BV(UDRE0))) { }
+}
+
+size_t RingUart::write(uint8_t b)
+{
+    uint8_t next = (txHead + 1) & TX_MASK;
+
+    // buffer full, wait for the ISR to make room
+    while (next == txTail) {
+        if (!(SREG & _BV(SREG_I)) && (UCSR0A & _BV(UDRE0))) {
+            // interrupts are off, so send by hand
+            txInterrupt();
+        }
+    }
+
+    txBuffer[txHead] = b;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        txHead = next;
+        UCSR0B |= _BV(UDRIE0);
+    }
+    return 1;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef RING_UART_H
+#define RING_UART_H
+
+#include <Arduino.h>
+
+#ifndef __AVR_ATmega328P__
+#error RingUart drives the ATmega328P USART0 only
+#endif
+
+/*
+  * Interrupt driven USART0 (D0/D1) with fixed size ring buffers, in place of
+  * HardwareSerial. Owns the USART0 interrupt vectors, so the sketch must not
+  * use Serial at all, or the link fails with duplicate vectors. That includes
+  * the libraries it links, build PN532 with PN532_NO_SERIAL.
+  *
+  * Only compiled with RINGUART_USART0 defined as a build flag, otherwise Uart
+  * doesn't exist and a sketch that includes this still builds with Serial.
+  *
+  * sizes must be powers of 2, up to 256
+  */
+#ifndef RINGUART_RX_SIZE
+#define RINGUART_RX_SIZE 128
+#endif
+#ifndef RINGUART_TX_SIZE
+#define RINGUART_TX_SIZE 64
+#endif
+
+class RingUart : public Stream
+{
+public:
+    void begin(unsigned long baud);
+
+    int available();
+    int peek();
+    int read();
+    int availableForWrite();
+    void flush();           // wait for the TX buffer to empty
+    size_t write(uint8_t b);
+    using Print::write;
+
+    volatile uint16_t rxOverruns = 0;   // bytes dropped, RX buffer full
+    volatile uint16_t rxErrors = 0;     // hardware overrun or framing error
+
+    // called from the ISRs
+    void rxInterrupt();
+    void txInterrupt();
+
+private:
+    uint8_t rxBuffer[RINGUART_RX_SIZE];
+    uint8_t txBuffer[RINGUART_TX_SIZE];
+    volatile uint8_t rxHead = 0;
+    volatile uint8_t rxTail = 0;
+    volatile uint8_t txHead = 0;
+    volatile uint8_t txTail = 0;
+};
+
+extern RingUart Uart;
+
+#endif
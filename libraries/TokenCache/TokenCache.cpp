@@ -7,14 +7,41 @@ TokenCache::TokenCache(AccessSystem accessSystem)
 
 void TokenCache::loop()
 {
-  if (millis() - lastSyncTime > 600000) {
+  unsigned long now = millis();
+
+  if (now - lastBudgetTime >= 60000) {
+    syncBudget = TOKEN_CACHE_SYNC_PER_MINUTE;
+    lastBudgetTime = now;
+    if (syncPending) {
+      refreshDue();
+    }
+  }
+
+  if (now - lastSyncTime > syncDelay) {
     // call sync every 10 mins, note that each token has a sync time that counts down
     // so in reality tokens are synced much less than every 10 mins
     sync();
-    lastSyncTime = millis();
+    lastSyncTime = now;
+    syncDelay = TOKEN_CACHE_SYNC_INTERVAL;
   }
 }
 
+unsigned long TokenCache::syncJitter()
+{
+#if defined(ESP8266)
+  uint32_t h = ESP.getChipId();
+#else
+  uint32_t h = 0;
+#endif
+  // chip IDs from one batch are close together, mix the bits before taking the range
+  h ^= h >> 16;
+  h *= 0x7feb352dUL;
+  h ^= h >> 15;
+  h *= 0x846ca68bUL;
+  h ^= h >> 16;
+  return h % TOKEN_CACHE_SYNC_INTERVAL;
+}
+
 void TokenCache::printHex(const uint8_t *data, const uint8_t numBytes)
 {
   const char *hex = "0123456789abcdef";
@@ -25,7 +52,7 @@ void TokenCache::printHex(const uint8_t *data, const uint8_t numBytes)
 }
 
 // Get cache item, or query server if not in cache
-TOKEN_CACHE_ITEM *TokenCache::fetch(TOKEN *uid, uint8_t uidLength, String tokenStr)
+TOKEN_CACHE_ITEM *TokenCache::fetch(TOKEN *uid, uint8_t uidLength)
 {
   TOKEN_CACHE_ITEM *item = NULL;
 
@@ -48,6 +75,7 @@ TOKEN_CACHE_ITEM *TokenCache::fetch(TOKEN *uid, uint8_t uidLength, String tokenS
   // not found so far, query server and add to cache if has permission
   if (item == NULL) {
     Serial.println(F(" :not found in cache"));
+    formatToken(tokenStr, *uid, uidLength);
     uint8_t flags = accessSystem.getAccess(tokenStr);
 
     if ((flags > 0) && (flags != TOKEN_ERROR)) {
@@ -92,9 +120,9 @@ TOKEN_CACHE_ITEM *TokenCache::add(TOKEN *token, uint8_t length, uint8_t flags)
 
   // else, find item with least scans
   if (cacheSize == TOKEN_CACHE_SIZE) {
-    cacheSize = 0; // start at the beginning
+    pos = 0; // start at the beginning
 
-    for (i = 0; i < cacheSize; i++) {
+    for (i = 1; i < cacheSize; i++) {
       if (cache[i].count < cache[pos].count) {
         pos = i;
       }
@@ -133,7 +161,7 @@ void TokenCache::remove(TOKEN_CACHE_ITEM *item)
   item->sync = TOKEN_CACHE_SYNC;
 }
 
-void TokenCache::init()
+void TokenCache::init(bool verbose)
 {
   Serial.println(F("Loading cache from EEPROM..."));
 
@@ -150,26 +178,36 @@ void TokenCache::init()
 
   } else {
     cacheSize = EEPROM.read(1);
+    if (cacheSize > TOKEN_CACHE_SIZE) cacheSize = 0;
     Serial.print(cacheSize);
     Serial.println(F(" items"));
   }
 
-  // read token items from cache
-  uint8_t i = 0, j = 0;
-  uint16_t addr = 2;
-  for (i = 0; i < cacheSize; i++) {
-    // token
-    for (j = 0; j < 7; j++) {
-      cache[i].token[j] = EEPROM.read(addr + j);
-    }
+  // read all the token items in one go
+  TOKEN_EEPROM_ITEM stored[TOKEN_CACHE_SIZE];
+  EEPROM.get(2, stored);
 
-    // length
-    cache[i].length = EEPROM.read(addr + 7);
+  for (uint8_t i = 0; i < cacheSize; i++) {
+    memcpy(cache[i].token, stored[i].token, sizeof(TOKEN));
+    cache[i].length = stored[i].length;
+    cache[i].flags = stored[i].flags;
+    cache[i].count = 0;
+    // spread the resyncs evenly over the sync window, not all in the first few cycles
+    cache[i].sync = 1 + (uint16_t)i * TOKEN_CACHE_SYNC / cacheSize;
+  }
 
-    // flags
-    cache[i].flags = EEPROM.read(addr + 8);
+  syncDelay = TOKEN_CACHE_SYNC_INTERVAL + syncJitter();
+
+  if (verbose) {
+    dump();
+  }
+}
 
-    updateTokenStr(cache[i].token, cache[i].length);
+// print every cached token
+void TokenCache::dump()
+{
+  for (uint8_t i = 0; i < cacheSize; i++) {
+    formatToken(tokenStr, cache[i].token, cache[i].length);
 
     Serial.print(' ');
     Serial.print(tokenStr);
@@ -179,11 +217,6 @@ void TokenCache::init()
     Serial.print(cache[i].count);
     Serial.print(':');
     Serial.println(cache[i].sync);
-
-    cache[i].count = 0;
-    cache[i].sync = 1 + i; // resync everything soon-ish
-
-    addr += 9;
   }
 }
 
@@ -191,37 +224,56 @@ void TokenCache::init()
 // called every 10min ish
 void TokenCache::sync()
 {
-  // for each item in cache
   Serial.println(F("Syncing cached tokens..."));
+
+  // dec sync counters, tokens that reach zero are due
+  for (uint8_t i = 0; i < cacheSize; i++) {
+    if (cache[i].sync > 0) {
+      cache[i].sync--;
+    }
+  }
+
+  refreshDue();
+}
+
+void TokenCache::refreshDue()
+{
+  syncPending = false;
+
   uint8_t i;
   for (i = 0; i < cacheSize; i++) {
-    // dec sync counter
-    cache[i].sync--;
+    if (cache[i].sync != 0 || cache[i].length == 0) {
+      continue;
+    }
 
-    // if reached zero
-    if (cache[i].sync == 0 && cache[i].length > 0) {
-      updateTokenStr(cache[i].token, cache[i].length);
-      Serial.print(F("Syncing cached flags for: "));
-      Serial.println(tokenStr);
+    // leave the rest for the next minute
+    if (syncBudget == 0) {
+      syncPending = true;
+      break;
+    }
+    syncBudget--;
 
-      // query permission flags from server
-      uint8_t flags = accessSystem.getAccess(tokenStr);
+    formatToken(tokenStr, cache[i].token, cache[i].length);
+    Serial.print(F("Syncing cached flags for: "));
+    Serial.println(tokenStr);
 
-      if (flags != TOKEN_ERROR) {
-        if (flags > 0) {
-          // if successful, update flags and reset sync counter
-          cache[i].flags = flags;
-          cache[i].sync = TOKEN_CACHE_SYNC;
+    // query permission flags from server
+    uint8_t flags = accessSystem.getAccess(tokenStr);
 
-        } else {
-          // else remove token
-          remove(&cache[i]);
-        }
+    if (flags != TOKEN_ERROR) {
+      if (flags > 0) {
+        // if successful, update flags and reset sync counter
+        cache[i].flags = flags;
+        cache[i].sync = TOKEN_CACHE_SYNC;
 
       } else {
-        // else try again next cycle
-        cache[i].sync = 1;
+        // else remove token
+        remove(&cache[i]);
       }
+
+    } else {
+      // else try again next cycle
+      cache[i].sync = 1;
     }
 
     yield();
@@ -230,7 +282,7 @@ void TokenCache::sync()
   // sync changes to EEPROM
   syncEEPROM();
 
-  Serial.println(F("Cache sync complete"));
+  Serial.println(syncPending ? F("Cache sync continues next minute") : F("Cache sync complete"));
 }
 
 // update EEPROM to match cache
@@ -3,10 +3,13 @@
 
 #include <Arduino.h>
 #include <AccessSystem.h>
+#include <FixedString.h>
 #include <EEPROM.h>
 
 #define TOKEN_CACHE_SIZE 32
 #define TOKEN_CACHE_SYNC 144 // resync cache after <value> x 10 minutes
+#define TOKEN_CACHE_SYNC_INTERVAL 600000  // ms between sync countdowns
+#define TOKEN_CACHE_SYNC_PER_MINUTE 4     // most resync verify calls in a minute, the rest wait
 #define EEPROM_MAGIC 3       // update to clear EEPROM on restart
 
 // tokens are 4 or 7-byte values, held in a fixed 7-byte array
@@ -27,6 +30,15 @@ struct TOKEN_CACHE_ITEM {
     uint8_t sync;   // countdown to resync with cache with server
 };                  // in memory = 12 bytes, EEPROM size = 9 bytes
 
+/*
+  * cache item as stored in EEPROM, an array of these follows the magic and size bytes
+  */
+struct TOKEN_EEPROM_ITEM {
+    TOKEN token;
+    uint8_t length;
+    uint8_t flags;
+};                  // 9 bytes
+
 class TokenCache
 {
 
@@ -43,27 +55,17 @@ class TokenCache
 
     unsigned long lastSyncTime = 0;
 
-    // token as hex string
-    char tokenStr[14];
-
-    void updateTokenStr(const uint8_t *data, const uint32_t numBytes) {
-        const char *hex = "0123456789abcdef";
-        uint8_t b = 0;
-        for (uint8_t i = 0; i < numBytes; i++) {
-            tokenStr[b] = hex[(data[i] >> 4) & 0xF];
-            b++;
-            tokenStr[b] = hex[(data[i]) & 0xF];
-            b++;
-        }
+    // first sync is a per device jitter past the interval, so a fleet that boots together
+    // doesn't sync together
+    unsigned long syncDelay = TOKEN_CACHE_SYNC_INTERVAL;
 
-        // null remaining bytes in string
-        for (uint8_t i = numBytes; i < 7; i++) {
-            tokenStr[b] = 0;
-            b++;
-            tokenStr[b] = 0;
-            b++;
-        }
-    }
+    // resync verify calls left this minute, tokens over the budget wait for the next one
+    uint8_t syncBudget = TOKEN_CACHE_SYNC_PER_MINUTE;
+    unsigned long lastBudgetTime = 0;
+    bool syncPending = false;
+
+    // token as hex string
+    char tokenStr[TOKEN_STR_SIZE];
 
     // update a byte of EEPROM memory, return true if changed
     bool updateEEPROM(int address, uint8_t value) {
@@ -77,13 +79,20 @@ class TokenCache
     // update EEPROM to match cache
     void syncEEPROM();
 
+    // query the server for tokens whose countdown has run out, within the budget
+    void refreshDue();
+
+    // 0 to TOKEN_CACHE_SYNC_INTERVAL ms, from the chip ID
+    static unsigned long syncJitter();
+
   public:
     TokenCache(AccessSystem accessSystem);
-    TOKEN_CACHE_ITEM *fetch(TOKEN *token, uint8_t length, String tokenStr);
+    TOKEN_CACHE_ITEM *fetch(TOKEN *token, uint8_t length);
     TOKEN_CACHE_ITEM *get(TOKEN *token, uint8_t length);
     TOKEN_CACHE_ITEM *add(TOKEN *token, uint8_t length, uint8_t flags);
     void remove(TOKEN_CACHE_ITEM *item);
-    void init();
+    void init(bool verbose = false);    // verbose prints every cached token
+    void dump();
     void sync();
     void loop();
     void printHex(const uint8_t *data, const uint8_t numbytes);
@@ -0,0 +1,149 @@
+#include "UsageLog.h"
+
+UsageLog::UsageLog(AccessSystem accessSystem)
+  : accessSystem(accessSystem)
+{ }
+
+void UsageLog::init()
+{
+  Serial.println(F("Loading usage journal from EEPROM..."));
+
+  EEPROM.get(USAGE_EEPROM_START, journal);
+  if (journal.magic != USAGE_MAGIC || journal.head >= USAGE_RING_SIZE || journal.count > USAGE_RING_SIZE) {
+    Serial.println(F("Magic changed, resetting usage journal"));
+    journal.magic = USAGE_MAGIC;
+    journal.head = 0;
+    journal.count = 0;
+    journal.spare = 0;
+    journal.boot = 0;
+  }
+
+  EEPROM.get(USAGE_EEPROM_START + sizeof(USAGE_JOURNAL), ring);
+
+  journal.boot++;
+  syncEEPROM();
+
+  Serial.print(journal.count);
+  Serial.print(F(" sessions waiting, boot "));
+  Serial.println(journal.boot);
+
+  oldestWaiting = millis();
+}
+
+// start accounting a session for token
+void UsageLog::begin(TOKEN *token, uint8_t length)
+{
+  if (inSession) {
+    end();
+  }
+
+  memset(&current, 0, sizeof(current));
+  memcpy(current.token, token, length);
+  current.length = length;
+  current.boot = journal.boot;
+  current.start = millis() / 1000;
+
+  sessionStart = millis();
+  inSession = true;
+}
+
+void UsageLog::extend()
+{
+  if (inSession) {
+    current.extensions++;
+  }
+}
+
+// finish the session and add it to the ring, dropping the oldest if full
+void UsageLog::end()
+{
+  if (!inSession) {
+    return;
+  }
+  inSession = false;
+
+  current.end = millis() / 1000;
+  current.activeTime = (millis() - sessionStart) / 1000;
+
+  if (journal.count == 0) {
+    oldestWaiting = millis();
+  }
+
+  if (journal.count == USAGE_RING_SIZE) {
+    Serial.println(F("Usage ring full, dropping oldest session"));
+    journal.head = (journal.head + 1) % USAGE_RING_SIZE;
+    journal.count--;
+  }
+
+  ring[(journal.head + journal.count) % USAGE_RING_SIZE] = current;
+  journal.count++;
+
+  syncEEPROM();
+}
+
+// send all waiting sessions to the access system in one request
+bool UsageLog::upload()
+{
+  if (journal.count == 0) {
+    return true;
+  }
+
+  lastUploadAttempt = millis();
+
+  // static, too big for the stack
+  static FixedString<USAGE_JSON_SIZE> json;
+  json.clear();
+
+  json.append("{\"boot\":").appendUInt(journal.boot);
+  json.append(",\"uptime\":").appendUInt(millis() / 1000);
+  json.append(",\"sessions\":[");
+
+  for (uint8_t i = 0; i < journal.count; i++) {
+    USAGE_RECORD *r = &ring[(journal.head + i) % USAGE_RING_SIZE];
+    if (i > 0) json.append(',');
+    json.append("{\"token\":\"").appendHex(r->token, r->length);
+    json.append("\",\"boot\":").appendUInt(r->boot);
+    json.append(",\"start\":").appendUInt(r->start);
+    json.append(",\"end\":").appendUInt(r->end);
+    json.append(",\"active\":").appendUInt(r->activeTime);
+    json.append(",\"extensions\":").appendUInt(r->extensions);
+    json.append('}');
+    yield();
+  }
+  json.append("]}");
+
+  if (json.overflowed() || !accessSystem.post("usage", json.c_str())) {
+    return false;
+  }
+
+  journal.head = 0;
+  journal.count = 0;
+  syncEEPROM();
+  return true;
+}
+
+void UsageLog::loop()
+{
+  if (journal.count == 0 || millis() - lastUploadAttempt < USAGE_RETRY_INTERVAL) {
+    return;
+  }
+
+  if (journal.count >= USAGE_BATCH_SIZE || millis() - oldestWaiting > USAGE_UPLOAD_INTERVAL) {
+    upload();
+  }
+}
+
+uint8_t UsageLog::waiting()
+{
+  return journal.count;
+}
+
+// update EEPROM to match the ring
+void UsageLog::syncEEPROM()
+{
+  EEPROM.put(USAGE_EEPROM_START, journal);
+  EEPROM.put(USAGE_EEPROM_START + sizeof(USAGE_JOURNAL), ring);
+#if defined(ESP8266)
+  EEPROM.commit();
+#endif
+}
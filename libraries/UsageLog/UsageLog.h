@@ -0,0 +1,79 @@
+#ifndef USAGELOG_H
+#define USAGELOG_H
+
+#include <Arduino.h>
+#include <AccessSystem.h>
+#include <TokenCache.h>
+#include <FixedString.h>
+#include <EEPROM.h>
+
+#define USAGE_RING_SIZE        16       // sessions held until uploaded
+#define USAGE_JSON_SIZE        2048     // upload body, a full ring is about 1800 bytes
+#define USAGE_BATCH_SIZE       8        // upload once this many sessions are waiting
+#define USAGE_UPLOAD_INTERVAL  3600000  // or when the oldest has waited this long (ms)
+#define USAGE_RETRY_INTERVAL   60000    // wait before retrying a failed upload (ms)
+#define USAGE_EEPROM_START     1024     // journal location, after the token cache
+#define USAGE_MAGIC            1        // update to clear the journal on restart
+
+/*
+  * struct for a completed machine session
+  * start, end - seconds since the boot the session started in
+  * activeTime - seconds the machine was powered for
+  * extensions - number of times the token was presented again to extend the session
+  * boot - boot number, increments on each restart
+  * token, length - the member token that started the session
+  */
+struct USAGE_RECORD {
+    uint32_t start;
+    uint32_t end;
+    uint32_t activeTime;
+    uint16_t extensions;
+    uint16_t boot;
+    TOKEN token;
+    uint8_t length;
+};                  // 24 bytes, in memory and EEPROM
+
+/*
+  * journal header, stored in EEPROM ahead of the ring
+  */
+struct USAGE_JOURNAL {
+    uint8_t magic;
+    uint8_t head;    // index of the oldest record in the ring
+    uint8_t count;   // number of records waiting to be uploaded
+    uint8_t spare;
+    uint16_t boot;   // current boot number
+};
+
+class UsageLog
+{
+
+  private:
+    AccessSystem accessSystem;
+
+    // completed sessions waiting to be uploaded, mirrored to the EEPROM journal
+    USAGE_JOURNAL journal;
+    USAGE_RECORD ring[USAGE_RING_SIZE];
+
+    // session in progress
+    bool inSession = false;
+    USAGE_RECORD current;
+    unsigned long sessionStart = 0;
+
+    unsigned long lastUploadAttempt = 0;
+    unsigned long oldestWaiting = 0;    // millis when the oldest waiting record was added
+
+    // write the ring and header to EEPROM
+    void syncEEPROM();
+
+  public:
+    UsageLog(AccessSystem accessSystem);
+    void init();    // call after TokenCache::init, which starts the EEPROM
+    void begin(TOKEN *token, uint8_t length);
+    void extend();
+    void end();
+    bool upload();
+    void loop();    // uploads when a batch is ready, call when the machine is idle
+    uint8_t waiting();
+};
+
+#endif
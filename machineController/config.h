@@ -34,3 +34,9 @@
 // Time at which machine starts a stage 3 timeout alert (continuous beep)
 // Should be > PREWARN2_TIME_MS and < ACTIVE_TIME_MS
 #define PREWARN3_TIME_MS 9000
+
+// Feedback patterns played during each prewarn stage, repeated until the next stage.
+// Each step is {outputs, duration ms}, outputs are PATTERN_BUZZER, PATTERN_RED and PATTERN_GREEN.
+#define PREWARN1_PATTERN { {PATTERN_BUZZER, PREWARN1_BEEP_DURATION}, {PATTERN_GREEN, PREWARN1_BEEP_INTERVAL} }
+#define PREWARN2_PATTERN { {PATTERN_BUZZER, PREWARN2_BEEP_DURATION}, {PATTERN_GREEN, PREWARN2_BEEP_INTERVAL} }
+#define PREWARN3_PATTERN { {PATTERN_BUZZER, 1000} }
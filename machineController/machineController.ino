@@ -73,30 +73,53 @@
 #define PIN_BUTTON A0
 
 // Includes
+#include <PatternPlayer.h>
 #include "config.h"
 #include <ESP8266WiFi.h>
+#include <Ticker.h>
 #include <PingKeepAlive.h>
 #include <AccessSystem.h>
 #include <TokenCache.h>
 #include <CardReader522.h>
+#include <MachineSession.h>
+#include <UsageLog.h>
+#include <HeapMonitor.h>
+#include "sessionTable.h"
+
+// How often the feedback ticker advances the beep/led pattern
+#define FEEDBACK_TICK_MS 5
+
+// Prototypes
+void setFeedbackOutputs(uint8_t outputs);
+void onSessionTransition(uint8_t from, uint8_t to);
 
 // Objects
 PingKeepAlive pka;
 AccessSystem accessSystem(THING_ID);
 TokenCache tokenCache(accessSystem);
+UsageLog usageLog(accessSystem);
+HeapMonitor heapMonitor;
 CardReader522 cardReader;
+PatternPlayer feedback(setFeedbackOutputs);
+MachineSession session(sessionTable, onSessionTransition);
+Ticker feedbackTicker;
+
+// Feedback patterns
+const PATTERN_STEP startupPattern[] = { {PATTERN_BUZZER, 500} };
+const PATTERN_STEP cardPattern[] = { {PATTERN_BUZZER, 50} };
+const PATTERN_STEP deniedPattern[] = { {PATTERN_BUZZER | PATTERN_RED, 2000} };
+const PATTERN_STEP unknownPattern[] = { {PATTERN_BUZZER | PATTERN_RED, 500}, {PATTERN_OFF, 500}, {PATTERN_BUZZER | PATTERN_RED, 1500} };
+const PATTERN_STEP prewarn1Pattern[] = PREWARN1_PATTERN;
+const PATTERN_STEP prewarn2Pattern[] = PREWARN2_PATTERN;
+const PATTERN_STEP prewarn3Pattern[] = PREWARN3_PATTERN;
 
 // Global state
 TOKEN_CACHE_ITEM* item;
-unsigned long lastOn = 0;
 
 // ActivityLED - blink red led if nothing happening
 #define LED_TOGGLE_DELAY 500
 unsigned long lastLedToggle = 0;
 
-// last time we beeped about time nearly running out
-unsigned long lastTimeoutBeep = 0;
-
 // Button debounce variables
 int buttonState;   
 int lastButtonState = LOW;
@@ -142,41 +165,76 @@ void redToggle()
     digitalWrite(PIN_LED_R, !digitalRead(PIN_LED_R));
 }
 
-void greenOn()
+// Called by the feedback PatternPlayer to set the buzzer and leds
+void setFeedbackOutputs(uint8_t outputs)
 {
-    digitalWrite(PIN_LED_G, HIGH);
+    digitalWrite(PIN_BUZZER, outputs & PATTERN_BUZZER ? HIGH : LOW);
+    digitalWrite(PIN_LED_R, outputs & PATTERN_RED ? HIGH : LOW);
+    digitalWrite(PIN_LED_G, outputs & PATTERN_GREEN ? HIGH : LOW);
 }
 
-void greenOff()
+void advanceFeedback()
 {
-    digitalWrite(PIN_LED_G, LOW);
+    feedback.loop();
 }
 
-void buzzerOn()
+void turnOffMachine()
 {
-    digitalWrite(PIN_BUZZER, HIGH);
+    feedback.setIdle(PATTERN_OFF);
+    feedback.stop();
+    if (isRelayOn()) {
+        relayOff();
+        usageLog.end();
+        accessSystem.sendLogMsg("Machine powered down");
+    }
 }
 
-void buzzerOff()
+// Called by the session on every state change, all outputs are driven from here
+void onSessionTransition(uint8_t from, uint8_t to)
 {
-    digitalWrite(PIN_BUZZER, LOW);
-}
+    switch (to) {
+        case SESSION_AUTHORISING:
+            if (isRelayOff()) {
+                Serial.println(F("Machine is off and a new card has been presented"));
+                feedback.play(cardPattern, PATTERN_LENGTH(cardPattern));
+            }
+            break;
+
+        case SESSION_ACTIVE:
+            if (isRelayOff()) {
+                accessSystem.sendLogMsg("Machine powered up by:", cardReader.lastToken);
+                relayOn();
+                usageLog.begin(&cardReader.lastUID, cardReader.lastLen);
+            } else {
+                // Time extended, stop any prewarn
+                feedback.stop();
+                usageLog.extend();
+            }
+            feedback.setIdle(PATTERN_GREEN);
+            break;
 
-void beep(int ms)
-{
-    buzzerOn();
-    delay(ms);
-    buzzerOff();
-}
+        case SESSION_PREWARN1:
+            Serial.println(F("Prewarn 1 triggered"));
+            feedback.play(prewarn1Pattern, PATTERN_LENGTH(prewarn1Pattern), true);
+            break;
 
-void turnOffMachine()
-{
-    greenOff();
-    buzzerOff();
-    relayOff();
-    lastOn = 0;
-    lastTimeoutBeep = 0;
-    accessSystem.sendLogMsg("Machine powered down");
+        case SESSION_PREWARN2:
+            Serial.println(F("Prewarn 2 triggered"));
+            feedback.play(prewarn2Pattern, PATTERN_LENGTH(prewarn2Pattern), true);
+            break;
+
+        case SESSION_PREWARN3:
+            Serial.println(F("Prewarn 3 triggered"));
+            feedback.play(prewarn3Pattern, PATTERN_LENGTH(prewarn3Pattern), true);
+            break;
+
+        case SESSION_POWERING_DOWN:
+            if (from == SESSION_PREWARN3) {
+                Serial.println(F("Time up, turning machine off"));
+            }
+            turnOffMachine();
+            break;
+    }
 }
 
 void setup()
@@ -193,15 +251,16 @@ void setup()
     pinMode(PIN_BUZZER, OUTPUT);
     pinMode(PIN_BUTTON, INPUT);
 
-    // Set initial pin states
+    // Set initial pin states, the ticker keeps feedback patterns
+    // playing while the main loop is busy
     relayOff();
-    redOff();
-    greenOff();
-    beep(500);
+    feedbackTicker.attach_ms(FEEDBACK_TICK_MS, advanceFeedback);
+    feedback.play(startupPattern, PATTERN_LENGTH(startupPattern));
 
     // Init helpers & hardware
     cardReader.init();
     tokenCache.init();
+    usageLog.init();
 
     // Connect to wifi
     Serial.print(F("Connecting wifi"));
@@ -221,89 +280,51 @@ void setup()
 
 void loop()
 {
+    // Heap and loop time report, sent every HEAP_REPORT_INTERVAL while nobody is waiting on
+    // the machine, as post() can wait seconds for the server; it stays due until then
+    bool heapReportDue = heapMonitor.loop(micros(), millis());
+    if (heapReportDue && session.state() == SESSION_IDLE) {
+        FixedString<HEAP_JSON_SIZE> json;
+        if (heapMonitor.toJson(json)) {
+            accessSystem.post("heap", json.c_str());
+        }
+        heapMonitor.reset(millis());
+    }
+
     // Check card reader
     if (cardReader.check()) {
-        if (isRelayOff()) {
-            Serial.println(F("Machine is off and a new card has been presented"));
-            beep(50);
-            redOff();
-        }
+        session.handle(SESSION_CARD, millis());
 
-        item = tokenCache.fetch(&cardReader.lastUID, cardReader.lastLen, cardReader.lastToken);
+        item = tokenCache.fetch(&cardReader.lastUID, cardReader.lastLen);
         
         if (item != NULL) {
             if (item->flags && TOKEN_ACCESS) {
-                if (isRelayOff()) {
-                    // Permission granted, so open/power the machine
-                    item->count++;
-
-                    Serial.print(F("Permission granted: "));
-                    Serial.println(item->count);
-                    accessSystem.sendLogMsg("Machine powered up by:" + cardReader.lastToken);
-                    relayOn();
-                }
-                // If the relay is already on, no need to beep / turn on, 
-                // just extend time, make sure buzzer is off and led is on
-                greenOn();
-                buzzerOff();
-                lastOn = millis();
+                // Permission granted, so power the machine or extend the session
+                item->count++;
+
+                Serial.print(F("Permission granted: "));
+                Serial.println(item->count);
+                session.handle(SESSION_GRANTED, millis());
             }
             else
             {
                 Serial.println(F("Permission denied."));
-                turnOffMachine();
-                redOn();
-                beep(2000);
-                redOff();
-                accessSystem.sendLogMsg("Machine access denied to:" + cardReader.lastToken);
+                session.handle(SESSION_DENIED, millis());
+                feedback.play(deniedPattern, PATTERN_LENGTH(deniedPattern));
+                accessSystem.sendLogMsg("Machine access denied to:", cardReader.lastToken);
             }
         }
         else
         {
             Serial.println(F("Token not found"));
-            turnOffMachine();
-            redOn();
-            beep(500);
-            redOff();
-            delay(500);
-            redOn();
-            beep(1500);
-            redOff();
-            accessSystem.sendLogMsg("Machine access denied to unknown token:" + cardReader.lastToken);
+            session.handle(SESSION_DENIED, millis());
+            feedback.play(unknownPattern, PATTERN_LENGTH(unknownPattern));
+            accessSystem.sendLogMsg("Machine access denied to unknown token:", cardReader.lastToken);
         }
     }
 
-    // Check if we should be turning the machine off, or notifying the user time is nearly up
-    if (isRelayOn()) {
-        if (millis() - lastOn > ACTIVE_TIME_MS){
-            Serial.println(F("Time up, turning machine off"));
-            turnOffMachine();
-
-        } else if (millis() - lastOn > PREWARN3_TIME_MS && millis()) {
-            // Make sure we only trigger prewarn3 once by checking lastTimeoutBeep != 0
-            // Note we do this in a sub-if, rather than in the else-if to stop 2 triggering.
-            if (lastTimeoutBeep != 0) {
-                Serial.println(F("Prewarn 3 triggered"));
-                greenOff();
-                buzzerOn();
-                lastTimeoutBeep = 0;
-            }
-
-        } else if (millis() - lastOn > PREWARN2_TIME_MS && millis() - lastTimeoutBeep > PREWARN2_BEEP_INTERVAL) {
-            Serial.println(F("Prewarn 2 triggered"));
-            greenOff();
-            beep(PREWARN2_BEEP_DURATION);
-            greenOn();
-            lastTimeoutBeep = millis();
-
-        } else if (millis() - lastOn > PREWARN1_TIME_MS && millis() - lastTimeoutBeep > PREWARN1_BEEP_INTERVAL) {
-            Serial.println(F("Prewarn 1 triggered"));
-            greenOff();
-            beep(PREWARN1_BEEP_DURATION);
-            greenOn();
-            lastTimeoutBeep = millis();
-        }
-    }
+    // Fire the prewarn and power down transitions when they are due
+    session.loop(millis());
 
     // Check power-down button, debounce, etc.
     int reading = analogRead(PIN_BUTTON) > 500 ? HIGH : LOW;
@@ -315,7 +336,7 @@ void loop()
             buttonState = reading;
             if (buttonState == HIGH) {
                 Serial.println(F("Machine off button pressed"));
-                turnOffMachine();
+                session.handle(SESSION_BUTTON, millis());
             }
         }
     }
@@ -324,11 +345,16 @@ void loop()
     // Allow the cache to sync
     tokenCache.loop();
 
+    // Upload usage in batches, while nobody is waiting on the machine
+    if (session.state() == SESSION_IDLE) {
+        usageLog.loop();
+    }
+
     // Keep wifi alive
     pka.loop();
 
     // Gently blink RED led to indicate controller is alive and connected to wifi
-    if (millis() - lastLedToggle > LED_TOGGLE_DELAY && pka.isConnected) {
+    if (millis() - lastLedToggle > LED_TOGGLE_DELAY && pka.isConnected && !feedback.isPlaying()) {
         redToggle();
         lastLedToggle = millis();
     }
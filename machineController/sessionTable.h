@@ -0,0 +1,39 @@
+/*
+    Session state machine for the Machine Controller, timings come from config.h
+
+    Kept separate from the sketch so the same table can be run off-device, see host/test
+*/
+
+#ifndef SESSION_TABLE_H
+#define SESSION_TABLE_H
+
+#include <MachineSession.h>
+#include "config.h"
+
+// Session state table, one row per state:
+// {timeout, {next state on CARD, GRANTED, DENIED, BUTTON, TIMEOUT}}
+const SESSION_STATE_INFO sessionTable[SESSION_STATE_COUNT] = {
+    // SESSION_IDLE
+    { SESSION_NO_TIMEOUT,
+      { SESSION_AUTHORISING, SESSION_IDLE, SESSION_IDLE, SESSION_POWERING_DOWN, SESSION_IDLE } },
+    // SESSION_AUTHORISING
+    { SESSION_NO_TIMEOUT,
+      { SESSION_AUTHORISING, SESSION_ACTIVE, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_AUTHORISING } },
+    // SESSION_ACTIVE
+    { PREWARN1_TIME_MS,
+      { SESSION_AUTHORISING, SESSION_ACTIVE, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_PREWARN1 } },
+    // SESSION_PREWARN1
+    { PREWARN2_TIME_MS - PREWARN1_TIME_MS,
+      { SESSION_AUTHORISING, SESSION_ACTIVE, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_PREWARN2 } },
+    // SESSION_PREWARN2
+    { PREWARN3_TIME_MS - PREWARN2_TIME_MS,
+      { SESSION_AUTHORISING, SESSION_ACTIVE, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_PREWARN3 } },
+    // SESSION_PREWARN3
+    { ACTIVE_TIME_MS - PREWARN3_TIME_MS,
+      { SESSION_AUTHORISING, SESSION_ACTIVE, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN } },
+    // SESSION_POWERING_DOWN
+    { 0,
+      { SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_POWERING_DOWN, SESSION_IDLE } },
+};
+
+#endif
@@ -10,8 +10,10 @@
 #include <PN532_I2C.h>
 #include <PN532.h>
 #include <TaskScheduler.h>
+#include <FixedString.h>
 #include <EEPROM.h>
 #include <Adafruit_NeoPixel.h>
+#include <PixelRing.h>
 
 /* ========================================================================== *
  *  Pinout
@@ -50,6 +52,8 @@
 #define SERVER_HOST       "192.168.1.70"
 #define SERVER_PORT       3000
 #define SERVER_URLPREFIX  "/"
+#define REQUEST_SIZE      256   // buffer for building http requests
+#define LINE_SIZE         200   // longest http response line we keep
 // http://www.swindon-makerspace.org/api/telegram/?msg=i+do+not+spellz+good&groupid=-20679102
 #define TELEGRAM_HOST     "www.swindon-makerspace.org"
 #define WIFI_CONNECTION_TASK_INTERVAL   60000 // milliseconds
@@ -123,7 +127,7 @@ void monitorExitButton();
 void animation();
 
 // other prototypes
-uint8_t queryServer(String cardID);
+uint8_t queryServer(const char *cardID);
 boolean isDoorUnlocked();
 
 void syncEEPROM();
@@ -168,8 +172,8 @@ unsigned long outputEnableTimer;
 unsigned long unlockCount = 0;
 boolean exitPressed = false;
 
-// neopixel
-Adafruit_NeoPixel strip = Adafruit_NeoPixel(24, NEOPIXEL_PIN, NEO_GRB + NEO_KHZ800);
+// neopixel, only sends frames that have changed
+PixelRing strip = PixelRing(24, NEOPIXEL_PIN, NEO_GRB + NEO_KHZ800);
 
 // doorbell
 unsigned long doorbellTimer = 0;
@@ -180,13 +184,8 @@ boolean doorbellOn = false;
  *  Utility Functions
  * ========================================================================== */
 
-String byteArrayToHexString(const uint8_t *data, const uint32_t numBytes) {
-  String res = "";
-  for (uint8_t i = 0; i < numBytes; i++) {
-        res += String(data[i], HEX);
-    }
-  return res;
-}
+// scratch buffer for the current token as a hex string
+char tokenStr[TOKEN_STR_SIZE];
 
 void uptime(boolean display = true)
 {
@@ -254,7 +253,8 @@ void colorWipe(uint32_t c, uint8_t wait) {
   for(uint16_t i=0; i<strip.numPixels(); i++) {
     strip.setPixelColor(i, c);
     if (wait >0 ) {
-      strip.show();
+      // deliberate wipe, so show every step
+      strip.showNow();
       delay(wait);
     }
   }
@@ -356,7 +356,7 @@ void unlockDoor(unsigned long duration) {
   digitalWrite(OUTPUT_PIN, LOW);
   outputEnableTimer = millis() + duration;
   // green when unlocked
-  colorWipe(strip.Color(0, 255, 0), 1);
+  colorWipe(strip.Color(0, 255, 0), 0);
 }
 
 void lockDoor() {
@@ -478,7 +478,8 @@ void initCache() {
     cache[i].flags = EEPROM.read(addr + 8);
 
     Serial.print("  ");
-    Serial.print(byteArrayToHexString(cache[i].token, cache[i].length));
+    formatToken(tokenStr, cache[i].token, cache[i].length);
+    Serial.print(tokenStr);
     Serial.print(" : ");
     Serial.println(cache[i].flags);
 
@@ -505,10 +506,11 @@ void syncCache() {
     // if reached zero
     if (cache[i].sync == 0) {
       Serial.print("Syncing cached flags for: ");
-      Serial.println(byteArrayToHexString(cache[i].token, cache[i].length));
+      formatToken(tokenStr, cache[i].token, cache[i].length);
+      Serial.println(tokenStr);
 
       // query permission flags from server
-      uint8_t flags = queryServer(byteArrayToHexString(cache[i].token, cache[i].length));
+      uint8_t flags = queryServer(tokenStr);
 
       if (flags != TOKEN_ERROR) {
          // if successful, update flags and reset sync counter
@@ -572,7 +574,7 @@ void syncEEPROM() {
  * ========================================================================== */
 
 // query server for token, and return flags
-uint8_t queryServer(String cardID) {
+uint8_t queryServer(const char *cardID) {
    // TODO: Rewrite/refactor
    uint8_t flags = 0;
 
@@ -593,20 +595,17 @@ uint8_t queryServer(String cardID) {
    }
 
    // We now create a URI for the request
-   String url = SERVER_URLPREFIX;
-   url += "verify";
-   url += "?token=";
-   url += cardID;
-   url += "&thing=";
-   url += THING_ID;
+   FixedString<REQUEST_SIZE> request;
+   request.append("GET " SERVER_URLPREFIX "verify?token=").append(cardID);
+   request.append("&thing=" THING_ID);
 
    Serial.print("Requesting URL: ");
-   Serial.println(url);
+   Serial.println(request.c_str() + 4);
 
    // This will send the request to the server
-   client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                "Host: " + host + "\r\n" +
-                "Connection: close\r\n\r\n");
+   request.append(" HTTP/1.1\r\nHost: ").append(host);
+   request.append("\r\nConnection: close\r\n\r\n");
+   client.write((const uint8_t *)request.c_str(), request.length());
    int checkCounter = 0;
    while (!client.available() && checkCounter < 3000) {
      delay(10);
@@ -616,15 +615,19 @@ uint8_t queryServer(String cardID) {
    // Read reply and decode json
    while(client.available()){
      // TODO: Replace with better/more robust streaming HTTP header parser
-     String json;
-     boolean endOfHeaders = false;
-     while (!endOfHeaders && client.available()) {
+     // the last non blank line is the json body
+     char json[LINE_SIZE];
+     char line[LINE_SIZE];
+     json[0] = 0;
+     while (client.available()) {
        // feed the watchdog
        yield();
-       json = client.readStringUntil('\n');
+       size_t n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+       if (n > 0 && line[n - 1] == '\r') n--;
+       line[n] = 0;
        Serial.print("_");
-       Serial.print(json);
-       if (json == "") endOfHeaders = true;
+       Serial.println(line);
+       if (n > 0) memcpy(json, line, n + 1);
      }
      Serial.println("json:");
      Serial.println(json);
@@ -657,7 +660,7 @@ uint8_t queryServer(String cardID) {
 
 
 // send a log msg to the server, fire and forget
-void sendLogMsg(String msg) {
+void sendLogMsg(const char *msg, const char *token = NULL) {
    Serial.print("Sending log to server: ");
    Serial.println(host);
 
@@ -673,18 +676,19 @@ void sendLogMsg(String msg) {
      return;
    }
 
-   String url = SERVER_URLPREFIX;
-   url += "msglog?thing=";
-   url += THING_ID;
-   url += "&msg=";
-   url += msg;
+   FixedString<REQUEST_SIZE> request;
+   request.append("GET " SERVER_URLPREFIX "msglog?thing=" THING_ID "&msg=");
+   request.appendUrlEncoded(msg);
+   if (token != NULL) {
+     request.appendUrlEncoded(token);
+   }
 
-   Serial.println(url);
+   Serial.println(request.c_str() + 4);
 
    // This will send the request to the server
-   client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                "Host: " + host + "\r\n" +
-                "Connection: close\r\n\r\n");
+   request.append(" HTTP/1.1\r\nHost: ").append(host);
+   request.append("\r\nConnection: close\r\n\r\n");
+   client.write((const uint8_t *)request.c_str(), request.length());
 
    // don't care if it succeeds, so close connection and return
    client.flush();
@@ -810,10 +814,12 @@ void lookForCard() {
 
     lastChecked = millis();
 
-    Serial.print("Card found, token: ");  Serial.println(byteArrayToHexString(uid, uidLength));
+    formatToken(tokenStr, uid, uidLength);
+    Serial.print("Card found, token: ");  Serial.println(tokenStr);
 
-    // blue - found card
-    colorWipe(strip.Color(255, 128, 0), 1);
+    // blue - found card, sent now as queryServer blocks before the next show
+    colorWipe(strip.Color(255, 128, 0), 0);
+    strip.showNow();
 
     // check cache
     item = getTokenFromCache(&uid, uidLength);
@@ -821,7 +827,7 @@ void lookForCard() {
     //if not found, then query server and add to cache if has permission
     if (item == NULL) {
       Serial.println("Not in cache");
-      uint8_t flags = queryServer(byteArrayToHexString(uid, uidLength));
+      uint8_t flags = queryServer(tokenStr);
       Serial.println(flags);
       if ((flags > 0) && (flags != TOKEN_ERROR)) {
         item = addTokenToCache(&uid, uidLength, flags);
@@ -842,14 +848,14 @@ void lookForCard() {
         Serial.println(item->count);
         unlockDoor(OUTPUT_ENABLE_DURATION);
 
-        sendLogMsg("Permission%20granted%20to:%20" + byteArrayToHexString(uid, uidLength));
+        sendLogMsg("Permission granted to: ", tokenStr);
         
         //sendTelegramMsg("Door opened");
 
       } else {
         // permission denied!
         Serial.println("Permission denied");
-        sendLogMsg("Permission%20denied%20to:%20" + byteArrayToHexString(uid, uidLength));
+        sendLogMsg("Permission denied to: ", tokenStr);
 
         // red
         colorWipe(strip.Color(255, 0, 0), 5);
@@ -863,7 +869,7 @@ void lookForCard() {
     } else {
       // permission denied!
         Serial.println("Permission denied");
-        sendLogMsg("Permission%20denied%20to:%20" + byteArrayToHexString(uid, uidLength));
+        sendLogMsg("Permission denied to: ", tokenStr);
 
         // red
         colorWipe(strip.Color(255, 0, 0), 5);
@@ -1080,6 +1086,7 @@ void loop(void) {
 
   // TODO: stick these in tasks
   animation();
+  strip.loop();  // flush any rate limited frame
   monitorDoorbell();
   
   // visual comfort
@@ -1,5 +1,5 @@
 // Enable WIFI debugging
-#define DEBUG_ESP_PORT Serial
+#define DEBUG_ESP_PORT Serial1
 #define DDEBUG_ESP_CORE
 #define DDEBUG_ESP_WIFI
 
@@ -7,12 +7,17 @@
 #include <ESP8266WiFi.h>
 #include <Wire.h>
 #include <TaskScheduler.h>
+#include <EspLink.h>
+#include <FixedString.h>
+#include <HeapMonitor.h>
 
 /* ========================================================================== *
  *  Pinout
  * ========================================================================== */
 // NB: Do not use D0 or D2, these need to be pulled high by 10k resistors to ensure correct
 //     boot sequence following watchdog/internal reset
+// Serial (TX/RX) is the link to the door controller, only EspLink frames go out on it
+// Serial1 is debug output, transmit only on GPIO2
 
 
 #define DEBUG_CAPSENSE
@@ -51,6 +56,18 @@
 
 #define OUTPUT_ENABLE_DURATION          10000 // milliseconds
 
+#define LINK_BAUD         115200
+#define DEBUG_BAUD        115200
+
+#define MAX_JOBS          6     // queued requests from the door
+#define MAX_CONNECTIONS   2     // verify requests in flight at once
+#define VERIFY_TIMEOUT    10000 // milliseconds
+#define UPLOAD_TIMEOUT    5000  // milliseconds to wait for the server to close after a log or telemetry upload
+#define CONNECT_TIMEOUT   1000  // milliseconds a connect may block loop, the server is on the LAN
+#define MAX_RESPONSE      400   // bytes of an http response kept
+#define MAX_ARG           384   // token, log message, telemetry or heap json
+#define REQUEST_SIZE      512   // buffer for building http requests
+
 IPAddress ip(192,168,1,252);  //Node static IP
 IPAddress gateway(192,168,1,1);
 IPAddress subnet(255,255,255,0);
@@ -92,6 +109,33 @@ struct TOKEN_CACHE_ITEM {
 };
 // stored size = 9 bytes
 
+// states for REQUEST_JOB
+#define JOB_FREE      0
+#define JOB_QUEUED    1   // waiting for a connection
+#define JOB_RUNNING   2   // request sent, reading the response
+
+// REQUEST_JOB type for the bridge's own heap report, alongside the ESPLINK_ types
+#define JOB_HEAP      0x40
+
+/*
+  * a request from the door, run asynchronously so the serial link never waits on http
+  * type - ESPLINK_VERIFY, ESPLINK_LOG, ESPLINK_TELEMETRY, ESPLINK_LOOPSTATS or JOB_HEAP
+  * seq - from the request frame, returned in the reply
+  * ticket - queue order
+  * arg - token as hex, the log message, or the telemetry/loop/heap json
+  */
+struct REQUEST_JOB {
+    uint8_t state;
+    uint8_t type;
+    uint8_t seq;
+    uint32_t ticket;
+    char arg[MAX_ARG];
+    WiFiClient client;
+    char response[MAX_RESPONSE + 1];
+    uint16_t responseLength;
+    unsigned long started;
+};
+
 
 /* ========================================================================== *
  *  Prototypes for task callbacks, etc
@@ -101,6 +145,9 @@ struct TOKEN_CACHE_ITEM {
 void keepWifiConnected();
 void displayUptime();
 
+// request queue
+REQUEST_JOB *nextQueued(boolean verify);
+
 /* ========================================================================== *
  *  Global Variables / Objects
  * ========================================================================== */
@@ -110,8 +157,16 @@ const char* password = NETWORK_PASSWORD;
 const char* host = SERVER_HOST;
 const int hostPort = SERVER_PORT;
 
-String inputString = "";         // a string to hold incoming data
-boolean stringComplete = false;  // whether the string is complete
+// frames from the door controller
+EspLinkDecoder espLink;
+
+// heap and loop time report
+HeapMonitor heapMonitor;
+
+// request queue
+REQUEST_JOB jobs[MAX_JOBS];
+uint32_t nextTicket = 0;
+uint16_t droppedLogs = 0;
 
 
 // tasks
@@ -127,14 +182,6 @@ Scheduler runner;
  *  Utility Functions
  * ========================================================================== */
 
-String byteArrayToHexString(const uint8_t *data, const uint32_t numBytes) {
-  String res = "";
-  for (uint8_t i = 0; i < numBytes; i++) {
-        res += String(data[i], HEX);
-    }
-  return res;
-}
-
 void uptime(boolean display = true)
 {
   static uint16_t rollover = 0;  // to count timer rollovers
@@ -164,22 +211,27 @@ void uptime(boolean display = true)
 
   //Display results
   if (display) {
-    Serial.print("Uptime: ");
+    Serial1.print("Uptime: ");
     if (days>0) // days will displayed only if value is greater than zero
     {
-        Serial.print(days);
-        Serial.print("d ");
+        Serial1.print(days);
+        Serial1.print("d ");
     }
-    Serial.print(hours);
-    Serial.print(":");
-    Serial.print(mins);
-    Serial.print(":");
-    Serial.println(secs);
+    Serial1.print(hours);
+    Serial1.print(":");
+    Serial1.print(mins);
+    Serial1.print(":");
+    Serial1.println(secs);
   }
 }
 
 void displayUptime() {
   uptime(true);
+
+  if (droppedLogs > 0) {
+    Serial1.print("Dropped logs: ");
+    Serial1.println(droppedLogs);
+  }
 }
 
 inline int max(int a,int b) {return ((a)>(b)?(a):(b)); }
@@ -195,158 +247,171 @@ inline int clamp(int v, int minV, int maxV) {
  *  HTTP Client
  * ========================================================================== */
 
-// query server for token, and return flags
-uint8_t queryServer(String cardID) {
-   // TODO: Rewrite/refactor
-   uint8_t flags = 0;
+// endpoint a log or telemetry job is uploaded to
+const char *uploadPath(uint8_t type) {
+   switch (type) {
+     case ESPLINK_TELEMETRY: return "telemetry";
+     case ESPLINK_LOOPSTATS: return "loopstats";
+     case JOB_HEAP: return "heap";
+     default: return "msglog";
+   }
+}
 
+// connect and send the request for job, returns false if it could not be sent
+// the response is read by runJobs, only the connect blocks, for at most CONNECT_TIMEOUT
+boolean startRequest(REQUEST_JOB &job) {
    // check if connected
    if ( WiFi.status() != WL_CONNECTED ) {
-     //Serial.println("Error: WiFi Not Connected");
-     return TOKEN_ERROR;
+     return false;
    }
 
-   //Serial.print("Querying server: ");
-   //Serial.println(host);
-
-   // Use WiFiClient class to create TCP connections
-   WiFiClient client;
-   if (!client.connect(host, hostPort)) {
-     //Serial.println("Error: Connection failed");
-     return TOKEN_ERROR;
+   // the ESP8266 core bounds connect() by the stream timeout
+   job.client.setTimeout(CONNECT_TIMEOUT);
+   if (!job.client.connect(host, hostPort)) {
+     return false;
    }
 
    // We now create a URI for the request
-   String url = SERVER_URLPREFIX;
-   url += "verify";
-   url += "?token=";
-   url += cardID;
-   url += "&thing=";
-   url += THING_ID;
+   FixedString<REQUEST_SIZE> request;
+   size_t bodyLength = 0;
+   if (job.type == ESPLINK_VERIFY) {
+     request.append("GET " SERVER_URLPREFIX "verify?token=").append(job.arg);
+     request.append("&thing=" THING_ID);
+   } else if (job.type == ESPLINK_LOG) {
+     request.append("GET " SERVER_URLPREFIX "msglog?thing=" THING_ID "&msg=");
+     request.appendUrlEncoded(job.arg);
+     Serial1.println(request.c_str() + 4);
+   } else {
+     // telemetry, loop stats or heap json, posted as the body
+     bodyLength = strlen(job.arg);
+     request.append("POST " SERVER_URLPREFIX).append(uploadPath(job.type)).append("?thing=" THING_ID);
+     Serial1.println(request.c_str() + 5);
+   }
 
-   //Serial.print("Requesting URL: ");
-   //Serial.println(url);
+   request.append(" HTTP/1.1\r\nHost: ").append(host);
+   if (bodyLength > 0) {
+     request.append("\r\nContent-Type: application/json\r\nContent-Length: ").appendUInt(bodyLength);
+   }
+   request.append("\r\nConnection: close\r\n\r\n");
 
    // This will send the request to the server
-   client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                "Host: " + host + "\r\n" +
-                "Connection: close\r\n\r\n");
-   int checkCounter = 0;
-   while (!client.available() && checkCounter < 3000) {
-     delay(10);
-     checkCounter++;
+   job.client.write((const uint8_t *)request.c_str(), request.length());
+   if (bodyLength > 0) {
+     job.client.write((const uint8_t *)job.arg, bodyLength);
    }
+   return true;
+}
 
-   // Read reply and decode json
-   if (client.available()) {
-     while(client.available()){
-       // TODO: Replace with better/more robust streaming HTTP header parser
-       String json;
-       boolean endOfHeaders = false;
-       while (!endOfHeaders && client.available()) {
-         // feed the watchdog
-         yield();
-         json = client.readStringUntil('\n');
-         //Serial.print("_");
-         //Serial.print(json);
-         if (json == "") endOfHeaders = true;
-       }
-       //Serial.println("json:");
-       //Serial.println(json);
-  
-       StaticJsonBuffer<200> jsonBuffer;
-  
-       JsonObject& root = jsonBuffer.parseObject(json);
-  
-       // Test if parsing succeeds.
-       if (!root.success()) {
-         Serial.println("Error: Couldn't parse JSON");
-         return TOKEN_ERROR;
-       }
-
-       if (!root.containsKey("access")) {
-         Serial.println("Error: No access info");
-         return TOKEN_ERROR;
-       }
-       
-       // Check json response for access permission
-       if (root["access"] == 1) {
-         flags |= TOKEN_ACCESS;
-       }
-  
-       if (root["trainer"] == 1) {
-         flags |= TOKEN_TRAINER;
-       }
-     }
-     
-   } else {
-    flags = TOKEN_ERROR;
+// decode the flags from a complete verify response
+uint8_t parseVerifyResponse(char *response) {
+   uint8_t flags = 0;
+
+   // json is the body, after the blank line ending the headers
+   char *json = strstr(response, "\r\n\r\n");
+   if (json == NULL) {
+     return TOKEN_ERROR;
    }
+   json += 4;
 
-   // close connection
-   client.stop();
+   StaticJsonBuffer<200> jsonBuffer;
 
-   return flags;
-}
+   // parses in place
+   JsonObject& root = jsonBuffer.parseObject(json);
 
+   // Test if parsing succeeds.
+   if (!root.success()) {
+     Serial1.println("Error: Couldn't parse JSON");
+     return TOKEN_ERROR;
+   }
 
-// send a log msg to the server, fire and forget
-void sendLogMsg(String msg) {
-   Serial.print("Sending log to server: ");
-   Serial.println(host);
+   if (!root.containsKey("access")) {
+     Serial1.println("Error: No access info");
+     return TOKEN_ERROR;
+   }
 
-   // check if connected
-   if ( WiFi.status() != WL_CONNECTED ) {
-    Serial.println("Error: WiFi Not Connected");
-    return;
+   // Check json response for access permission
+   if (root["access"] == 1) {
+     flags |= TOKEN_ACCESS;
    }
 
-   WiFiClient client;
-   if (!client.connect(host, hostPort)) {
-     Serial.println("Error: Connection failed");
-     return;
+   if (root["trainer"] == 1) {
+     flags |= TOKEN_TRAINER;
    }
 
-   String url = SERVER_URLPREFIX;
-   url += "msglog?thing=";
-   url += THING_ID;
-   url += "&msg=";
-   url += msg;
+   return flags;
+}
 
-   Serial.println(url);
 
-   // This will send the request to the server
-   client.print(String("GET ") + url + " HTTP/1.1\r\n" +
-                "Host: " + host + "\r\n" +
-                "Connection: close\r\n\r\n");
+// door telemetry plus the bridge's own stats, as json in buf
+void telemetryJson(const ESPLINK_TELEMETRY_RECORD &t, char *buf, size_t size) {
+  StaticJsonBuffer<JSON_OBJECT_SIZE(14)> jsonBuffer;
+  JsonObject& root = jsonBuffer.createObject();
 
-   // don't care if it succeeds, so close connection and return
-   client.flush();
-   client.stop();
-   return;
+  root["uptime"] = t.uptime;
+  root["unlocks"] = t.unlocks;
+  root["pn532Resets"] = t.pn532Resets;
+  root["espResets"] = t.espResets;
+  root["cacheHits"] = t.cacheHits;
+  root["cacheMisses"] = t.cacheMisses;
+  if (t.cacheHits + t.cacheMisses > 0) {
+    root["cacheHitRatio"] = (double)t.cacheHits / (t.cacheHits + t.cacheMisses);
+  }
+  root["loops"] = t.loops;
+  root["loopAvgUs"] = t.loopAvg;
+  root["loopMaxUs"] = t.loopMax;
+  root["linkErrors"] = t.linkErrors;
+
+  // bridge
+  root["bridgeUptime"] = millis() / 1000;
+  root["bridgeLinkErrors"] = espLink.crcErrors + espLink.framingErrors;
+  root["droppedLogs"] = droppedLogs;
+
+  root.printTo(buf, size);
+}
+
+
+// door loop timing, as json in buf
+void loopStatsJson(const ESPLINK_LOOP_RECORD &l, char *buf, size_t size) {
+  FixedString<MAX_ARG> json;
+
+  json.append("{\"longestUs\":").appendUInt(l.longest);
+  json.append(",\"longestPhase\":").appendUInt(l.longestPhase);
+  json.append(",\"wdtGapMaxMs\":").appendUInt(l.wdtGapMax);
+  json.append(",\"wdtNearMisses\":").appendUInt(l.wdtNearMisses);
+
+  // bucket n counts loops of 2^(n-1) to 2^n ms, bucket 0 is under 1ms
+  json.append(",\"loopHist\":[");
+  for (uint8_t i = 0; i < ESPLINK_LOOP_BUCKETS; i++) {
+    if (i > 0) json.append(',');
+    json.appendUInt(l.hist[i]);
+  }
+  json.append("]}");
+
+  strncpy(buf, json.c_str(), size - 1);
+  buf[size - 1] = 0;
 }
 
 
 // TODO: Fix this, has stopped working?!?
 void sendTelegramMsg(String msg) {
-   Serial.print("Sending msg to telegram");
+   Serial1.print("Sending msg to telegram");
 
    // check if connected
    if ( WiFi.status() != WL_CONNECTED ) {
-    Serial.println("Error: WiFi Not Connected");
+    Serial1.println("Error: WiFi Not Connected");
     return;
    }
 
    WiFiClient client;
    if (!client.connect(TELEGRAM_HOST, 80)) {
-     Serial.println("Error: Connection failed");
+     Serial1.println("Error: Connection failed");
      return;
    }
 
    String url = "/api/telegram/?groupid=-20679102&msg=";
    url += msg;
 
-   Serial.println(url);
+   Serial1.println(url);
 
    // This will send the request to the server
    client.print(String("GET ") + url + " HTTP/1.1\r\n" +
@@ -370,7 +435,7 @@ void sendTelegramMsg(String msg) {
 void keepWifiConnected() {
 
    if (WiFi.status() != WL_CONNECTED) {
-      Serial.print("WiFi -> Connecting to: ");  Serial.println(ssid);
+      Serial1.print("WiFi -> Connecting to: ");  Serial1.println(ssid);
 
       WiFi.disconnect(true); // abandon any previous connection attempt
       WiFi.mode(WIFI_STA);  // force mode to STA only
@@ -380,8 +445,8 @@ void keepWifiConnected() {
       // check again to see if connection established...
       WifiConnectionTask.setInterval(WIFI_CONNECTION_TASK_INTERVAL);
    } else {
-      //Serial.print("WiFi -> OK, IP: ");
-      //Serial.println(WiFi.localIP());
+      //Serial1.print("WiFi -> OK, IP: ");
+      //Serial1.println(WiFi.localIP());
 
       // sorted, shouldn't need to check again for a while
       WifiConnectionTask.setInterval(WIFI_CONNECTION_TASK_INTERVAL);
@@ -389,40 +454,188 @@ void keepWifiConnected() {
 }
 
 
+/* ========================================================================== *
+ *  Request queue
+ * ========================================================================== */
+
+// queue a request from the door, returns a job to fill in with arg, or NULL if there was no room
+REQUEST_JOB *queueJob(uint8_t type, uint8_t seq) {
+  REQUEST_JOB *job = NULL;
+
+  for (uint8_t i=0; i<MAX_JOBS; i++) {
+    if (jobs[i].state == JOB_FREE) {
+      job = &jobs[i];
+      break;
+    }
+  }
+
+  // queue full, a verify takes the place of the oldest queued log or telemetry
+  if (job == NULL && type == ESPLINK_VERIFY) {
+    job = nextQueued(false);
+    if (job != NULL) {
+      droppedLogs++;
+    }
+  }
+
+  if (job == NULL) {
+    return NULL;
+  }
+
+  job->state = JOB_QUEUED;
+  job->type = type;
+  job->seq = seq;
+  job->ticket = nextTicket++;
+  job->arg[0] = 0;
+  job->responseLength = 0;
+  return job;
+}
+
+// reply to the door and free the job
+void finishVerify(REQUEST_JOB &job, uint8_t flags) {
+  espLinkSend(Serial, job.seq, ESPLINK_VERIFY | ESPLINK_REPLY, &flags, 1);
+  job.client.stop();
+  job.state = JOB_FREE;
+}
+
+// uploads are fire and forget, the response is only drained until the server closes
+void finishUpload(REQUEST_JOB &job) {
+  job.client.stop();
+  job.state = JOB_FREE;
+}
+
+// oldest queued verify, or oldest queued log/telemetry upload, or NULL
+REQUEST_JOB *nextQueued(boolean verify) {
+  REQUEST_JOB *job = NULL;
+  for (uint8_t i=0; i<MAX_JOBS; i++) {
+    if (jobs[i].state == JOB_QUEUED && (jobs[i].type == ESPLINK_VERIFY) == verify &&
+        (job == NULL || jobs[i].ticket < job->ticket)) {
+      job = &jobs[i];
+    }
+  }
+  return job;
+}
+
+// called from loop, only waits on the server for a connect, at most CONNECT_TIMEOUT
+// verifies are read as their responses arrive and replied to in whatever order they finish,
+// logs and telemetry go out one at a time, only when no verify is waiting and no frame is arriving
+void runJobs() {
+  uint8_t running = 0;    // verifies in flight
+  uint8_t uploading = 0;  // logs or telemetry in flight
+
+  // read responses
+  for (uint8_t i=0; i<MAX_JOBS; i++) {
+    REQUEST_JOB &job = jobs[i];
+    if (job.state != JOB_RUNNING) continue;
+
+    boolean verify = job.type == ESPLINK_VERIFY;
+    while (job.client.available()) {
+      char c = job.client.read();
+      if (verify && job.responseLength < MAX_RESPONSE) {
+        job.response[job.responseLength++] = c;
+      }
+    }
+
+    // server closed the connection, response complete
+    boolean complete = !job.client.connected() && !job.client.available();
+    if (!verify) {
+      if (complete || millis() - job.started > UPLOAD_TIMEOUT) {
+        finishUpload(job);
+      } else {
+        uploading++;
+      }
+    } else if (complete) {
+      job.response[job.responseLength] = 0;
+      finishVerify(job, parseVerifyResponse(job.response));
+    } else if (millis() - job.started > VERIFY_TIMEOUT) {
+      finishVerify(job, TOKEN_ERROR);
+    } else {
+      running++;
+    }
+  }
+
+  // start the next verify
+  REQUEST_JOB *job = nextQueued(true);
+  if (job != NULL) {
+    if (running < MAX_CONNECTIONS) {
+      if (startRequest(*job)) {
+        job->state = JOB_RUNNING;
+        job->started = millis();
+      } else {
+        finishVerify(*job, TOKEN_ERROR);
+      }
+    }
+    return;
+  }
+
+  // nothing waiting on a verify, so send a log or telemetry, unless the door is sending
+  // a frame that may be a verify or a heartbeat
+  if (running == 0 && uploading == 0 && !Serial.available()) {
+    job = nextQueued(false);
+    if (job != NULL) {
+      if (startRequest(*job)) {
+        job->state = JOB_RUNNING;
+        job->started = millis();
+      } else {
+        Serial1.println("Error: Connection failed");
+        job->state = JOB_FREE;
+      }
+    }
+  }
+}
+
+
 /* ========================================================================== *
  *  Serial handling
  * ========================================================================== */
 
 void handleSerial() {
   while (Serial.available()) {
-    char inChar = (char)Serial.read();
-    if (inChar == '\n') {
-      stringComplete = true;
-    } else {
-      inputString += inChar;
+    if (espLink.decode(Serial.read())) {
+      ESPLINK_FRAME &f = espLink.frame;
+
+      if (f.type == ESPLINK_VERIFY) {
+        // validate query, replied to from runJobs with the same seq
+        REQUEST_JOB *job = f.length * 2 < TOKEN_STR_SIZE ? queueJob(ESPLINK_VERIFY, f.seq) : NULL;
+        if (job != NULL) {
+          formatToken(job->arg, f.payload, f.length);
+        } else {
+          uint8_t v = TOKEN_ERROR;
+          espLinkSend(Serial, f.seq, ESPLINK_VERIFY | ESPLINK_REPLY, &v, 1);
+        }
+      } else if (f.type == ESPLINK_LOG) {
+        // log message
+        REQUEST_JOB *job = queueJob(ESPLINK_LOG, f.seq);
+        if (job != NULL) {
+          memcpy(job->arg, f.payload, f.length);
+          job->arg[f.length] = 0;
+        } else {
+          droppedLogs++;
+        }
+      } else if (f.type == ESPLINK_TELEMETRY && f.length == sizeof(ESPLINK_TELEMETRY_RECORD)) {
+        ESPLINK_TELEMETRY_RECORD t;
+        memcpy(&t, f.payload, sizeof(t));
+        REQUEST_JOB *job = queueJob(ESPLINK_TELEMETRY, f.seq);
+        if (job != NULL) {
+          telemetryJson(t, job->arg, sizeof(job->arg));
+        } else {
+          droppedLogs++;
+        }
+      } else if (f.type == ESPLINK_LOOPSTATS && f.length == sizeof(ESPLINK_LOOP_RECORD)) {
+        ESPLINK_LOOP_RECORD l;
+        memcpy(&l, f.payload, sizeof(l));
+        REQUEST_JOB *job = queueJob(ESPLINK_LOOPSTATS, f.seq);
+        if (job != NULL) {
+          loopStatsJson(l, job->arg, sizeof(job->arg));
+        } else {
+          droppedLogs++;
+        }
+      } else if (f.type == ESPLINK_HEARTBEAT) {
+        // heartbeat request
+        espLinkSend(Serial, f.seq, ESPLINK_HEARTBEAT | ESPLINK_REPLY, NULL, 0);
+      }
     }
     yield();
   }
-  
-  if (stringComplete) {
-
-    // validate query?
-    if (inputString[0] == '?') {
-      uint8_t v = queryServer(inputString.substring(1));
-      Serial.print('?');
-      Serial.println(v);
-    } else if (inputString[0] == '!') {
-      // log message
-      sendLogMsg(inputString.substring(1));
-    } else if (inputString[0] == '~') {
-      // heartbeat request
-      Serial.println('~');
-    }
-    
-    // clear the string:
-    inputString = "";
-    stringComplete = false;
-  }
 }
 
 
@@ -437,19 +650,17 @@ void setup(void) {
   WiFi.setAutoReconnect(false);
 
   // start serial
-  Serial.begin(9600);
-
-  Serial.setDebugOutput(true);
+  Serial.begin(LINK_BAUD);
+  Serial1.begin(DEBUG_BAUD);
 
-  Serial.println("");
-  Serial.println("Door Controller WiFi");
-  Serial.print("V:");  Serial.println(VERSION);
+  Serial1.setDebugOutput(true);
 
-  // reserve 200 bytes for the inputString:
-  inputString.reserve(200);
+  Serial1.println("");
+  Serial1.println("Door Controller WiFi");
+  Serial1.print("V:");  Serial1.println(VERSION);
 
   // Setup scheduler
-  Serial.println("Configuring tasks...");
+  Serial1.println("Configuring tasks...");
   runner.init();
   runner.addTask(WifiConnectionTask);
   runner.addTask(displayUptimeTask);
@@ -458,8 +669,8 @@ void setup(void) {
   WifiConnectionTask.enableDelayed(2000);
   displayUptimeTask.enable();
 
-  Serial.println("Ready");
-  Serial.println();
+  Serial1.println("Ready");
+  Serial1.println();
 }
 
 
@@ -468,6 +679,20 @@ void setup(void) {
  * ========================================================================== */
 
 void loop(void) {
+  // queue a heap report every HEAP_REPORT_INTERVAL, the queue sends it when no verify is waiting
+  if (heapMonitor.loop(micros(), millis())) {
+    REQUEST_JOB *job = queueJob(JOB_HEAP, 0);
+    if (job != NULL) {
+      FixedString<MAX_ARG> json;
+      if (heapMonitor.toJson(json)) {
+        strcpy(job->arg, json.c_str());
+      } else {
+        job->state = JOB_FREE;
+      }
+    }
+    heapMonitor.reset(millis());
+  }
+
   // execute tasks
   runner.execute();
 
@@ -475,6 +700,7 @@ void loop(void) {
   uptime(false);
 
   handleSerial();
+  runJobs();
   
 
   // TODO: